@@ -0,0 +1,535 @@
+#include "AabbTree.h"
+
+#include <algorithm>
+#include <cfloat>
+
+static float SurfaceArea(glm::vec3 lower, glm::vec3 upper)
+{
+	glm::vec3 size = upper - lower;
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+static bool Contains(const AabbTreeNode& node, glm::vec3 lower, glm::vec3 upper)
+{
+	return node.lower.x <= lower.x && node.lower.y <= lower.y && node.lower.z <= lower.z &&
+		upper.x <= node.upper.x && upper.y <= node.upper.y && upper.z <= node.upper.z;
+}
+
+AabbTree::AabbTree()
+{
+	root = AABB_TREE_NULL;
+	freeList = AABB_TREE_NULL;
+	nodeCount = 0;
+	proxyCount = 0;
+}
+
+int AabbTree::AllocateNode()
+{
+	if (freeList == AABB_TREE_NULL)
+	{
+		AabbTreeNode node = {};
+		node.parent = AABB_TREE_NULL;
+		node.height = -1;
+		nodes.push_back(node);
+		freeList = nodes.size() - 1;
+	}
+
+	int node = freeList;
+	freeList = nodes[node].parent;
+
+	nodes[node].parent = AABB_TREE_NULL;
+	nodes[node].child1 = AABB_TREE_NULL;
+	nodes[node].child2 = AABB_TREE_NULL;
+	nodes[node].height = 0;
+	nodes[node].userData = nullptr;
+	nodeCount++;
+
+	return node;
+}
+
+void AabbTree::FreeNode(int node)
+{
+	nodes[node].parent = freeList;
+	nodes[node].height = -1;
+	freeList = node;
+	nodeCount--;
+}
+
+int AabbTree::CreateProxy(const BoundingBox& box, void* userData)
+{
+	int proxy = AllocateNode();
+
+	glm::vec3 margin(AABB_TREE_MARGIN, AABB_TREE_MARGIN, AABB_TREE_MARGIN);
+	nodes[proxy].lower = box.center - box.extent - margin;
+	nodes[proxy].upper = box.center + box.extent + margin;
+	nodes[proxy].bounds = box;
+	nodes[proxy].userData = userData;
+
+	InsertLeaf(proxy);
+	proxyCount++;
+
+	return proxy;
+}
+
+void AabbTree::DestroyProxy(int proxy)
+{
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+	proxyCount--;
+}
+
+bool AabbTree::MoveProxy(int proxy, const BoundingBox& box)
+{
+	nodes[proxy].bounds = box;
+
+	glm::vec3 lower = box.center - box.extent;
+	glm::vec3 upper = box.center + box.extent;
+
+	if (Contains(nodes[proxy], lower, upper))
+	{
+		return false;
+	}
+
+	RemoveLeaf(proxy);
+
+	glm::vec3 margin(AABB_TREE_MARGIN, AABB_TREE_MARGIN, AABB_TREE_MARGIN);
+	nodes[proxy].lower = lower - margin;
+	nodes[proxy].upper = upper + margin;
+
+	InsertLeaf(proxy);
+	return true;
+}
+
+void AabbTree::UpdateNode(int node)
+{
+	const AabbTreeNode& child1 = nodes[nodes[node].child1];
+	const AabbTreeNode& child2 = nodes[nodes[node].child2];
+
+	nodes[node].lower = glm::min(child1.lower, child2.lower);
+	nodes[node].upper = glm::max(child1.upper, child2.upper);
+	nodes[node].height = 1 + std::max(child1.height, child2.height);
+}
+
+void AabbTree::InsertLeaf(int leaf)
+{
+	if (root == AABB_TREE_NULL)
+	{
+		root = leaf;
+		nodes[root].parent = AABB_TREE_NULL;
+		return;
+	}
+
+	glm::vec3 leafLower = nodes[leaf].lower;
+	glm::vec3 leafUpper = nodes[leaf].upper;
+
+	// Walk down to the sibling that grows the tree's total surface area the least
+	int index = root;
+	while (!nodes[index].IsLeaf())
+	{
+		const AabbTreeNode& node = nodes[index];
+
+		float area = SurfaceArea(node.lower, node.upper);
+		float combinedArea = SurfaceArea(glm::min(node.lower, leafLower), glm::max(node.upper, leafUpper));
+
+		// Cost of pairing with this node, and the minimum cost pushed down onto its children
+		float cost = 2.0f * combinedArea;
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		float childCosts[2];
+		int children[2] = { node.child1, node.child2 };
+		for (int i = 0; i < 2; i++)
+		{
+			const AabbTreeNode& child = nodes[children[i]];
+			float childArea = SurfaceArea(glm::min(child.lower, leafLower), glm::max(child.upper, leafUpper));
+
+			childCosts[i] = child.IsLeaf() ? childArea + inheritanceCost : childArea - SurfaceArea(child.lower, child.upper) + inheritanceCost;
+		}
+
+		if (cost < childCosts[0] && cost < childCosts[1])
+		{
+			break;
+		}
+
+		index = childCosts[0] < childCosts[1] ? children[0] : children[1];
+	}
+
+	int sibling = index;
+	int oldParent = nodes[sibling].parent;
+	int newParent = AllocateNode();
+
+	nodes[newParent].parent = oldParent;
+	nodes[newParent].child1 = sibling;
+	nodes[newParent].child2 = leaf;
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	if (oldParent == AABB_TREE_NULL)
+	{
+		root = newParent;
+	}
+	else if (nodes[oldParent].child1 == sibling)
+	{
+		nodes[oldParent].child1 = newParent;
+	}
+	else
+	{
+		nodes[oldParent].child2 = newParent;
+	}
+
+	RefitAncestors(newParent);
+}
+
+void AabbTree::RemoveLeaf(int leaf)
+{
+	if (leaf == root)
+	{
+		root = AABB_TREE_NULL;
+		return;
+	}
+
+	int parent = nodes[leaf].parent;
+	int grandParent = nodes[parent].parent;
+	int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+	FreeNode(parent);
+	nodes[sibling].parent = grandParent;
+
+	if (grandParent == AABB_TREE_NULL)
+	{
+		root = sibling;
+		return;
+	}
+
+	if (nodes[grandParent].child1 == parent)
+	{
+		nodes[grandParent].child1 = sibling;
+	}
+	else
+	{
+		nodes[grandParent].child2 = sibling;
+	}
+
+	RefitAncestors(grandParent);
+}
+
+// Refits and rebalances up towards the root, stopping once a node comes out unchanged
+void AabbTree::RefitAncestors(int index)
+{
+	while (index != AABB_TREE_NULL)
+	{
+		glm::vec3 lower = nodes[index].lower;
+		glm::vec3 upper = nodes[index].upper;
+		int height = nodes[index].height;
+
+		UpdateNode(index);
+		int balanced = Balance(index);
+
+		if (balanced == index && nodes[index].height == height && nodes[index].lower == lower && nodes[index].upper == upper)
+		{
+			break;
+		}
+
+		index = nodes[balanced].parent;
+	}
+}
+
+// Rotates the taller grandchild up when the children of a node differ in height by more than one.
+// Returns the node now at this position.
+int AabbTree::Balance(int a)
+{
+	if (nodes[a].IsLeaf() || nodes[a].height < 2)
+	{
+		return a;
+	}
+
+	int b = nodes[a].child1;
+	int c = nodes[a].child2;
+	int balance = nodes[c].height - nodes[b].height;
+
+	if (balance > 1 || balance < -1)
+	{
+		// up is the taller child, it replaces a and takes a as a child
+		bool rotateC = balance > 1;
+		int up = rotateC ? c : b;
+		int other = rotateC ? b : c;
+		int f = nodes[up].child1;
+		int g = nodes[up].child2;
+
+		nodes[up].child1 = a;
+		nodes[up].parent = nodes[a].parent;
+		nodes[a].parent = up;
+
+		if (nodes[up].parent == AABB_TREE_NULL)
+		{
+			root = up;
+		}
+		else if (nodes[nodes[up].parent].child1 == a)
+		{
+			nodes[nodes[up].parent].child1 = up;
+		}
+		else
+		{
+			nodes[nodes[up].parent].child2 = up;
+		}
+
+		// The taller grandchild stays with up, the shorter one moves under a
+		int keep = nodes[f].height > nodes[g].height ? f : g;
+		int move = keep == f ? g : f;
+
+		nodes[up].child2 = keep;
+		nodes[move].parent = a;
+		if (rotateC)
+		{
+			nodes[a].child1 = other;
+			nodes[a].child2 = move;
+		}
+		else
+		{
+			nodes[a].child1 = move;
+			nodes[a].child2 = other;
+		}
+
+		UpdateNode(a);
+		UpdateNode(up);
+
+		return up;
+	}
+
+	return a;
+}
+
+void AabbTree::Rebuild()
+{
+	if (root == AABB_TREE_NULL)
+	{
+		return;
+	}
+
+	std::vector<AabbTreeBuildEntry> leaves;
+	leaves.reserve(proxyCount);
+
+	for (size_t i = 0; i < nodes.size(); i++)
+	{
+		if (nodes[i].height < 0)
+		{
+			continue;
+		}
+
+		if (nodes[i].IsLeaf())
+		{
+			leaves.push_back({ (nodes[i].lower + nodes[i].upper) * 0.5f, (int)i });
+		}
+		else
+		{
+			FreeNode(i);
+		}
+	}
+
+	root = BuildRange(leaves.data(), leaves.size());
+	nodes[root].parent = AABB_TREE_NULL;
+}
+
+// Splits at the median of the leaf centres along the axis they spread furthest on.
+// The centres are copied out beforehand so partitioning doesn't chase nodes around memory
+int AabbTree::BuildRange(AabbTreeBuildEntry* leaves, int count)
+{
+	if (count == 1)
+	{
+		return leaves[0].leaf;
+	}
+
+	glm::vec3 lower = leaves[0].center;
+	glm::vec3 upper = leaves[0].center;
+	for (int i = 1; i < count; i++)
+	{
+		lower = glm::min(lower, leaves[i].center);
+		upper = glm::max(upper, leaves[i].center);
+	}
+
+	glm::vec3 size = upper - lower;
+	int axis = size.x > size.y ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2);
+
+	int half = count / 2;
+	std::nth_element(leaves, leaves + half, leaves + count, [axis](const AabbTreeBuildEntry& a, const AabbTreeBuildEntry& b) {
+		return a.center[axis] < b.center[axis];
+	});
+
+	int child1 = BuildRange(leaves, half);
+	int child2 = BuildRange(leaves + half, count - half);
+
+	int node = AllocateNode();
+	nodes[node].child1 = child1;
+	nodes[node].child2 = child2;
+	nodes[child1].parent = node;
+	nodes[child2].parent = node;
+	UpdateNode(node);
+
+	return node;
+}
+
+void AabbTree::CollectLeaves(int node, std::vector<void*>& results)
+{
+	size_t base = stack.size();
+	stack.push_back(node);
+
+	while (stack.size() > base)
+	{
+		int index = stack.back();
+		stack.pop_back();
+
+		if (nodes[index].IsLeaf())
+		{
+			results.push_back(nodes[index].userData);
+		}
+		else
+		{
+			stack.push_back(nodes[index].child1);
+			stack.push_back(nodes[index].child2);
+		}
+	}
+}
+
+bool AabbTree::GetBounds(BoundingBox& box)
+{
+	if (root == AABB_TREE_NULL)
+	{
+		return false;
+	}
+
+	box.center = (nodes[root].lower + nodes[root].upper) * 0.5f;
+	box.extent = (nodes[root].upper - nodes[root].lower) * 0.5f;
+	return true;
+}
+
+void AabbTree::QueryVolume(const CullVolume& volume, std::vector<void*>& results)
+{
+	if (root == AABB_TREE_NULL)
+	{
+		return;
+	}
+
+	candidates.clear();
+	stack.clear();
+	stack.push_back(root);
+
+	// Inner nodes are classified one at a time. Leaves reached through a partly visible node are
+	// gathered and tested together against their exact boxes with the SIMD kernel
+	while (!stack.empty())
+	{
+		int index = stack.back();
+		stack.pop_back();
+
+		const AabbTreeNode& node = nodes[index];
+
+		if (node.IsLeaf())
+		{
+			candidates.push_back(index);
+			continue;
+		}
+
+		BoundingBox box;
+		box.center = (node.lower + node.upper) * 0.5f;
+		box.extent = (node.upper - node.lower) * 0.5f;
+
+		CullResult result = ClassifyBox(volume, box);
+
+		if (result == CULL_INSIDE)
+		{
+			CollectLeaves(index, results);
+		}
+		else if (result == CULL_INTERSECTS)
+		{
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+
+	for (int i = 0; i < 6; i++)
+	{
+		candidateBoxes[i].resize(candidates.size());
+	}
+	candidateVisible.resize(candidates.size());
+
+	for (size_t i = 0; i < candidates.size(); i++)
+	{
+		const BoundingBox& bounds = nodes[candidates[i]].bounds;
+		candidateBoxes[0][i] = bounds.center.x;
+		candidateBoxes[1][i] = bounds.center.y;
+		candidateBoxes[2][i] = bounds.center.z;
+		candidateBoxes[3][i] = bounds.extent.x;
+		candidateBoxes[4][i] = bounds.extent.y;
+		candidateBoxes[5][i] = bounds.extent.z;
+	}
+
+	BoxArrays boxes = { candidateBoxes[0].data(), candidateBoxes[1].data(), candidateBoxes[2].data(),
+		candidateBoxes[3].data(), candidateBoxes[4].data(), candidateBoxes[5].data() };
+	CullBoxes(volume, boxes, candidates.size(), candidateVisible.data());
+
+	for (size_t i = 0; i < candidates.size(); i++)
+	{
+		if (candidateVisible[i])
+		{
+			results.push_back(nodes[candidates[i]].userData);
+		}
+	}
+}
+
+// Distance along the ray to where it enters the box, or FLT_MAX if it misses (slab test)
+static float RayBoxDistance(glm::vec3 origin, glm::vec3 inverseDirection, glm::vec3 lower, glm::vec3 upper)
+{
+	glm::vec3 t1 = (lower - origin) * inverseDirection;
+	glm::vec3 t2 = (upper - origin) * inverseDirection;
+
+	glm::vec3 tNear = glm::min(t1, t2);
+	glm::vec3 tFar = glm::max(t1, t2);
+
+	float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+	float exit = std::min(std::min(tFar.x, tFar.y), tFar.z);
+
+	return enter <= exit ? enter : FLT_MAX;
+}
+
+void* AabbTree::RayCast(glm::vec3 origin, glm::vec3 direction, float& distance)
+{
+	void* hit = nullptr;
+	distance = FLT_MAX;
+
+	if (root == AABB_TREE_NULL)
+	{
+		return hit;
+	}
+
+	glm::vec3 inverseDirection = 1.0f / direction;
+
+	stack.clear();
+	stack.push_back(root);
+
+	while (!stack.empty())
+	{
+		int index = stack.back();
+		stack.pop_back();
+
+		const AabbTreeNode& node = nodes[index];
+
+		if (node.IsLeaf())
+		{
+			float leafDistance = RayBoxDistance(origin, inverseDirection, node.bounds.center - node.bounds.extent, node.bounds.center + node.bounds.extent);
+			if (leafDistance < distance)
+			{
+				distance = leafDistance;
+				hit = node.userData;
+			}
+		}
+		else if (RayBoxDistance(origin, inverseDirection, node.lower, node.upper) < distance)
+		{
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+
+	return hit;
+}
+
+AabbTree::~AabbTree()
+{
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vector>
+
+#include <glm\glm.hpp>
+
+#include "Geometry.h"
+#include "Culling.h"
+
+#define AABB_TREE_NULL -1
+
+// Leaves are stored this much larger than their object, so small moves don't touch the tree
+const float AABB_TREE_MARGIN = 0.1f;
+
+struct AabbTreeNode
+{
+	// Fattened bounds, tight enough for traversal
+	glm::vec3 lower;
+	glm::vec3 upper;
+
+	// Leaves only: the exact box, and what it belongs to
+	BoundingBox bounds;
+	void* userData;
+
+	int parent;	// next free node while on the free list
+	int child1;
+	int child2;
+	int height;	// 0 for leaves, -1 when free
+
+	bool IsLeaf() const { return child1 == AABB_TREE_NULL; }
+};
+
+struct AabbTreeBuildEntry
+{
+	glm::vec3 center;
+	int leaf;
+};
+
+// Dynamic bounding volume hierarchy over world boxes (after Box2D's b2DynamicTree).
+// Leaves are inserted by surface area cost and the tree is kept balanced with rotations.
+// Proxies are leaf node indices and stay valid until destroyed, including across Rebuild().
+class AabbTree
+{
+public:
+	AabbTree();
+
+	int CreateProxy(const BoundingBox& box, void* userData);
+	void DestroyProxy(int proxy);
+
+	// Reinserts the leaf only when the box has left its fattened bounds. Returns true if it did
+	bool MoveProxy(int proxy, const BoundingBox& box);
+
+	// Rebuilds the internal nodes top-down, best after adding many proxies at once
+	void Rebuild();
+
+	// Appends the user data of every leaf whose box touches the volume
+	void QueryVolume(const CullVolume& volume, std::vector<void*>& results);
+
+	// User data of the nearest leaf box hit along the ray, or nullptr. distance is along direction
+	void* RayCast(glm::vec3 origin, glm::vec3 direction, float& distance);
+
+	int GetProxyCount() { return proxyCount; }
+	int GetNodeCount() { return nodeCount; }
+	int GetHeight() { return root == AABB_TREE_NULL ? 0 : nodes[root].height; }
+
+	// Fattened box around every leaf, false when the tree is empty
+	bool GetBounds(BoundingBox& box);
+
+	~AabbTree();
+
+private:
+	std::vector<AabbTreeNode> nodes;
+	int root;
+	int freeList;
+	int nodeCount;
+	int proxyCount;
+
+	// Scratch kept between queries to avoid reallocating
+	std::vector<int> stack;
+	std::vector<int> candidates;
+	std::vector<float> candidateBoxes[6];
+	std::vector<unsigned char> candidateVisible;
+
+	int AllocateNode();
+	void FreeNode(int node);
+
+	void InsertLeaf(int leaf);
+	void RemoveLeaf(int leaf);
+	int Balance(int node);
+	void RefitAncestors(int node);
+	void UpdateNode(int node);
+	int BuildRange(AabbTreeBuildEntry* leaves, int count);
+
+	void CollectLeaves(int node, std::vector<void*>& results);
+};
@@ -0,0 +1,93 @@
+#include "AssetRegistry.h"
+
+#include "Model.h"
+#include "Texture.h"
+
+std::map<std::string, std::weak_ptr<Model>> AssetRegistry::models;
+std::map<std::string, std::weak_ptr<Texture>> AssetRegistry::textures;
+
+std::string AssetRegistry::MakeKey(const std::string& fileName)
+{
+	// "Models/a.obj", "Models\a.obj" and "Models/../Models/a.obj" are the same asset
+	return std::filesystem::path(fileName).lexically_normal().generic_string();
+}
+
+std::shared_ptr<Model> AssetRegistry::GetModel(const std::string& fileName)
+{
+	std::string key = MakeKey(fileName);
+
+	std::shared_ptr<Model> model = models[key].lock();
+	if (model)
+	{
+		return model;
+	}
+
+	model = std::make_shared<Model>();
+	if (!model->LoadModel(fileName))
+	{
+		models.erase(key);
+		return nullptr;
+	}
+
+	models[key] = model;
+	return model;
+}
+
+std::shared_ptr<Texture> AssetRegistry::GetTexture(const std::string& fileName, bool hasAlpha)
+{
+	std::string key = MakeKey(fileName) + (hasAlpha ? "#rgba" : "#rgb");
+
+	std::shared_ptr<Texture> texture = textures[key].lock();
+	if (texture)
+	{
+		return texture;
+	}
+
+	texture = std::make_shared<Texture>(fileName.c_str());
+	if (!(hasAlpha ? texture->LoadTextureA() : texture->LoadTexture()))
+	{
+		textures.erase(key);
+		return nullptr;
+	}
+
+	textures[key] = texture;
+	return texture;
+}
+
+size_t AssetRegistry::GetModelCount()
+{
+	size_t count = 0;
+	for (auto it = models.begin(); it != models.end();)
+	{
+		if (it->second.expired())
+		{
+			it = models.erase(it);
+		}
+		else
+		{
+			count++;
+			it++;
+		}
+	}
+
+	return count;
+}
+
+size_t AssetRegistry::GetTextureCount()
+{
+	size_t count = 0;
+	for (auto it = textures.begin(); it != textures.end();)
+	{
+		if (it->second.expired())
+		{
+			it = textures.erase(it);
+		}
+		else
+		{
+			count++;
+			it++;
+		}
+	}
+
+	return count;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdio.h>
+#include <string>
+#include <map>
+#include <memory>
+#include <filesystem>
+
+class Model;
+class Texture;
+
+// Hands out shared handles to models and textures so each file is loaded, and uploaded to the GPU, once.
+// The registry only holds weak references: an asset is freed as soon as its last handle is released.
+class AssetRegistry
+{
+public:
+	static std::shared_ptr<Model> GetModel(const std::string& fileName);
+	static std::shared_ptr<Texture> GetTexture(const std::string& fileName, bool hasAlpha);
+
+	static size_t GetModelCount();
+	static size_t GetTextureCount();
+
+private:
+	static std::string MakeKey(const std::string& fileName);
+
+	static std::map<std::string, std::weak_ptr<Model>> models;
+	static std::map<std::string, std::weak_ptr<Texture>> textures;
+};
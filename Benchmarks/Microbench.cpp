@@ -0,0 +1,301 @@
+// Times the CPU kernels on the load and render paths over synthetic meshes, without a GL context.
+// Usage: Microbench [--max-triangles N] [--min-time seconds]
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+
+#include <glm\glm.hpp>
+#include <glm\gtc\matrix_transform.hpp>
+
+#include <assimp\scene.h>
+
+#include "Geometry.h"
+#include "Culling.h"
+#include "AabbTree.h"
+#include "RadixSort.h"
+#include "PointLight.h"
+
+static double minTime = 0.25;
+
+// Defeats dead-code elimination of kernel results
+static volatile float sink = 0.0f;
+
+struct GridMesh
+{
+	std::vector<GLfloat> vertices;		// 8 floats per vertex, normals zeroed
+	std::vector<unsigned int> indices;
+	unsigned int vertexCount;
+};
+
+// A (cells x cells) grid of quads with a gentle height field, two triangles per cell
+static GridMesh CreateGrid(unsigned int cells)
+{
+	GridMesh grid;
+	unsigned int side = cells + 1;
+	grid.vertexCount = side * side;
+	grid.vertices.resize((size_t)grid.vertexCount * 8, 0.0f);
+	grid.indices.reserve((size_t)cells * cells * 6);
+
+	for (unsigned int z = 0; z < side; z++)
+	{
+		for (unsigned int x = 0; x < side; x++)
+		{
+			GLfloat* vertex = &grid.vertices[((size_t)z * side + x) * 8];
+			vertex[0] = (GLfloat)x;
+			vertex[1] = sinf(x * 0.1f) * cosf(z * 0.1f);
+			vertex[2] = (GLfloat)z;
+			vertex[3] = (GLfloat)x / cells;
+			vertex[4] = (GLfloat)z / cells;
+		}
+	}
+
+	for (unsigned int z = 0; z < cells; z++)
+	{
+		for (unsigned int x = 0; x < cells; x++)
+		{
+			unsigned int corner = z * side + x;
+			grid.indices.insert(grid.indices.end(), { corner, corner + side, corner + 1, corner + 1, corner + side, corner + side + 1 });
+		}
+	}
+
+	return grid;
+}
+
+// Runs the kernel until minTime has passed (at least 3 times) and returns the median seconds per run
+template <typename Kernel>
+static double TimeKernel(Kernel kernel)
+{
+	std::vector<double> runs;
+	double total = 0.0;
+
+	while (runs.size() < 3 || total < minTime)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		kernel();
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		runs.push_back(seconds);
+		total += seconds;
+	}
+
+	std::sort(runs.begin(), runs.end());
+	return runs[runs.size() / 2];
+}
+
+static void Report(const char* kernel, unsigned long long items, const char* itemName, double bytes, double seconds)
+{
+	printf("%-26s %12llu %-10s %12.3f ms %14.2f M%s/s %10.2f GB/s\n", kernel, items, itemName, seconds * 1000.0,
+		items / seconds / 1e6, itemName, bytes / seconds / 1e9);
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned long long maxTriangles = 50000000ULL;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--max-triangles") == 0 && i + 1 < argc)
+		{
+			maxTriangles = strtoull(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+		{
+			minTime = atof(argv[++i]);
+		}
+		else
+		{
+			printf("Usage: %s [--max-triangles N] [--min-time seconds]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	const unsigned long long triangleCounts[] = { 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 50000000ULL };
+
+	for (unsigned long long targetTriangles : triangleCounts)
+	{
+		if (targetTriangles > maxTriangles)
+		{
+			break;
+		}
+
+		unsigned int cells = (unsigned int)ceil(sqrt(targetTriangles / 2.0));
+		GridMesh grid = CreateGrid(cells);
+		unsigned long long triangles = grid.indices.size() / 3;
+
+		printf("--- %llu triangles, %u vertices ---\n", triangles, grid.vertexCount);
+
+		// calcAverageNormals reads the indices and three positions per triangle, then updates every normal
+		double seconds = TimeKernel([&]() {
+			calcAverageNormals(grid.indices.data(), grid.indices.size(), grid.vertices.data(), grid.vertices.size(), 8, 5);
+		});
+		sink = sink + grid.vertices[5];
+		Report("calcAverageNormals", triangles, "tris",
+			grid.indices.size() * sizeof(unsigned int) + grid.vertices.size() * sizeof(GLfloat), seconds);
+
+		// The interleaving loop from Model::LoadMesh, fed from an aiMesh like assimp produces
+		{
+			aiMesh mesh;
+			mesh.mNumVertices = grid.vertexCount;
+			mesh.mVertices = new aiVector3D[grid.vertexCount];
+			mesh.mNormals = new aiVector3D[grid.vertexCount];
+			mesh.mTextureCoords[0] = new aiVector3D[grid.vertexCount];
+			for (size_t i = 0; i < grid.vertexCount; i++)
+			{
+				const GLfloat* vertex = &grid.vertices[i * 8];
+				mesh.mVertices[i] = aiVector3D(vertex[0], vertex[1], vertex[2]);
+				mesh.mTextureCoords[0][i] = aiVector3D(vertex[3], vertex[4], 0.0f);
+				mesh.mNormals[i] = aiVector3D(vertex[5], vertex[6], vertex[7]);
+			}
+
+			std::vector<GLfloat> vertices;
+			seconds = TimeKernel([&]() {
+				vertices.clear();
+				vertices.shrink_to_fit();
+				InterleaveVertices(&mesh, vertices);
+			});
+			sink = sink + vertices.back();
+			Report("InterleaveVertices", triangles, "tris",
+				grid.vertexCount * (3.0 * sizeof(aiVector3D) + 8.0 * sizeof(GLfloat)), seconds);
+		}
+
+		// Per-object model matrices, one object per triangle so the counts line up with the mesh sizes
+		{
+			size_t objectCount = (size_t)std::min(triangles, 1000000ULL);
+			std::vector<glm::mat4> matrices(objectCount);
+
+			seconds = TimeKernel([&]() {
+				for (size_t i = 0; i < objectCount; i++)
+				{
+					const GLfloat* vertex = &grid.vertices[(i % grid.vertexCount) * 8];
+					matrices[i] = ComposeModelMatrix(glm::vec3(vertex[0], vertex[1], vertex[2]),
+						glm::vec3(vertex[3] * 360.0f, vertex[4] * 360.0f, 0.0f), glm::vec3(1.0f, 1.0f, 1.0f));
+				}
+			});
+			sink = sink + matrices.back()[3][0];
+			Report("ComposeModelMatrix", objectCount, "objs", objectCount * (9.0 * sizeof(GLfloat) + sizeof(glm::mat4)), seconds);
+
+			// Their normal matrices, through the uniform scale shortcut and through the general inverse
+			std::vector<glm::mat3> normalMatrices(objectCount);
+			const glm::vec3 scales[] = { glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(1.0f, 2.0f, 3.0f) };
+			const char* normalKernels[] = { "NormalMatrix uniform", "NormalMatrix general" };
+			for (int kernel = 0; kernel < 2; kernel++)
+			{
+				seconds = TimeKernel([&]() {
+					for (size_t i = 0; i < objectCount; i++)
+					{
+						normalMatrices[i] = ComposeNormalMatrix(matrices[i], scales[kernel]);
+					}
+				});
+				sink = sink + normalMatrices.back()[0][0];
+				Report(normalKernels[kernel], objectCount, "objs", objectCount * (double)(sizeof(glm::mat4) + sizeof(glm::mat3)), seconds);
+			}
+
+			// Unit boxes at the same placements against a camera looking across the grid
+			std::vector<float> components[6];
+			for (size_t i = 0; i < objectCount; i++)
+			{
+				const GLfloat* vertex = &grid.vertices[(i % grid.vertexCount) * 8];
+				components[0].push_back(vertex[0]);
+				components[1].push_back(vertex[1]);
+				components[2].push_back(vertex[2]);
+				for (int j = 3; j < 6; j++)
+				{
+					components[j].push_back(0.5f);
+				}
+			}
+
+			BoxArrays boxes = { components[0].data(), components[1].data(), components[2].data(),
+				components[3].data(), components[4].data(), components[5].data() };
+			CullVolume frustum = CreateFrustumVolume(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f) *
+				glm::lookAt(glm::vec3(0.0f, 5.0f, 0.0f), glm::vec3(cells * 0.5f, 0.0f, cells * 0.5f), glm::vec3(0.0f, 1.0f, 0.0f)));
+			std::vector<unsigned char> visible(objectCount);
+			size_t visibleCount = 0;
+
+			seconds = TimeKernel([&]() {
+				visibleCount = CullBoxes(frustum, boxes, objectCount, visible.data());
+			});
+			sink = sink + (float)visibleCount;
+			Report("CullBoxes", objectCount, "objs", objectCount * (6.0 * sizeof(float) + 1.0), seconds);
+
+			// The same boxes in a scene tree: a full rebuild, moving one object in a hundred, then the frustum query
+			AabbTree tree;
+			std::vector<BoundingBox> bounds(objectCount);
+			std::vector<int> proxies(objectCount);
+			for (size_t i = 0; i < objectCount; i++)
+			{
+				bounds[i].center = glm::vec3(components[0][i], components[1][i], components[2][i]);
+				bounds[i].extent = glm::vec3(0.5f, 0.5f, 0.5f);
+				proxies[i] = tree.CreateProxy(bounds[i], &bounds[i]);
+			}
+
+			seconds = TimeKernel([&]() {
+				tree.Rebuild();
+			});
+			Report("AabbTree::Rebuild", objectCount, "objs", (double)tree.GetNodeCount() * sizeof(AabbTreeNode), seconds);
+
+			size_t movedCount = (objectCount + 99) / 100;
+			float offset = 0.0f;
+			seconds = TimeKernel([&]() {
+				// Alternate directions so the objects stay put over many runs, each move leaves the fattened bounds
+				offset = offset > 0.0f ? -1.0f : 1.0f;
+				for (size_t i = 0; i < objectCount; i += 100)
+				{
+					bounds[i].center.x += offset;
+					tree.MoveProxy(proxies[i], bounds[i]);
+				}
+			});
+			Report("AabbTree::MoveProxy", movedCount, "objs", movedCount * (double)tree.GetHeight() * sizeof(AabbTreeNode), seconds);
+
+			std::vector<void*> results;
+			seconds = TimeKernel([&]() {
+				results.clear();
+				tree.QueryVolume(frustum, results);
+			});
+			sink = sink + (float)results.size();
+			Report("AabbTree::QueryVolume", objectCount, "objs", results.size() * sizeof(AabbTreeNode), seconds);
+
+			// Render queue keys for the same objects: a few programs and textures, one vertex array per 16 objects
+			std::vector<uint64_t> keys(objectCount), keyScratch(objectCount), shuffledKeys(objectCount);
+			std::vector<uint32_t> order(objectCount), orderScratch(objectCount);
+			for (size_t i = 0; i < objectCount; i++)
+			{
+				uint64_t hash = (i * 2654435761ULL) % objectCount;
+				shuffledKeys[i] = ((hash & 1) << 60) | ((hash % 64) << 40) | ((hash / 16) << 16);
+			}
+
+			seconds = TimeKernel([&]() {
+				keys = shuffledKeys;
+				for (size_t i = 0; i < objectCount; i++)
+				{
+					order[i] = i;
+				}
+				RadixSort64(keys.data(), order.data(), keyScratch.data(), orderScratch.data(), objectCount);
+			});
+			sink = sink + (float)order[0];
+			Report("RadixSort64", objectCount, "keys", objectCount * 4.0 * (sizeof(uint64_t) + sizeof(uint32_t)), seconds);
+		}
+	}
+
+	// Cube-face matrices per omni light, independent of mesh size. The default light owns no shadow map, so no GL is needed.
+	{
+		const size_t lightCount = 100000;
+		std::vector<PointLight> lights(16);
+		std::vector<glm::mat4> lightMatrices;
+
+		double seconds = TimeKernel([&]() {
+			for (size_t i = 0; i < lightCount; i++)
+			{
+				lightMatrices = lights[i % lights.size()].CalculateLightTransform();
+			}
+		});
+		sink = sink + lightMatrices[0][0][0];
+		Report("CalculateLightTransform", lightCount, "lights", lightCount * 6.0 * sizeof(glm::mat4), seconds);
+	}
+
+	return 0;
+}
@@ -0,0 +1,20 @@
+@echo off
+rem Replays Benchmarks\orbit.path over the cube scene for every object/light combination.
+rem Run from the project directory: Benchmarks\run_scaling.bat <path to Cadminimum.exe> [frames]
+setlocal
+
+set EXE=%~1
+if "%EXE%"=="" set EXE=x64\Release\Cadminimum.exe
+set FRAMES=%~2
+if "%FRAMES%"=="" set FRAMES=600
+
+if not exist Benchmarks\results mkdir Benchmarks\results
+
+for %%O in (1 100 10000) do (
+	for %%L in (0 1 2 3 4) do (
+		echo === %%O objects, %%L lights ===
+		"%EXE%" --frames %FRAMES% --scene Benchmarks\cube.scene --path Benchmarks\orbit.path --objects %%O --lights %%L --report Benchmarks\results\objects%%O_lights%%L.csv
+	)
+)
+
+endlocal
@@ -1,46 +1,50 @@
-#pragma once
-
-#include <GL\glew.h>
-
-#include <glm\glm.hpp>
-#include <glm\gtc\matrix_transform.hpp>
-
-#include <GLFW\glfw3.h>
-
-class Camera
-{
-public:
-	Camera();
-	Camera(glm::vec3 startPosition, glm::vec3 startUp, GLfloat startYaw, GLfloat startPitch, GLfloat startMoveSpeed, GLfloat startTurnSpeed);
-
-	void keyControl(bool* keys, GLfloat deltaTime);
-	void mouseControl(GLfloat xChange, GLfloat yChange);
-
-	glm::vec3 getCameraPosition();
-	glm::vec3 getCameraDirection();
-
-	glm::mat4 calculateViewMatrix();
-
-	GLfloat getMoveSpeed() { return moveSpeed; }
-	void setMoveSpeed(GLfloat speed) { moveSpeed = speed; }
-	GLfloat getTurnSpeed() { return turnSpeed; }
-	void setTurnSpeed(GLfloat speed) { turnSpeed = speed; }
-
-	~Camera();
-
-private:
-	glm::vec3 position;
-	glm::vec3 front;
-	glm::vec3 up;
-	glm::vec3 right;
-	glm::vec3 worldUp;
-
-	GLfloat yaw;
-	GLfloat pitch;
-
-	GLfloat moveSpeed;
-	GLfloat turnSpeed;
-
-	void update();
-};
-
+#pragma once
+
+#include <GL\glew.h>
+
+#include <glm\glm.hpp>
+#include <glm\gtc\matrix_transform.hpp>
+
+#include <GLFW\glfw3.h>
+
+class Camera
+{
+public:
+	Camera();
+	Camera(glm::vec3 startPosition, glm::vec3 startUp, GLfloat startYaw, GLfloat startPitch, GLfloat startMoveSpeed, GLfloat startTurnSpeed);
+
+	void keyControl(bool* keys, GLfloat deltaTime);
+	void mouseControl(GLfloat xChange, GLfloat yChange);
+
+	glm::vec3 getCameraPosition();
+	glm::vec3 getCameraDirection();
+
+	glm::mat4 calculateViewMatrix();
+
+	GLfloat getYaw() { return yaw; }
+	GLfloat getPitch() { return pitch; }
+	void setPose(glm::vec3 newPosition, GLfloat newYaw, GLfloat newPitch);
+
+	GLfloat getMoveSpeed() { return moveSpeed; }
+	void setMoveSpeed(GLfloat speed) { moveSpeed = speed; }
+	GLfloat getTurnSpeed() { return turnSpeed; }
+	void setTurnSpeed(GLfloat speed) { turnSpeed = speed; }
+
+	~Camera();
+
+private:
+	glm::vec3 position;
+	glm::vec3 front;
+	glm::vec3 up;
+	glm::vec3 right;
+	glm::vec3 worldUp;
+
+	GLfloat yaw;
+	GLfloat pitch;
+
+	GLfloat moveSpeed;
+	GLfloat turnSpeed;
+
+	void update();
+};
+
@@ -0,0 +1,127 @@
+#include "CameraPath.h"
+
+CameraPath::CameraPath()
+{
+	fileLocation = "";
+}
+
+CameraPath::CameraPath(const char* fileLoc)
+{
+	fileLocation = fileLoc;
+}
+
+bool CameraPath::LoadPath()
+{
+	std::ifstream fileStream(fileLocation, std::ios::in);
+
+	if (!fileStream.is_open())
+	{
+		printf("Failed to read %s! File doesn't exist.\n", fileLocation);
+		return false;
+	}
+
+	keyframes.clear();
+
+	std::string line = "";
+	while (std::getline(fileStream, line))
+	{
+		std::istringstream tokens(line);
+		Keyframe keyframe;
+
+		if (line.empty() || line[0] == '#')
+		{
+			continue;
+		}
+
+		if (tokens >> keyframe.time >> keyframe.position.x >> keyframe.position.y >> keyframe.position.z >> keyframe.yaw >> keyframe.pitch)
+		{
+			keyframes.push_back(keyframe);
+		}
+	}
+
+	fileStream.close();
+
+	if (keyframes.empty())
+	{
+		printf("Camera path %s has no keyframes\n", fileLocation);
+		return false;
+	}
+
+	return true;
+}
+
+bool CameraPath::SavePath()
+{
+	std::ofstream fileStream(fileLocation, std::ios::out);
+
+	if (!fileStream.is_open())
+	{
+		printf("Failed to write %s!\n", fileLocation);
+		return false;
+	}
+
+	fileStream << "# time x y z yaw pitch\n";
+	for (size_t i = 0; i < keyframes.size(); i++)
+	{
+		fileStream << keyframes[i].time << " " << keyframes[i].position.x << " " << keyframes[i].position.y << " " << keyframes[i].position.z
+			<< " " << keyframes[i].yaw << " " << keyframes[i].pitch << "\n";
+	}
+
+	fileStream.close();
+	return true;
+}
+
+void CameraPath::AddKeyframe(GLfloat time, glm::vec3 position, GLfloat yaw, GLfloat pitch)
+{
+	Keyframe keyframe;
+	keyframe.time = time;
+	keyframe.position = position;
+	keyframe.yaw = yaw;
+	keyframe.pitch = pitch;
+
+	keyframes.push_back(keyframe);
+}
+
+GLfloat CameraPath::GetDuration()
+{
+	return keyframes.empty() ? 0.0f : keyframes.back().time;
+}
+
+void CameraPath::ApplyToCamera(GLfloat time, Camera* camera)
+{
+	if (keyframes.empty())
+	{
+		return;
+	}
+
+	GLfloat duration = GetDuration();
+	if (duration > 0.0f)
+	{
+		time = fmodf(time, duration);
+	}
+
+	size_t next = 0;
+	while (next < keyframes.size() && keyframes[next].time <= time)
+	{
+		next++;
+	}
+
+	if (next == 0 || next == keyframes.size())
+	{
+		Keyframe& keyframe = next == 0 ? keyframes.front() : keyframes.back();
+		camera->setPose(keyframe.position, keyframe.yaw, keyframe.pitch);
+		return;
+	}
+
+	Keyframe& from = keyframes[next - 1];
+	Keyframe& to = keyframes[next];
+	GLfloat blend = (time - from.time) / (to.time - from.time);
+
+	camera->setPose(from.position + (to.position - from.position) * blend,
+		from.yaw + (to.yaw - from.yaw) * blend,
+		from.pitch + (to.pitch - from.pitch) * blend);
+}
+
+CameraPath::~CameraPath()
+{
+}
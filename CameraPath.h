@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdio.h>
+#include <vector>
+#include <fstream>
+#include <sstream>
+
+#include <glm\glm.hpp>
+
+#include "Camera.h"
+
+// A camera fly-through made of position/yaw/pitch keyframes, stored one per line as
+//   <time> <x> <y> <z> <yaw> <pitch>
+class CameraPath
+{
+public:
+	CameraPath();
+	CameraPath(const char* fileLoc);
+
+	bool LoadPath();
+	bool SavePath();
+
+	void AddKeyframe(GLfloat time, glm::vec3 position, GLfloat yaw, GLfloat pitch);
+	void ClearPath() { keyframes.clear(); }
+
+	// Places the camera at the given time, looping past the last keyframe
+	void ApplyToCamera(GLfloat time, Camera* camera);
+
+	GLfloat GetDuration();
+	size_t GetKeyframeCount() { return keyframes.size(); }
+
+	~CameraPath();
+
+private:
+	struct Keyframe
+	{
+		GLfloat time;
+		glm::vec3 position;
+		GLfloat yaw, pitch;
+	};
+
+	std::vector<Keyframe> keyframes;
+
+	const char* fileLocation;
+};
@@ -0,0 +1,79 @@
+#include "CascadedShadowMap.h"
+
+CascadedShadowMap::CascadedShadowMap() : ShadowMap()
+{
+	cascade = 0;
+}
+
+bool CascadedShadowMap::CreateMap(GLuint& framebuffer, GLuint& texture)
+{
+	glGenFramebuffers(1, &framebuffer);
+
+	// Every cascade is allocated up front, so changing the count costs no memory
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT, shadowWidth, shadowHeight, MAX_SHADOW_CASCADES, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+	glTexParameterf(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameterf(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+	float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+	// Read through sampler2DArrayShadow, lookups compare and filter in hardware
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+	glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0, 0);
+
+	glDrawBuffer(GL_NONE);
+	glReadBuffer(GL_NONE);
+
+	GLenum Status = glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER);
+
+	if (Status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		printf("Framebuffer error: %i\n", Status);
+		return false;
+	}
+
+	return true;
+}
+
+void CascadedShadowMap::Write()
+{
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
+	glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, shadowMap, 0, cascade);
+}
+
+void CascadedShadowMap::WriteStaticLayer()
+{
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, staticFBO);
+	glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, staticMap, 0, cascade);
+}
+
+void CascadedShadowMap::CopyStaticLayer()
+{
+	if (GLEW_VERSION_4_3)
+	{
+		glCopyImageSubData(staticMap, GL_TEXTURE_2D_ARRAY, 0, 0, 0, cascade, shadowMap, GL_TEXTURE_2D_ARRAY, 0, 0, 0, cascade, shadowWidth, shadowHeight, 1);
+		return;
+	}
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, staticFBO);
+	glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, staticMap, 0, cascade);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
+	glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, shadowMap, 0, cascade);
+	glBlitFramebuffer(0, 0, shadowWidth, shadowHeight, 0, 0, shadowWidth, shadowHeight, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+
+void CascadedShadowMap::Read(GLenum texUnit)
+{
+	glActiveTexture(texUnit);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, shadowMap);
+}
+
+CascadedShadowMap::~CascadedShadowMap()
+{
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "ShadowMap.h"
+#include "CommonValues.h"
+
+// One layer of a depth texture array per cascade of the directional light.
+// Write, WriteStaticLayer and CopyStaticLayer work on the layer picked by SetCascade
+class CascadedShadowMap :
+	public ShadowMap
+{
+public:
+	CascadedShadowMap();
+
+	void SetCascade(unsigned int cascade_) { cascade = cascade_; }
+
+	void Write();
+
+	void Read(GLenum TextureUnit);
+
+	void WriteStaticLayer();
+	void CopyStaticLayer();
+
+	~CascadedShadowMap();
+
+protected:
+	bool CreateMap(GLuint& framebuffer, GLuint& texture);
+
+private:
+	unsigned int cascade;
+};
@@ -1,9 +1,20 @@
-#ifndef COMMONVALS
-#define COMMONVALS
-
-#include "stb_image.h"
-
-const int MAX_POINT_LIGHTS = 2;
-const int MAX_SPOT_LIGHTS = 2;
-
+#ifndef COMMONVALS
+#define COMMONVALS
+
+#include "stb_image.h"
+
+// Every shader is compiled with the constants below as #defines, see Shader::AddDefine
+
+// Lights with a shadow slot, any number more are lit through the light clusters without shadows
+const int MAX_POINT_LIGHTS = 2;
+const int MAX_SPOT_LIGHTS = 2;
+const int MAX_SHADOW_CASCADES = 4;
+
+// Exponents of the moment shadow maps' warp, whole numbers so the shaders' copies format the same in any locale.
+// Half floats overflow once the squared positive moment passes exp(2 * 5.54)
+const int EVSM_POSITIVE_EXPONENT = 5;
+const int EVSM_NEGATIVE_EXPONENT = 5;
+// Mips of the moments, past this they would no longer stay inside the smallest atlas tiles
+const int MOMENTS_MAX_LEVEL = 4;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "CpuProfiler.h"
+
+#include <fstream>
+
+std::mutex CpuProfiler::buffersMutex;
+std::vector<CpuProfiler::ThreadBuffer*> CpuProfiler::buffers;
+
+CpuProfiler::ThreadBuffer* CpuProfiler::GetThreadBuffer()
+{
+	// Buffers outlive their thread so the trace can still be written after it exits
+	thread_local ThreadBuffer* buffer = nullptr;
+
+	if (!buffer)
+	{
+		buffer = new ThreadBuffer();
+		buffer->head = 0;
+		buffer->count = 0;
+		buffer->depth = 0;
+
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		buffer->threadID = buffers.size() + 1;
+		buffers.push_back(buffer);
+	}
+
+	return buffer;
+}
+
+unsigned long long CpuProfiler::Now()
+{
+	static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void CpuProfiler::BeginZone(const char* name)
+{
+	ThreadBuffer* buffer = GetThreadBuffer();
+
+	if (buffer->depth < CPU_PROFILER_MAX_DEPTH)
+	{
+		ProfileEvent& zone = buffer->openZones[buffer->depth];
+		zone.name = name;
+		zone.depth = buffer->depth;
+		zone.start = Now();
+	}
+
+	buffer->depth++;
+}
+
+void CpuProfiler::EndZone()
+{
+	ThreadBuffer* buffer = GetThreadBuffer();
+
+	if (buffer->depth == 0)
+	{
+		return;
+	}
+
+	buffer->depth--;
+
+	if (buffer->depth < CPU_PROFILER_MAX_DEPTH)
+	{
+		ProfileEvent& zone = buffer->openZones[buffer->depth];
+		zone.end = Now();
+
+		buffer->events[buffer->head] = zone;
+		buffer->head = (buffer->head + 1) % CPU_PROFILER_EVENTS;
+		if (buffer->count < CPU_PROFILER_EVENTS) buffer->count++;
+	}
+}
+
+bool CpuProfiler::WriteTrace(const char* fileLocation)
+{
+	std::ofstream fileStream(fileLocation, std::ios::out);
+
+	if (!fileStream.is_open())
+	{
+		printf("Failed to write %s!\n", fileLocation);
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(buffersMutex);
+
+	size_t eventCount = 0;
+	fileStream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	for (size_t i = 0; i < buffers.size(); i++)
+	{
+		ThreadBuffer* buffer = buffers[i];
+
+		// Oldest event first
+		for (unsigned int j = 0; j < buffer->count; j++)
+		{
+			ProfileEvent& event = buffer->events[(buffer->head + CPU_PROFILER_EVENTS - buffer->count + j) % CPU_PROFILER_EVENTS];
+
+			std::string name;
+			for (const char* c = event.name; *c; c++)
+			{
+				if (*c == '"' || *c == '\\') name += '\\';
+				name += *c;
+			}
+
+			char timing[128];
+			snprintf(timing, sizeof(timing), "\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u",
+				event.start / 1000.0, (event.end - event.start) / 1000.0, buffer->threadID);
+
+			fileStream << (eventCount++ ? ",\n" : "\n") << "{\"name\":\"" << name << "\",\"cat\":\"cpu\",\"ph\":\"X\"," << timing << "}";
+		}
+	}
+
+	fileStream << "\n]}\n";
+	fileStream.close();
+
+	printf("Wrote %zu CPU zones to %s\n", eventCount, fileLocation);
+	return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+
+// Comment out to compile every PROFILE_ZONE marker away
+#define ENABLE_CPU_PROFILER
+
+// Zones kept per thread, the oldest are overwritten once the ring is full
+const int CPU_PROFILER_EVENTS = 65536;
+const int CPU_PROFILER_MAX_DEPTH = 64;
+
+// Records named CPU time spans per thread and writes them as a Chrome/Perfetto trace
+class CpuProfiler
+{
+public:
+	static void BeginZone(const char* name);
+	static void EndZone();
+
+	static bool WriteTrace(const char* fileLocation);
+
+private:
+	struct ProfileEvent
+	{
+		const char* name;
+		unsigned long long start, end;
+		int depth;
+	};
+
+	struct ThreadBuffer
+	{
+		unsigned int threadID;
+		ProfileEvent events[CPU_PROFILER_EVENTS];
+		unsigned int head, count;
+		ProfileEvent openZones[CPU_PROFILER_MAX_DEPTH];
+		int depth;
+	};
+
+	static ThreadBuffer* GetThreadBuffer();
+	static unsigned long long Now();
+
+	static std::mutex buffersMutex;
+	static std::vector<ThreadBuffer*> buffers;
+};
+
+class CpuProfileScope
+{
+public:
+	CpuProfileScope(const char* name) { CpuProfiler::BeginZone(name); }
+	~CpuProfileScope() { CpuProfiler::EndZone(); }
+};
+
+#ifdef ENABLE_CPU_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) CpuProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_ZONE_BEGIN(name) CpuProfiler::BeginZone(name)
+#define PROFILE_ZONE_END() CpuProfiler::EndZone()
+#else
+#define PROFILE_ZONE(name)
+#define PROFILE_ZONE_BEGIN(name)
+#define PROFILE_ZONE_END()
+#endif
@@ -0,0 +1,219 @@
+#include "Culling.h"
+
+#include <algorithm>
+#include <cmath>
+
+// SSE2 is baseline on x64 and the MSVC default on x86
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CULLING_SSE
+#include <emmintrin.h>
+#endif
+
+CullVolume CreateFrustumVolume(const glm::mat4& viewProjection)
+{
+	CullVolume volume;
+	volume.isSphere = false;
+	volume.sphereCenter = glm::vec3(0.0f, 0.0f, 0.0f);
+	volume.sphereRadius = 0.0f;
+
+	glm::vec4 row[4];
+	for (int i = 0; i < 4; i++)
+	{
+		row[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+	}
+
+	volume.planes[0] = row[3] + row[0];	// left
+	volume.planes[1] = row[3] - row[0];	// right
+	volume.planes[2] = row[3] + row[1];	// bottom
+	volume.planes[3] = row[3] - row[1];	// top
+	volume.planes[4] = row[3] + row[2];	// near
+	volume.planes[5] = row[3] - row[2];	// far
+
+	for (int i = 0; i < 6; i++)
+	{
+		volume.planes[i] /= glm::length(glm::vec3(volume.planes[i]));
+	}
+
+	return volume;
+}
+
+CullVolume CreateSphereVolume(glm::vec3 center, float radius)
+{
+	CullVolume volume;
+	volume.isSphere = true;
+	volume.sphereCenter = center;
+	volume.sphereRadius = radius;
+
+	for (int i = 0; i < 6; i++)
+	{
+		volume.planes[i] = glm::vec4(0.0f, 0.0f, 0.0f, 0.0f);
+	}
+
+	return volume;
+}
+
+bool BoxInVolume(const CullVolume& volume, const BoundingBox& box)
+{
+	if (volume.isSphere)
+	{
+		// Distance from the sphere centre to the nearest point of the box
+		glm::vec3 offset = glm::max(glm::abs(box.center - volume.sphereCenter) - box.extent, glm::vec3(0.0f, 0.0f, 0.0f));
+		return glm::dot(offset, offset) <= volume.sphereRadius * volume.sphereRadius;
+	}
+
+	for (int i = 0; i < 6; i++)
+	{
+		glm::vec3 normal = glm::vec3(volume.planes[i]);
+		float distance = glm::dot(normal, box.center) + volume.planes[i].w;
+		float radius = glm::dot(glm::abs(normal), box.extent);
+
+		if (distance + radius < 0.0f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+CullResult ClassifyBox(const CullVolume& volume, const BoundingBox& box)
+{
+	if (volume.isSphere)
+	{
+		glm::vec3 offset = glm::abs(box.center - volume.sphereCenter);
+		glm::vec3 nearest = glm::max(offset - box.extent, glm::vec3(0.0f, 0.0f, 0.0f));
+		glm::vec3 farthest = offset + box.extent;
+		float radiusSquared = volume.sphereRadius * volume.sphereRadius;
+
+		if (glm::dot(nearest, nearest) > radiusSquared)
+		{
+			return CULL_OUTSIDE;
+		}
+		return glm::dot(farthest, farthest) <= radiusSquared ? CULL_INSIDE : CULL_INTERSECTS;
+	}
+
+	CullResult result = CULL_INSIDE;
+
+	for (int i = 0; i < 6; i++)
+	{
+		glm::vec3 normal = glm::vec3(volume.planes[i]);
+		float distance = glm::dot(normal, box.center) + volume.planes[i].w;
+		float radius = glm::dot(glm::abs(normal), box.extent);
+
+		if (distance + radius < 0.0f)
+		{
+			return CULL_OUTSIDE;
+		}
+		if (distance - radius < 0.0f)
+		{
+			result = CULL_INTERSECTS;
+		}
+	}
+
+	return result;
+}
+
+bool SphereInVolume(const CullVolume& volume, const BoundingSphere& sphere)
+{
+	if (volume.isSphere)
+	{
+		float reach = volume.sphereRadius + sphere.radius;
+		glm::vec3 offset = sphere.center - volume.sphereCenter;
+		return glm::dot(offset, offset) <= reach * reach;
+	}
+
+	for (int i = 0; i < 6; i++)
+	{
+		if (glm::dot(glm::vec3(volume.planes[i]), sphere.center) + volume.planes[i].w < -sphere.radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+size_t CullBoxes(const CullVolume& volume, const BoxArrays& boxes, size_t count, unsigned char* visible)
+{
+	size_t visibleCount = 0;
+	size_t i = 0;
+
+#ifdef CULLING_SSE
+	const __m128 zero = _mm_setzero_ps();
+
+	if (volume.isSphere)
+	{
+		const __m128 sphereX = _mm_set1_ps(volume.sphereCenter.x);
+		const __m128 sphereY = _mm_set1_ps(volume.sphereCenter.y);
+		const __m128 sphereZ = _mm_set1_ps(volume.sphereCenter.z);
+		const __m128 radiusSquared = _mm_set1_ps(volume.sphereRadius * volume.sphereRadius);
+		const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 dx = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(boxes.centerX + i), sphereX), signMask);
+			__m128 dy = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(boxes.centerY + i), sphereY), signMask);
+			__m128 dz = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(boxes.centerZ + i), sphereZ), signMask);
+
+			dx = _mm_max_ps(_mm_sub_ps(dx, _mm_loadu_ps(boxes.extentX + i)), zero);
+			dy = _mm_max_ps(_mm_sub_ps(dy, _mm_loadu_ps(boxes.extentY + i)), zero);
+			dz = _mm_max_ps(_mm_sub_ps(dz, _mm_loadu_ps(boxes.extentZ + i)), zero);
+
+			__m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+			int mask = _mm_movemask_ps(_mm_cmple_ps(distanceSquared, radiusSquared));
+
+			for (int j = 0; j < 4; j++)
+			{
+				visible[i + j] = (mask >> j) & 1;
+				visibleCount += visible[i + j];
+			}
+		}
+	}
+	else
+	{
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 centerX = _mm_loadu_ps(boxes.centerX + i);
+			__m128 centerY = _mm_loadu_ps(boxes.centerY + i);
+			__m128 centerZ = _mm_loadu_ps(boxes.centerZ + i);
+			__m128 extentX = _mm_loadu_ps(boxes.extentX + i);
+			__m128 extentY = _mm_loadu_ps(boxes.extentY + i);
+			__m128 extentZ = _mm_loadu_ps(boxes.extentZ + i);
+
+			// A box is out once it lies wholly behind any plane
+			__m128 outside = _mm_setzero_ps();
+			for (int p = 0; p < 6; p++)
+			{
+				const glm::vec4& plane = volume.planes[p];
+
+				__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(centerX, _mm_set1_ps(plane.x)), _mm_mul_ps(centerY, _mm_set1_ps(plane.y))),
+					_mm_add_ps(_mm_mul_ps(centerZ, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+				__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(extentX, _mm_set1_ps(fabsf(plane.x))), _mm_mul_ps(extentY, _mm_set1_ps(fabsf(plane.y)))),
+					_mm_mul_ps(extentZ, _mm_set1_ps(fabsf(plane.z))));
+
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+			}
+
+			int mask = ~_mm_movemask_ps(outside);
+
+			for (int j = 0; j < 4; j++)
+			{
+				visible[i + j] = (mask >> j) & 1;
+				visibleCount += visible[i + j];
+			}
+		}
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		BoundingBox box;
+		box.center = glm::vec3(boxes.centerX[i], boxes.centerY[i], boxes.centerZ[i]);
+		box.extent = glm::vec3(boxes.extentX[i], boxes.extentY[i], boxes.extentZ[i]);
+
+		visible[i] = BoxInVolume(volume, box) ? 1 : 0;
+		visibleCount += visible[i];
+	}
+
+	return visibleCount;
+}
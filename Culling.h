@@ -0,0 +1,52 @@
+#pragma once
+
+#include <glm\glm.hpp>
+
+#include "Geometry.h"
+
+// What a pass can see: the view frustum of a camera or light, or the range of an omni light
+struct CullVolume
+{
+	bool isSphere;
+	glm::vec4 planes[6];	// normals point inwards, w is the distance term
+	glm::vec3 sphereCenter;
+	float sphereRadius;
+};
+
+// World-space boxes laid out one component per array, so four can be tested per SIMD instruction
+struct BoxArrays
+{
+	const float* centerX;
+	const float* centerY;
+	const float* centerZ;
+	const float* extentX;
+	const float* extentY;
+	const float* extentZ;
+};
+
+enum CullResult
+{
+	CULL_OUTSIDE,
+	CULL_INTERSECTS,
+	CULL_INSIDE
+};
+
+struct CullStats
+{
+	unsigned int objectsDrawn;
+	unsigned int objectsCulled;
+	unsigned int meshesCulled;
+};
+
+// Planes of the clip volume of a view-projection matrix (Gribb & Hartmann)
+CullVolume CreateFrustumVolume(const glm::mat4& viewProjection);
+CullVolume CreateSphereVolume(glm::vec3 center, float radius);
+
+bool BoxInVolume(const CullVolume& volume, const BoundingBox& box);
+bool SphereInVolume(const CullVolume& volume, const BoundingSphere& sphere);
+
+// Also tells boxes wholly inside apart, so hierarchies can accept a subtree without testing it
+CullResult ClassifyBox(const CullVolume& volume, const BoundingBox& box);
+
+// Writes 1 for each box touching the volume and 0 otherwise, returns the number visible
+size_t CullBoxes(const CullVolume& volume, const BoxArrays& boxes, size_t count, unsigned char* visible);
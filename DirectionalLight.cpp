@@ -1,35 +1,111 @@
-#include "DirectionalLight.h"
-
-DirectionalLight::DirectionalLight() : Light()
-{
-	direction = glm::vec3(0.0f, -1.0f, 0.0f);
-}
-
-DirectionalLight::DirectionalLight(GLuint shadowWidth, GLuint shadowHeight, 
-									GLfloat red, GLfloat green, GLfloat blue,
-									GLfloat aIntensity, GLfloat dIntensity,
-									GLfloat xDir, GLfloat yDir, GLfloat zDir) : Light(shadowWidth, shadowHeight, red, green, blue, aIntensity, dIntensity)
-{
-	direction = glm::vec3(xDir, yDir, zDir);
-
-	lightProj = glm::ortho(-20.0f, 20.0f, -20.0f, 20.0f, 0.1f, 100.0f);
-}
-
-void DirectionalLight::UseLight(GLfloat ambientIntensityLocation, GLfloat ambientColourLocation,
-	GLfloat diffuseIntensityLocation, GLfloat directionLocation)
-{
-	glUniform3f(ambientColourLocation, colour.x, colour.y, colour.z);
-	glUniform1f(ambientIntensityLocation, ambientIntensity);
-
-	glUniform3f(directionLocation, direction.x, direction.y, direction.z);
-	glUniform1f(diffuseIntensityLocation, diffuseIntensity);
-}
-
-glm::mat4 DirectionalLight::CalculateLightTransform()
-{
-	return lightProj * glm::lookAt(-direction, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-}
-
-DirectionalLight::~DirectionalLight()
-{
-}
+#include "DirectionalLight.h"
+
+// Blend between logarithmic splits, which keep texel density even, and uniform ones,
+// which keep distant cascades from growing too large
+const float CASCADE_SPLIT_LAMBDA = 0.75f;
+
+DirectionalLight::DirectionalLight() : Light()
+{
+	direction = glm::vec3(0.0f, -1.0f, 0.0f);
+
+	SetCascadeCount(3);
+}
+
+DirectionalLight::DirectionalLight(GLuint shadowWidth, GLuint shadowHeight, 
+									GLfloat red, GLfloat green, GLfloat blue,
+									GLfloat aIntensity, GLfloat dIntensity,
+									GLfloat xDir, GLfloat yDir, GLfloat zDir) : Light(shadowWidth, shadowHeight, red, green, blue, aIntensity, dIntensity)
+{
+	direction = glm::vec3(xDir, yDir, zDir);
+
+	SetCascadeCount(3);
+
+	shadowMap = new CascadedShadowMap();
+	shadowMap->Init(shadowWidth, shadowHeight);
+}
+
+void DirectionalLight::FillLightData(DirectionalLightData& data)
+{
+	FillBaseData(data.base);
+
+	data.direction = direction;
+}
+
+void DirectionalLight::SetCascadeCount(unsigned int count)
+{
+	cascadeCount = glm::max(1u, glm::min(count, (unsigned int)MAX_SHADOW_CASCADES));
+
+	// Filled by the next UpdateCascades, the unused ones stay blank
+	for (unsigned int i = 0; i < MAX_SHADOW_CASCADES; i++)
+	{
+		cascadeTransforms[i] = glm::mat4(1.0f);
+		cascadeSplits[i] = 0.0f;
+		cascadeTexelSizes[i] = 0.0f;
+	}
+}
+
+void DirectionalLight::UpdateCascades(const glm::mat4& view, const glm::mat4& projection, const BoundingBox& sceneBounds)
+{
+	// Near and far planes and the half-angle tangents back out of a glm::perspective matrix
+	float nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+	float farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+	float tanHalfX = 1.0f / projection[0][0];
+	float tanHalfY = 1.0f / projection[1][1];
+	float cornerSlope = tanHalfX * tanHalfX + tanHalfY * tanHalfY;
+
+	glm::mat4 inverseView = glm::inverse(view);
+	glm::vec3 eye = glm::vec3(inverseView[3]);
+	glm::vec3 forward = -glm::vec3(inverseView[2]);
+
+	glm::vec3 lightDir = glm::normalize(direction);
+	glm::vec3 up = fabs(lightDir.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+	glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), lightDir, up);
+
+	// Light space depth of the scene's closest point to the light, casters up to there can shade the slices
+	BoundingBox lightBounds = TransformBoundingBox(sceneBounds, lightView);
+	float sceneTop = lightBounds.center.z + lightBounds.extent.z;
+
+	float sliceNear = nearPlane;
+	for (unsigned int i = 0; i < cascadeCount; i++)
+	{
+		float t = (float)(i + 1) / cascadeCount;
+		float sliceFar = CASCADE_SPLIT_LAMBDA * nearPlane * powf(farPlane / nearPlane, t) + (1.0f - CASCADE_SPLIT_LAMBDA) * (nearPlane + (farPlane - nearPlane) * t);
+
+		// Smallest sphere around the slice's corners has its centre on the view axis
+		float centreDepth = 0.5f * (sliceNear + sliceFar) * (1.0f + cornerSlope);
+		float radius;
+		if (centreDepth >= sliceFar)
+		{
+			centreDepth = sliceFar;
+			radius = sliceFar * sqrtf(cornerSlope);
+		}
+		else
+		{
+			radius = sqrtf((sliceFar - centreDepth) * (sliceFar - centreDepth) + sliceFar * sliceFar * cornerSlope);
+		}
+		radius = ceilf(radius * 16.0f) / 16.0f;
+
+		float texelSize = 2.0f * radius / shadowMap->GetShadowWidth();
+
+		glm::vec3 centre = glm::vec3(lightView * glm::vec4(eye + forward * centreDepth, 1.0f));
+		centre.x = floorf(centre.x / texelSize) * texelSize;
+		centre.y = floorf(centre.y / texelSize) * texelSize;
+		centre.z = floorf(centre.z / texelSize) * texelSize;
+
+		// Near plane in steps of the radius so small scene changes don't move the box
+		float top = glm::max(centre.z + radius, sceneTop);
+		top = ceilf(top / radius) * radius;
+
+		glm::mat4 lightProj = glm::ortho(centre.x - radius, centre.x + radius, centre.y - radius, centre.y + radius, -top, -(centre.z - radius - texelSize));
+
+		cascadeTransforms[i] = lightProj * lightView;
+		cascadeSplits[i] = sliceFar;
+		cascadeTexelSizes[i] = texelSize;
+
+		sliceNear = sliceFar;
+	}
+}
+
+DirectionalLight::~DirectionalLight()
+{
+}
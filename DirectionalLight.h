@@ -1,24 +1,44 @@
-#pragma once
-#include "Light.h"
-
-class DirectionalLight :
-	public Light
-{
-public:
-	DirectionalLight();
-	DirectionalLight(GLuint shadowWidth, GLuint shadowHeight, 
-					GLfloat red, GLfloat green, GLfloat blue,
-					GLfloat aIntensity, GLfloat dIntensity,
-					GLfloat xDir, GLfloat yDir, GLfloat zDir);
-
-	void UseLight(GLfloat ambientIntensityLocation, GLfloat ambientColourLocation,
-		GLfloat diffuseIntensityLocation, GLfloat directionLocation);
-
-	glm::mat4 CalculateLightTransform();
-
-	~DirectionalLight();
-
-private:
-	glm::vec3 direction;
-};
-
+#pragma once
+#include "Light.h"
+#include "CascadedShadowMap.h"
+#include "Geometry.h"
+
+class DirectionalLight :
+	public Light
+{
+public:
+	DirectionalLight();
+	DirectionalLight(GLuint shadowWidth, GLuint shadowHeight, 
+					GLfloat red, GLfloat green, GLfloat blue,
+					GLfloat aIntensity, GLfloat dIntensity,
+					GLfloat xDir, GLfloat yDir, GLfloat zDir);
+
+	void FillLightData(DirectionalLightData& data);
+
+	// Splits the camera frustum between the cascades and fits an ortho box around each slice.
+	// Boxes bound a sphere around the slice so they don't change size as the camera turns, and move
+	// in whole texels so shadow edges don't shimmer. Each box reaches back to cover every caster in sceneBounds
+	void UpdateCascades(const glm::mat4& view, const glm::mat4& projection, const BoundingBox& sceneBounds);
+
+	CascadedShadowMap* getCascadedShadowMap() { return (CascadedShadowMap*)shadowMap; }
+
+	unsigned int GetCascadeCount() { return cascadeCount; }
+	void SetCascadeCount(unsigned int count);
+
+	glm::mat4 GetCascadeTransform(unsigned int cascade) { return cascadeTransforms[cascade]; }
+	// Furthest view depth the cascade covers
+	GLfloat GetCascadeSplit(unsigned int cascade) { return cascadeSplits[cascade]; }
+	// World size of one of the cascade's shadow map texels
+	GLfloat GetCascadeTexelSize(unsigned int cascade) { return cascadeTexelSizes[cascade]; }
+
+	~DirectionalLight();
+
+private:
+	glm::vec3 direction;
+
+	unsigned int cascadeCount;
+	glm::mat4 cascadeTransforms[MAX_SHADOW_CASCADES];
+	GLfloat cascadeSplits[MAX_SHADOW_CASCADES];
+	GLfloat cascadeTexelSizes[MAX_SHADOW_CASCADES];
+};
+
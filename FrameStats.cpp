@@ -0,0 +1,121 @@
+#include "FrameStats.h"
+
+#include <algorithm>
+#include <cmath>
+
+FrameStats::FrameStats()
+{
+}
+
+void FrameStats::AddSample(const std::string& series, double milliseconds)
+{
+	int index = FindSeries(series);
+
+	if (index < 0)
+	{
+		seriesNames.push_back(series);
+		seriesSamples.push_back(std::vector<double>());
+		index = seriesNames.size() - 1;
+	}
+
+	seriesSamples[index].push_back(milliseconds);
+}
+
+double FrameStats::GetPercentile(const std::string& series, double percentile)
+{
+	int index = FindSeries(series);
+
+	if (index < 0 || seriesSamples[index].empty())
+	{
+		return 0.0;
+	}
+
+	// Nearest-rank percentile over a sorted copy so samples stay in frame order
+	std::vector<double> sorted = seriesSamples[index];
+	std::sort(sorted.begin(), sorted.end());
+
+	size_t rank = (size_t)std::ceil(percentile / 100.0 * sorted.size());
+	if (rank < 1) rank = 1;
+	if (rank > sorted.size()) rank = sorted.size();
+
+	return sorted[rank - 1];
+}
+
+double FrameStats::GetMean(const std::string& series)
+{
+	int index = FindSeries(series);
+
+	if (index < 0 || seriesSamples[index].empty())
+	{
+		return 0.0;
+	}
+
+	double total = 0.0;
+	for (size_t i = 0; i < seriesSamples[index].size(); i++)
+	{
+		total += seriesSamples[index][i];
+	}
+
+	return total / seriesSamples[index].size();
+}
+
+size_t FrameStats::GetSampleCount(const std::string& series)
+{
+	int index = FindSeries(series);
+	return index < 0 ? 0 : seriesSamples[index].size();
+}
+
+void FrameStats::PrintReport()
+{
+	printf("%-32s %8s %12s %12s %12s\n", "Series", "Frames", "p50", "p95", "p99");
+
+	for (size_t i = 0; i < seriesNames.size(); i++)
+	{
+		printf("%-32s %8zu %12.3f %12.3f %12.3f\n", seriesNames[i].c_str(), seriesSamples[i].size(),
+			GetPercentile(seriesNames[i], 50.0), GetPercentile(seriesNames[i], 95.0), GetPercentile(seriesNames[i], 99.0));
+	}
+}
+
+bool FrameStats::WriteCSV(const char* fileLocation)
+{
+	std::ofstream fileStream(fileLocation, std::ios::out);
+
+	if (!fileStream.is_open())
+	{
+		printf("Failed to write %s!\n", fileLocation);
+		return false;
+	}
+
+	fileStream << "series,samples,mean,p50,p95,p99\n";
+	for (size_t i = 0; i < seriesNames.size(); i++)
+	{
+		fileStream << seriesNames[i] << "," << seriesSamples[i].size() << "," << GetMean(seriesNames[i]) << ","
+			<< GetPercentile(seriesNames[i], 50.0) << "," << GetPercentile(seriesNames[i], 95.0) << "," << GetPercentile(seriesNames[i], 99.0) << "\n";
+	}
+
+	fileStream.close();
+	return true;
+}
+
+void FrameStats::Clear()
+{
+	seriesNames.clear();
+	seriesSamples.clear();
+}
+
+int FrameStats::FindSeries(const std::string& series)
+{
+	for (size_t i = 0; i < seriesNames.size(); i++)
+	{
+		if (seriesNames[i] == series)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+FrameStats::~FrameStats()
+{
+}
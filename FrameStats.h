@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <fstream>
+
+// Collects per-frame samples (timings, counters) for a set of named series and reports their percentiles
+class FrameStats
+{
+public:
+	FrameStats();
+
+	void AddSample(const std::string& series, double milliseconds);
+
+	double GetPercentile(const std::string& series, double percentile);
+	double GetMean(const std::string& series);
+	size_t GetSampleCount(const std::string& series);
+
+	void PrintReport();
+	bool WriteCSV(const char* fileLocation);
+	void Clear();
+
+	~FrameStats();
+
+private:
+	int FindSeries(const std::string& series);
+
+	std::vector<std::string> seriesNames;
+	std::vector<std::vector<double>> seriesSamples;
+};
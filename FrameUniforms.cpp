@@ -0,0 +1,221 @@
+#include "FrameUniforms.h"
+
+#include <algorithm>
+#include <cstring>
+
+GLuint FrameUniforms::cameraBuffer = 0;
+GLuint FrameUniforms::lightsBuffer = 0;
+GLuint FrameUniforms::shadowTransformsBuffer = 0;
+GLuint FrameUniforms::omniShadowBuffer = 0;
+GLuint FrameUniforms::shadowViewBuffer = 0;
+GLuint FrameUniforms::omniShadowFaceBuffer = 0;
+GLsizeiptr FrameUniforms::omniShadowStride = 0;
+GLsizeiptr FrameUniforms::shadowViewStride = 0;
+GLsizeiptr FrameUniforms::omniShadowFaceStride = 0;
+GLint FrameUniforms::shadowTaps = 8;
+GLfloat FrameUniforms::shadowTapDistance = 0.0f;
+std::vector<unsigned char> FrameUniforms::omniShadowStaging;
+std::vector<unsigned char> FrameUniforms::shadowViewStaging;
+
+void FrameUniforms::BindBlocks(GLuint program)
+{
+	static const struct { const char* name; GLuint binding; } blocks[] = {
+		{ "Camera", CAMERA_BLOCK_BINDING },
+		{ "Lights", LIGHTS_BLOCK_BINDING },
+		{ "ShadowTransforms", SHADOW_TRANSFORMS_BLOCK_BINDING },
+		{ "OmniShadow", OMNI_SHADOW_BLOCK_BINDING },
+		{ "ShadowView", SHADOW_VIEW_BLOCK_BINDING },
+		{ "OmniShadowFace", OMNI_SHADOW_FACE_BLOCK_BINDING }
+	};
+
+	for (const auto& block : blocks)
+	{
+		GLuint blockIndex = glGetUniformBlockIndex(program, block.name);
+		if (blockIndex != GL_INVALID_INDEX)
+		{
+			glUniformBlockBinding(program, blockIndex, block.binding);
+		}
+	}
+}
+
+void FrameUniforms::Upload(GLuint& buffer, GLuint binding, const void* data, GLsizeiptr size)
+{
+	if (buffer == 0)
+	{
+		glGenBuffers(1, &buffer);
+		glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+		glBufferData(GL_UNIFORM_BUFFER, size, data, GL_DYNAMIC_DRAW);
+
+		// Nothing else uses these binding points, so the buffer stays bound from here on
+		glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+	}
+	else
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+	}
+
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+GLsizeiptr FrameUniforms::AlignedStride(GLsizeiptr size)
+{
+	GLint alignment = 0;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	alignment = std::max(alignment, 1);
+	return (size + alignment - 1) / alignment * alignment;
+}
+
+void FrameUniforms::UploadRanges(GLuint& buffer, const std::vector<unsigned char>& staging, GLsizeiptr size)
+{
+	if (buffer == 0)
+	{
+		glGenBuffers(1, &buffer);
+		glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+		glBufferData(GL_UNIFORM_BUFFER, staging.size(), staging.data(), GL_DYNAMIC_DRAW);
+	}
+	else
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, size, staging.data());
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void FrameUniforms::SetCamera(const glm::mat4& projection, const glm::mat4& view, const glm::vec3& eyePosition)
+{
+	CameraBlock camera;
+	camera.projection = projection;
+	camera.view = view;
+	camera.eyePosition = eyePosition;
+	camera.padding = 0.0f;
+
+	Upload(cameraBuffer, CAMERA_BLOCK_BINDING, &camera, sizeof(camera));
+}
+
+void FrameUniforms::SetShadowFilter(GLint taps, GLfloat tapDistance)
+{
+	shadowTaps = taps;
+	shadowTapDistance = tapDistance;
+}
+
+void FrameUniforms::SetLights(DirectionalLight* directionalLight, PointLight* pointLights, unsigned int pointLightCount,
+	SpotLight* spotLights, unsigned int spotLightCount, LightClusters& clusters)
+{
+	if (pointLightCount > MAX_POINT_LIGHTS) pointLightCount = MAX_POINT_LIGHTS;
+	if (spotLightCount > MAX_SPOT_LIGHTS) spotLightCount = MAX_SPOT_LIGHTS;
+
+	LightsBlock lights;
+	memset(&lights, 0, sizeof(lights));
+
+	directionalLight->FillLightData(lights.directionalLight);
+	clusters.FillLightsData(lights);
+	lights.shadowTaps = shadowTaps;
+	lights.shadowTapDistance = shadowTapDistance;
+
+	Upload(lightsBuffer, LIGHTS_BLOCK_BINDING, &lights, sizeof(lights));
+
+	ShadowTransformsBlock shadowTransforms;
+	memset(&shadowTransforms, 0, sizeof(shadowTransforms));
+
+	if (shadowViewStride == 0)
+	{
+		shadowViewStride = AlignedStride(sizeof(ShadowViewBlock));
+		shadowViewStaging.assign(shadowViewStride * (MAX_SHADOW_CASCADES + MAX_SPOT_LIGHTS), 0);
+	}
+
+	for (unsigned int i = 0; i < MAX_SHADOW_CASCADES; i++)
+	{
+		shadowTransforms.cascadeTransforms[i] = directionalLight->GetCascadeTransform(i);
+		shadowTransforms.cascadeSplits[i] = directionalLight->GetCascadeSplit(i);
+		shadowTransforms.cascadeTexelSizes[i] = directionalLight->GetCascadeTexelSize(i);
+
+		ShadowViewBlock shadowView;
+		shadowView.lightTransform = shadowTransforms.cascadeTransforms[i];
+		memcpy(&shadowViewStaging[shadowViewStride * i], &shadowView, sizeof(shadowView));
+	}
+	shadowTransforms.cascadeCount = directionalLight->GetCascadeCount();
+
+	for (unsigned int i = 0; i < spotLightCount; i++)
+	{
+		ShadowAllocation* allocation = spotLights[i].GetShadowAllocation();
+		if (allocation->tileSize > 0)
+		{
+			shadowTransforms.spotShadows[i].atlasRect = allocation->uvRects[0];
+		}
+
+		shadowTransforms.spotShadows[i].lightTransform = spotLights[i].CalculateSpotTransform();
+		shadowTransforms.spotShadows[i].nearPlane = spotLights[i].GetNearPlane();
+		shadowTransforms.spotShadows[i].farPlane = spotLights[i].GetFarPlane();
+
+		ShadowViewBlock shadowView;
+		shadowView.lightTransform = shadowTransforms.spotShadows[i].lightTransform;
+		memcpy(&shadowViewStaging[shadowViewStride * (MAX_SHADOW_CASCADES + i)], &shadowView, sizeof(shadowView));
+	}
+
+	UploadRanges(shadowViewBuffer, shadowViewStaging, shadowViewStaging.size());
+
+	if (omniShadowStride == 0)
+	{
+		omniShadowStride = AlignedStride(sizeof(OmniShadowBlock));
+		omniShadowStaging.assign(omniShadowStride * MAX_POINT_LIGHTS, 0);
+	}
+
+	for (size_t i = 0; i < pointLightCount; i++)
+	{
+		PointLight* light = &pointLights[i];
+
+		OmniShadowBlock omniShadow;
+		std::vector<glm::mat4> lightMatrices = light->CalculateLightTransform();
+		std::copy(lightMatrices.begin(), lightMatrices.end(), omniShadow.lightMatrices);
+		omniShadow.lightPos = light->GetPosition();
+		omniShadow.farPlane = light->GetFarPlane();
+
+		memcpy(&omniShadowStaging[omniShadowStride * i], &omniShadow, sizeof(omniShadow));
+
+		ShadowAllocation* allocation = light->GetShadowAllocation();
+		if (allocation->tileSize > 0)
+		{
+			std::copy(allocation->uvRects, allocation->uvRects + 6, shadowTransforms.pointShadows[i].faceRects);
+		}
+	}
+
+	Upload(shadowTransformsBuffer, SHADOW_TRANSFORMS_BLOCK_BINDING, &shadowTransforms, sizeof(shadowTransforms));
+
+	UploadRanges(omniShadowBuffer, omniShadowStaging, omniShadowStride * pointLightCount);
+}
+
+void FrameUniforms::BindOmniShadow(unsigned int pointIndex)
+{
+	glBindBufferRange(GL_UNIFORM_BUFFER, OMNI_SHADOW_BLOCK_BINDING, omniShadowBuffer, omniShadowStride * pointIndex, sizeof(OmniShadowBlock));
+}
+
+void FrameUniforms::BindCascadeShadowView(unsigned int cascade)
+{
+	glBindBufferRange(GL_UNIFORM_BUFFER, SHADOW_VIEW_BLOCK_BINDING, shadowViewBuffer, shadowViewStride * cascade, sizeof(ShadowViewBlock));
+}
+
+void FrameUniforms::BindSpotShadowView(unsigned int spotIndex)
+{
+	glBindBufferRange(GL_UNIFORM_BUFFER, SHADOW_VIEW_BLOCK_BINDING, shadowViewBuffer, shadowViewStride * (MAX_SHADOW_CASCADES + spotIndex), sizeof(ShadowViewBlock));
+}
+
+void FrameUniforms::BindOmniShadowFace(unsigned int face)
+{
+	// The face indices never change, so the buffer is filled once
+	if (omniShadowFaceBuffer == 0)
+	{
+		omniShadowFaceStride = AlignedStride(sizeof(OmniShadowFaceBlock));
+
+		std::vector<unsigned char> staging(omniShadowFaceStride * 6, 0);
+		for (GLint i = 0; i < 6; i++)
+		{
+			OmniShadowFaceBlock omniShadowFace = { i, { 0, 0, 0 } };
+			memcpy(&staging[omniShadowFaceStride * i], &omniShadowFace, sizeof(omniShadowFace));
+		}
+
+		UploadRanges(omniShadowFaceBuffer, staging, staging.size());
+	}
+
+	glBindBufferRange(GL_UNIFORM_BUFFER, OMNI_SHADOW_FACE_BLOCK_BINDING, omniShadowFaceBuffer, omniShadowFaceStride * face, sizeof(OmniShadowFaceBlock));
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+
+#include <GL\glew.h>
+
+#include <glm\glm.hpp>
+
+#include "UniformBlocks.h"
+#include "DirectionalLight.h"
+#include "PointLight.h"
+#include "SpotLight.h"
+#include "LightClusters.h"
+
+// Uniform buffers filled once per frame and read by every program through fixed binding points,
+// instead of each program setting its own copy of the camera and lights
+class FrameUniforms
+{
+public:
+	// Attaches whichever of the shared blocks the linked program declares to their bindings
+	static void BindBlocks(GLuint program);
+
+	static void SetCamera(const glm::mat4& projection, const glm::mat4& view, const glm::vec3& eyePosition);
+
+	// Shadow filter quality for the next SetLights: 1, 4, 8 or 20 taps, dropping a tier each time the
+	// view distance doubles past tapDistance, or never with a tapDistance of 0. Moment shadow maps are
+	// a variant of the main shaders instead
+	static void SetShadowFilter(GLint taps, GLfloat tapDistance);
+
+	// Fills the Lights and ShadowTransforms blocks, one ShadowView block per cascade and shadowed spot light
+	// and one OmniShadow block per shadowed point light. Call after ShadowAtlas::Allocate, the atlas rects come from the lights,
+	// and after clusters were built, the point and spot lights themselves are read from there
+	static void SetLights(DirectionalLight* directionalLight, PointLight* pointLights, unsigned int pointLightCount,
+		SpotLight* spotLights, unsigned int spotLightCount, LightClusters& clusters);
+
+	// Points the OmniShadow binding at the block of the point light being rendered
+	static void BindOmniShadow(unsigned int pointIndex);
+
+	// Point the ShadowView binding at the cascade or spot light being rendered
+	static void BindCascadeShadowView(unsigned int cascade);
+	static void BindSpotShadowView(unsigned int spotIndex);
+
+	// Points the OmniShadowFace binding at the cube face being rendered
+	static void BindOmniShadowFace(unsigned int face);
+
+private:
+	static GLuint cameraBuffer, lightsBuffer, shadowTransformsBuffer, omniShadowBuffer, shadowViewBuffer, omniShadowFaceBuffer;
+	static GLsizeiptr omniShadowStride, shadowViewStride, omniShadowFaceStride;
+	static GLint shadowTaps;
+	static GLfloat shadowTapDistance;
+	static std::vector<unsigned char> omniShadowStaging, shadowViewStaging;
+
+	static void Upload(GLuint& buffer, GLuint binding, const void* data, GLsizeiptr size);
+
+	// Blocks bound by range each start on the driver's offset alignment
+	static GLsizeiptr AlignedStride(GLsizeiptr size);
+	static void UploadRanges(GLuint& buffer, const std::vector<unsigned char>& staging, GLsizeiptr size);
+};
@@ -0,0 +1,104 @@
+#include "GBuffer.h"
+
+GBuffer::GBuffer()
+{
+	FBO = 0;
+	albedoTexture = 0;
+	normalTexture = 0;
+	materialTexture = 0;
+	depthTexture = 0;
+	emptyVAO = 0;
+	bufferWidth = 0;
+	bufferHeight = 0;
+}
+
+GLuint GBuffer::CreateTarget(GLint internalFormat, GLenum format, GLenum type, GLenum attachment)
+{
+	GLuint texture;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, bufferWidth, bufferHeight, 0, format, type, nullptr);
+
+	// Read back with texelFetch, one texel per pixel
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, texture, 0);
+
+	return texture;
+}
+
+bool GBuffer::Init(unsigned int width, unsigned int height)
+{
+	bufferWidth = width; bufferHeight = height;
+
+	glGenFramebuffers(1, &FBO);
+	glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+
+	// 10 bytes of colour a pixel: albedo in RGBA8, the normal folded onto two signed 16 bit channels,
+	// specular intensity and shininess in RG8
+	albedoTexture = CreateTarget(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, GL_COLOR_ATTACHMENT0);
+	normalTexture = CreateTarget(GL_RG16_SNORM, GL_RG, GL_SHORT, GL_COLOR_ATTACHMENT1);
+	materialTexture = CreateTarget(GL_RG8, GL_RG, GL_UNSIGNED_BYTE, GL_COLOR_ATTACHMENT2);
+	depthTexture = CreateTarget(GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_FLOAT, GL_DEPTH_ATTACHMENT);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	GLenum Status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if (Status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		printf("Framebuffer error: %i\n", Status);
+		return false;
+	}
+
+	// Core profiles draw nothing without a vertex array bound, even one with no attributes
+	glGenVertexArrays(1, &emptyVAO);
+
+	return true;
+}
+
+void GBuffer::Write()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+
+	GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2 };
+	glDrawBuffers(3, drawBuffers);
+}
+
+void GBuffer::Read(GLenum textureUnit)
+{
+	GLuint textures[] = { albedoTexture, normalTexture, materialTexture, depthTexture };
+	for (GLenum i = 0; i < 4; i++)
+	{
+		glActiveTexture(textureUnit + i);
+		glBindTexture(GL_TEXTURE_2D, textures[i]);
+	}
+}
+
+void GBuffer::DrawFullScreen()
+{
+	glBindVertexArray(emptyVAO);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindVertexArray(0);
+}
+
+GBuffer::~GBuffer()
+{
+	GLuint textures[] = { albedoTexture, normalTexture, materialTexture, depthTexture };
+
+	if (FBO)
+	{
+		glDeleteFramebuffers(1, &FBO);
+		glDeleteTextures(4, textures);
+	}
+
+	if (emptyVAO)
+	{
+		glDeleteVertexArrays(1, &emptyVAO);
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdio.h>
+
+#include <GL\glew.h>
+
+// Surface attributes of the deferred path, one texel per pixel: albedo, octahedral normal, specular intensity and
+// shininess, and depth, from which the lighting pass rebuilds the world position
+class GBuffer
+{
+public:
+	GBuffer();
+
+	bool Init(unsigned int width, unsigned int height);
+
+	// Binds the framebuffer with all three colour targets enabled
+	void Write();
+
+	// Albedo, normal, material and depth on four units from textureUnit
+	void Read(GLenum textureUnit);
+
+	// A single triangle over the whole viewport, positions come from gl_VertexID
+	void DrawFullScreen();
+
+	GLuint GetWidth() { return bufferWidth; }
+	GLuint GetHeight() { return bufferHeight; }
+
+	~GBuffer();
+
+private:
+	GLuint FBO, albedoTexture, normalTexture, materialTexture, depthTexture;
+	GLuint emptyVAO;
+	GLuint bufferWidth, bufferHeight;
+
+	GLuint CreateTarget(GLint internalFormat, GLenum format, GLenum type, GLenum attachment);
+};
@@ -0,0 +1,136 @@
+#include "Geometry.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm\gtc\matrix_inverse.hpp>
+
+static const float toRadians = 3.14159265f / 180.0f;
+
+void calcAverageNormals(unsigned int * indices, unsigned int indiceCount, GLfloat * vertices, unsigned int verticeCount,
+						unsigned int vLength, unsigned int normalOffset)
+{
+	for (size_t i = 0; i < indiceCount; i += 3)
+	{
+		unsigned int in0 = indices[i] * vLength;
+		unsigned int in1 = indices[i + 1] * vLength;
+		unsigned int in2 = indices[i + 2] * vLength;
+		glm::vec3 v1(vertices[in1] - vertices[in0], vertices[in1 + 1] - vertices[in0 + 1], vertices[in1 + 2] - vertices[in0 + 2]);
+		glm::vec3 v2(vertices[in2] - vertices[in0], vertices[in2 + 1] - vertices[in0 + 1], vertices[in2 + 2] - vertices[in0 + 2]);
+		glm::vec3 normal = glm::cross(v1, v2);
+		normal = glm::normalize(normal);
+		
+		in0 += normalOffset; in1 += normalOffset; in2 += normalOffset;
+		vertices[in0] += normal.x; vertices[in0 + 1] += normal.y; vertices[in0 + 2] += normal.z;
+		vertices[in1] += normal.x; vertices[in1 + 1] += normal.y; vertices[in1 + 2] += normal.z;
+		vertices[in2] += normal.x; vertices[in2 + 1] += normal.y; vertices[in2 + 2] += normal.z;
+	}
+
+	for (size_t i = 0; i < verticeCount / vLength; i++)
+	{
+		unsigned int nOffset = i * vLength + normalOffset;
+		glm::vec3 vec(vertices[nOffset], vertices[nOffset + 1], vertices[nOffset + 2]);
+		vec = glm::normalize(vec);
+		vertices[nOffset] = vec.x; vertices[nOffset + 1] = vec.y; vertices[nOffset + 2] = vec.z;
+	}
+}
+
+void InterleaveVertices(const aiMesh * mesh, std::vector<GLfloat>& vertices)
+{
+	for (size_t i = 0; i < mesh->mNumVertices; i++)
+	{
+		vertices.insert(vertices.end(), { mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z });
+		if (mesh->mTextureCoords[0])
+		{
+			vertices.insert(vertices.end(), { mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y });
+		}
+		else {
+			vertices.insert(vertices.end(), { 0.0f, 0.0f });
+		}
+		vertices.insert(vertices.end(), { -mesh->mNormals[i].x, -mesh->mNormals[i].y, -mesh->mNormals[i].z });
+	}
+}
+
+void CalculateBounds(const GLfloat * vertices, size_t vertexCount, unsigned int vLength, BoundingBox& box, BoundingSphere& sphere)
+{
+	if (vertexCount == 0)
+	{
+		box.center = glm::vec3(0.0f, 0.0f, 0.0f);
+		box.extent = glm::vec3(0.0f, 0.0f, 0.0f);
+		sphere.center = box.center;
+		sphere.radius = 0.0f;
+		return;
+	}
+
+	glm::vec3 minimum(vertices[0], vertices[1], vertices[2]);
+	glm::vec3 maximum = minimum;
+
+	for (size_t i = 1; i < vertexCount; i++)
+	{
+		const GLfloat* position = &vertices[i * vLength];
+		minimum = glm::min(minimum, glm::vec3(position[0], position[1], position[2]));
+		maximum = glm::max(maximum, glm::vec3(position[0], position[1], position[2]));
+	}
+
+	box.center = (minimum + maximum) * 0.5f;
+	box.extent = (maximum - minimum) * 0.5f;
+
+	// Centred on the box but sized to the farthest vertex, which is tighter than the box's half diagonal
+	float radiusSquared = 0.0f;
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		const GLfloat* position = &vertices[i * vLength];
+		glm::vec3 offset = glm::vec3(position[0], position[1], position[2]) - box.center;
+		radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+	}
+
+	sphere.center = box.center;
+	sphere.radius = sqrtf(radiusSquared);
+}
+
+BoundingBox TransformBoundingBox(const BoundingBox& box, const glm::mat4& transform)
+{
+	BoundingBox result;
+	result.center = glm::vec3(transform * glm::vec4(box.center, 1.0f));
+
+	// Each axis of the new box spans the absolute projection of the old extents (Arvo)
+	for (int i = 0; i < 3; i++)
+	{
+		result.extent[i] = fabsf(transform[0][i]) * box.extent.x + fabsf(transform[1][i]) * box.extent.y + fabsf(transform[2][i]) * box.extent.z;
+	}
+
+	return result;
+}
+
+BoundingBox MergeBoundingBoxes(const BoundingBox& a, const BoundingBox& b)
+{
+	glm::vec3 minimum = glm::min(a.center - a.extent, b.center - b.extent);
+	glm::vec3 maximum = glm::max(a.center + a.extent, b.center + b.extent);
+
+	BoundingBox result;
+	result.center = (minimum + maximum) * 0.5f;
+	result.extent = (maximum - minimum) * 0.5f;
+	return result;
+}
+
+glm::mat4 ComposeModelMatrix(glm::vec3 position, glm::vec3 rotation, glm::vec3 scale)
+{
+	glm::mat4 model(1.0f);
+	model = glm::translate(model, position);
+	model = glm::rotate(model, rotation.x * toRadians, glm::vec3(1, 0, 0));
+	model = glm::rotate(model, rotation.y * toRadians, glm::vec3(0, 1, 0));
+	model = glm::rotate(model, rotation.z * toRadians, glm::vec3(0, 0, 1));
+	model = glm::scale(model, scale);
+	return model;
+}
+
+glm::mat3 ComposeNormalMatrix(const glm::mat4& model, glm::vec3 scale)
+{
+	if (scale.x == scale.y && scale.y == scale.z && scale.x != 0.0f)
+	{
+		// inverseTranspose(sR) is R / s, which keeps the sign of a mirroring negative scale
+		return glm::mat3(model) * (1.0f / (scale.x * scale.x));
+	}
+
+	return glm::inverseTranspose(glm::mat3(model));
+}
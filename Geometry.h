@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+
+#include <GL\glew.h>
+
+#include <glm\glm.hpp>
+#include <glm\gtc\matrix_transform.hpp>
+
+#include <assimp\scene.h>
+
+// CPU-side geometry kernels on the model load and render paths.
+// None of these touch GL, so they can be timed without a context.
+
+struct BoundingBox
+{
+	glm::vec3 center;
+	glm::vec3 extent;	// half size along each axis
+};
+
+struct BoundingSphere
+{
+	glm::vec3 center;
+	float radius;
+};
+
+void calcAverageNormals(unsigned int * indices, unsigned int indiceCount, GLfloat * vertices, unsigned int verticeCount,
+						unsigned int vLength, unsigned int normalOffset);
+
+// Packs position, uv and flipped normal per vertex into the 8-float layout Mesh::CreateMesh expects
+void InterleaveVertices(const aiMesh * mesh, std::vector<GLfloat>& vertices);
+
+// Translate, rotate about x, y, z (in degrees) then scale, as objects are placed in the scene
+glm::mat4 ComposeModelMatrix(glm::vec3 position, glm::vec3 rotation, glm::vec3 scale);
+
+// Matrix taking normals to world space for a model matrix built from scale. Under a uniform scale s the inverse
+// transpose is the model's own 3x3 over s squared, so only the general case pays for an inverse
+glm::mat3 ComposeNormalMatrix(const glm::mat4& model, glm::vec3 scale);
+
+// Box around the positions of an interleaved vertex array, and a sphere around the same centre
+void CalculateBounds(const GLfloat * vertices, size_t vertexCount, unsigned int vLength, BoundingBox& box, BoundingSphere& sphere);
+
+// Smallest axis-aligned box holding the transformed box
+BoundingBox TransformBoundingBox(const BoundingBox& box, const glm::mat4& transform);
+BoundingBox MergeBoundingBoxes(const BoundingBox& a, const BoundingBox& b);
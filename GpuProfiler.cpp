@@ -0,0 +1,243 @@
+#include "GpuProfiler.h"
+
+#include <fstream>
+#include <cfloat>
+
+GpuProfiler::GpuProfiler()
+{
+	activeZone = -1;
+	frameIndex = 0;
+	currentSlot = 0;
+
+	frameHistory.resize(GPU_PROFILER_HISTORY, 0.0f);
+	frameNumbers.resize(GPU_PROFILER_HISTORY, 0);
+	historyHead = 0;
+	historyCount = 0;
+	lastFrameTime = 0.0f;
+
+	paused = false;
+	hitchThreshold = 16.6f;
+}
+
+void GpuProfiler::BeginFrame()
+{
+	currentSlot = frameIndex % GPU_PROFILER_FRAMES;
+
+	// The slot about to be reused was issued GPU_PROFILER_FRAMES frames ago, so its results are normally ready
+	if (frameIndex >= GPU_PROFILER_FRAMES)
+	{
+		ResolveSlot(currentSlot, frameIndex - GPU_PROFILER_FRAMES);
+	}
+
+	frameIndex++;
+}
+
+void GpuProfiler::BeginZone(const std::string& name)
+{
+	int zone = FindZone(name);
+
+	if (zone < 0)
+	{
+		GpuZone newZone;
+		newZone.name = name;
+		glGenQueries(GPU_PROFILER_FRAMES, newZone.queries);
+		for (size_t i = 0; i < GPU_PROFILER_FRAMES; i++)
+		{
+			newZone.issued[i] = false;
+		}
+		newZone.lastTime = 0.0f;
+		newZone.history.resize(GPU_PROFILER_HISTORY, 0.0f);
+
+		zones.push_back(newZone);
+		zone = zones.size() - 1;
+	}
+
+	// A zone can only be timed once per frame, and GL_TIME_ELAPSED queries cannot nest
+	if (activeZone >= 0 || zones[zone].issued[currentSlot])
+	{
+		return;
+	}
+
+	glBeginQuery(GL_TIME_ELAPSED, zones[zone].queries[currentSlot]);
+	activeZone = zone;
+}
+
+void GpuProfiler::EndZone()
+{
+	if (activeZone < 0)
+	{
+		return;
+	}
+
+	glEndQuery(GL_TIME_ELAPSED);
+	zones[activeZone].issued[currentSlot] = true;
+	activeZone = -1;
+}
+
+void GpuProfiler::ResolveSlot(int slot, unsigned int resolvedFrame)
+{
+	float frameTime = 0.0f;
+
+	for (size_t i = 0; i < zones.size(); i++)
+	{
+		GpuZone& zone = zones[i];
+		float time = 0.0f;
+
+		if (zone.issued[slot])
+		{
+			// Never wait on the GPU: a result that isn't ready yet is dropped and the last value is kept
+			GLint available = 0;
+			glGetQueryObjectiv(zone.queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+
+			if (available)
+			{
+				GLuint64 elapsed = 0;
+				glGetQueryObjectui64v(zone.queries[slot], GL_QUERY_RESULT, &elapsed);
+				zone.lastTime = elapsed / 1000000.0f;
+			}
+
+			time = zone.lastTime;
+			zone.issued[slot] = false;
+		}
+
+		frameTime += time;
+
+		if (!paused)
+		{
+			zone.history[historyHead] = time;
+		}
+	}
+
+	lastFrameTime = frameTime;
+
+	if (!paused)
+	{
+		frameHistory[historyHead] = frameTime;
+		frameNumbers[historyHead] = resolvedFrame;
+		historyHead = (historyHead + 1) % GPU_PROFILER_HISTORY;
+		if (historyCount < GPU_PROFILER_HISTORY) historyCount++;
+	}
+}
+
+void GpuProfiler::PlotWithHitches(const char* label, std::vector<float>& values, const char* overlay, float height)
+{
+	ImGui::PlotLines(label, values.data(), GPU_PROFILER_HISTORY, historyHead, overlay, 0.0f, FLT_MAX, ImVec2(0, height));
+
+	// Mark frames over the hitch threshold on top of the plot
+	ImVec2 plotMin = ImGui::GetItemRectMin();
+	ImVec2 plotMax = ImGui::GetItemRectMax();
+	ImVec2 padding = ImGui::GetStyle().FramePadding;
+	float plotWidth = ImGui::CalcItemWidth() - padding.x * 2.0f;
+	float step = plotWidth / (GPU_PROFILER_HISTORY - 1);
+
+	ImDrawList* drawList = ImGui::GetWindowDrawList();
+	for (int i = 0; i < GPU_PROFILER_HISTORY; i++)
+	{
+		if (frameHistory[(historyHead + i) % GPU_PROFILER_HISTORY] > hitchThreshold)
+		{
+			float x = plotMin.x + padding.x + i * step;
+			drawList->AddLine(ImVec2(x, plotMin.y + padding.y), ImVec2(x, plotMax.y - padding.y), IM_COL32(255, 64, 64, 160));
+		}
+	}
+}
+
+void GpuProfiler::DrawOverlay(bool* open)
+{
+	if (ImGui::Begin("Frame profiler", open))
+	{
+		ImGui::Checkbox("Pause", &paused);
+		ImGui::SameLine();
+		if (ImGui::Button("Export CSV"))
+		{
+			ExportCSV("frame_profile.csv");
+		}
+
+		ImGui::DragFloat("Hitch threshold (ms)", &hitchThreshold, 0.1f, 0.1f, 1000.0f);
+
+		char overlay[64];
+		snprintf(overlay, sizeof(overlay), "GPU frame %.3f ms", lastFrameTime);
+		PlotWithHitches("Total", frameHistory, overlay, 80.0f);
+
+		for (size_t i = 0; i < zones.size(); i++)
+		{
+			float average = 0.0f, maximum = 0.0f;
+			for (int j = 0; j < historyCount; j++)
+			{
+				int index = (historyHead - 1 - j + GPU_PROFILER_HISTORY) % GPU_PROFILER_HISTORY;
+				average += zones[i].history[index];
+				if (zones[i].history[index] > maximum) maximum = zones[i].history[index];
+			}
+			if (historyCount > 0) average /= historyCount;
+
+			snprintf(overlay, sizeof(overlay), "%.3f ms (avg %.3f, max %.3f)", zones[i].lastTime, average, maximum);
+			PlotWithHitches(zones[i].name.c_str(), zones[i].history, overlay, 40.0f);
+		}
+	}
+	ImGui::End();
+}
+
+bool GpuProfiler::ExportCSV(const char* fileLocation)
+{
+	std::ofstream fileStream(fileLocation, std::ios::out);
+
+	if (!fileStream.is_open())
+	{
+		printf("Failed to write %s!\n", fileLocation);
+		return false;
+	}
+
+	fileStream << "frame";
+	for (size_t i = 0; i < zones.size(); i++)
+	{
+		fileStream << "," << zones[i].name;
+	}
+	fileStream << ",total\n";
+
+	// Oldest frame first
+	for (int j = historyCount - 1; j >= 0; j--)
+	{
+		int index = (historyHead - 1 - j + GPU_PROFILER_HISTORY) % GPU_PROFILER_HISTORY;
+
+		fileStream << frameNumbers[index];
+		for (size_t i = 0; i < zones.size(); i++)
+		{
+			fileStream << "," << zones[i].history[index];
+		}
+		fileStream << "," << frameHistory[index] << "\n";
+	}
+
+	fileStream.close();
+	printf("Wrote %d frames to %s\n", historyCount, fileLocation);
+	return true;
+}
+
+int GpuProfiler::FindZone(const std::string& name)
+{
+	for (size_t i = 0; i < zones.size(); i++)
+	{
+		if (zones[i].name == name)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+void GpuProfiler::ClearProfiler()
+{
+	for (size_t i = 0; i < zones.size(); i++)
+	{
+		glDeleteQueries(GPU_PROFILER_FRAMES, zones[i].queries);
+	}
+
+	zones.clear();
+	activeZone = -1;
+	historyHead = 0;
+	historyCount = 0;
+}
+
+GpuProfiler::~GpuProfiler()
+{
+	ClearProfiler();
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include <GL\glew.h>
+
+#include "imgui\imgui.h"
+
+// Query sets in flight; a zone's result is read back this many frames after it was issued
+const int GPU_PROFILER_FRAMES = 2;
+// Frames of history kept for the graph and the CSV export
+const int GPU_PROFILER_HISTORY = 600;
+
+// Times render passes on the GPU with GL_TIME_ELAPSED queries.
+// Zones may not nest, since only one GL_TIME_ELAPSED query can be active at a time.
+class GpuProfiler
+{
+public:
+	GpuProfiler();
+
+	void BeginFrame();
+
+	void BeginZone(const std::string& name);
+	void EndZone();
+
+	size_t GetZoneCount() { return zones.size(); }
+	const std::string& GetZoneName(size_t zone) { return zones[zone].name; }
+	float GetLastTime(size_t zone) { return zones[zone].lastTime; }
+	float GetLastFrameTime() { return lastFrameTime; }
+
+	void DrawOverlay(bool* open);
+	bool ExportCSV(const char* fileLocation);
+
+	void ClearProfiler();
+
+	~GpuProfiler();
+
+private:
+	struct GpuZone
+	{
+		std::string name;
+		GLuint queries[GPU_PROFILER_FRAMES];
+		bool issued[GPU_PROFILER_FRAMES];
+		float lastTime;
+		std::vector<float> history;
+	};
+
+	std::vector<GpuZone> zones;
+	int activeZone;
+
+	unsigned int frameIndex;
+	int currentSlot;
+
+	std::vector<float> frameHistory;
+	std::vector<unsigned int> frameNumbers;
+	int historyHead, historyCount;
+	float lastFrameTime;
+
+	bool paused;
+	float hitchThreshold;
+
+	int FindZone(const std::string& name);
+	void ResolveSlot(int slot, unsigned int resolvedFrame);
+	void PlotWithHitches(const char* label, std::vector<float>& values, const char* overlay, float height);
+};
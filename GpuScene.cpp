@@ -0,0 +1,462 @@
+#include "GpuScene.h"
+
+#include <algorithm>
+#include <climits>
+
+#include <glm\gtc\type_ptr.hpp>
+
+#include "Object.h"
+#include "Mesh.h"
+#include "TransformPool.h"
+#include "CpuProfiler.h"
+
+// Culling modes and storage buffer bindings, matching the GLSL side
+static const GLint CULL_MODE_NONE = 0;
+static const GLint CULL_MODE_FRUSTUM = 1;
+static const GLint CULL_MODE_SPHERE = 2;
+static const GLuint CULL_GROUP_SIZE = 64;
+
+static const GLuint TRANSFORM_BINDING = 0;
+static const GLuint BOUNDS_BINDING = 1;
+static const GLuint COMMAND_BINDING = 2;
+
+static const GLuint OBJECT_INDEX_LOCATION = 3;
+static const GLsizei VERTEX_STRIDE = sizeof(GLfloat) * 8;
+
+// Shared buffers start here and double, so loading many small models doesn't reallocate each time
+static const GLsizeiptr MIN_BUFFER_SIZE = 1 << 20;
+
+GLuint GpuScene::vertexArray = 0;
+GLuint GpuScene::vertexBuffer = 0;
+GLuint GpuScene::indexBuffer = 0;
+GLsizeiptr GpuScene::vertexCapacity = 0;
+GLsizeiptr GpuScene::vertexUsed = 0;
+GLsizeiptr GpuScene::indexCapacity = 0;
+GLsizeiptr GpuScene::indexUsed = 0;
+std::vector<SceneMeshRange> GpuScene::meshRanges;
+unsigned int GpuScene::liveMeshes = 0;
+
+GLuint GpuScene::transformBuffer = 0;
+GLuint GpuScene::objectIndexBuffer = 0;
+size_t GpuScene::transformCapacity = 0;
+std::vector<unsigned int> GpuScene::dirtySlots;
+std::vector<ObjectTransform> GpuScene::transformStaging;
+
+GLuint GpuScene::commandBuffer = 0;
+GLuint GpuScene::boundsBuffer = 0;
+std::vector<DrawElementsIndirectCommand> GpuScene::commands;
+std::vector<SceneDrawGroup> GpuScene::groups;
+unsigned long long GpuScene::submittedTriangleCount = 0;
+unsigned int GpuScene::builtVersion = UINT_MAX;
+bool GpuScene::commandsCulled = false;
+
+Shader GpuScene::cullProgram;
+GLint GpuScene::uniformCullMode = -1;
+GLint GpuScene::uniformPlanes = -1;
+GLint GpuScene::uniformSphere = -1;
+GLint GpuScene::uniformCommandCount = -1;
+
+// One indirect command while the list is sorted by texture
+struct SceneDrawEntry
+{
+	Texture* texture;
+	DrawElementsIndirectCommand command;
+	BoundingBox bounds;
+};
+
+// Reallocates buffer to hold at least required bytes, keeping its first used bytes
+static void GrowBuffer(GLuint& buffer, GLsizeiptr& capacity, GLsizeiptr used, GLsizeiptr required)
+{
+	if (required <= capacity)
+	{
+		return;
+	}
+
+	GLsizeiptr newCapacity = std::max(required, std::max(capacity * 2, MIN_BUFFER_SIZE));
+
+	GLuint newBuffer = 0;
+	glGenBuffers(1, &newBuffer);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, newBuffer);
+	glBufferData(GL_COPY_WRITE_BUFFER, newCapacity, nullptr, GL_STATIC_DRAW);
+
+	if (buffer != 0)
+	{
+		if (used > 0)
+		{
+			glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, used);
+			glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		}
+		glDeleteBuffers(1, &buffer);
+	}
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	buffer = newBuffer;
+	capacity = newCapacity;
+}
+
+static ObjectTransform PackTransform(unsigned int slot)
+{
+	ObjectTransform transform;
+	transform.worldMatrix = TransformPool::GetWorldMatrix(slot);
+	transform.normalMatrix = glm::mat4(TransformPool::GetNormalMatrix(slot));
+	return transform;
+}
+
+bool GpuScene::IsSupported()
+{
+	return GLEW_VERSION_4_3;
+}
+
+bool GpuScene::Init()
+{
+	if (!IsSupported())
+	{
+		return false;
+	}
+
+	cullProgram.CreateComputeFromFile("Shaders/cull_draws.comp");
+
+	uniformCullMode = cullProgram.GetUniformLocation("cullMode");
+	uniformPlanes = cullProgram.GetUniformLocation("planes");
+	uniformSphere = cullProgram.GetUniformLocation("sphere");
+	uniformCommandCount = cullProgram.GetUniformLocation("commandCount");
+
+	return true;
+}
+
+int GpuScene::AddMesh(const GLfloat* vertices, unsigned int numOfVertices, const unsigned int* indices, unsigned int numOfIndices)
+{
+	if (!IsSupported())
+	{
+		return -1;
+	}
+
+	// Freed ranges aren't reused one by one, the buffers start over once every mesh is gone
+	if (liveMeshes == 0)
+	{
+		vertexUsed = 0;
+		indexUsed = 0;
+		meshRanges.clear();
+	}
+
+	GLsizeiptr vertexBytes = sizeof(vertices[0]) * numOfVertices;
+	GLsizeiptr indexBytes = sizeof(indices[0]) * numOfIndices;
+
+	GLuint previousVertexBuffer = vertexBuffer;
+	GLuint previousIndexBuffer = indexBuffer;
+	GrowBuffer(vertexBuffer, vertexCapacity, vertexUsed, vertexUsed + vertexBytes);
+	GrowBuffer(indexBuffer, indexCapacity, indexUsed, indexUsed + indexBytes);
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, vertexBuffer);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, vertexUsed, vertexBytes, vertices);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, indexBuffer);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, indexUsed, indexBytes, indices);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	// Indices stay relative to the mesh, baseVertex offsets them at draw time
+	SceneMeshRange range;
+	range.firstIndex = indexUsed / sizeof(indices[0]);
+	range.indexCount = numOfIndices;
+	range.baseVertex = vertexUsed / VERTEX_STRIDE;
+
+	vertexUsed += vertexBytes;
+	indexUsed += indexBytes;
+
+	if (vertexBuffer != previousVertexBuffer || indexBuffer != previousIndexBuffer)
+	{
+		SetupVertexArray();
+	}
+
+	meshRanges.push_back(range);
+	liveMeshes++;
+
+	return (int)meshRanges.size() - 1;
+}
+
+void GpuScene::RemoveMesh(int range)
+{
+	if (range < 0)
+	{
+		return;
+	}
+
+	liveMeshes--;
+}
+
+void GpuScene::SetupVertexArray()
+{
+	// Waits for both the geometry and the object indices
+	if (vertexBuffer == 0 || objectIndexBuffer == 0)
+	{
+		return;
+	}
+
+	if (vertexArray == 0)
+	{
+		glGenVertexArrays(1, &vertexArray);
+	}
+
+	glBindVertexArray(vertexArray);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+
+	glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, VERTEX_STRIDE, 0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, VERTEX_STRIDE, (void*)(sizeof(GLfloat) * 3));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, VERTEX_STRIDE, (void*)(sizeof(GLfloat) * 5));
+	glEnableVertexAttribArray(2);
+
+	// GL 4.3 shaders can't read baseInstance, a per-instance attribute over 0, 1, 2... hands it over instead
+	glBindBuffer(GL_ARRAY_BUFFER, objectIndexBuffer);
+	glVertexAttribIPointer(OBJECT_INDEX_LOCATION, 1, GL_UNSIGNED_INT, sizeof(GLuint), 0);
+	glEnableVertexAttribArray(OBJECT_INDEX_LOCATION);
+	glVertexAttribDivisor(OBJECT_INDEX_LOCATION, 1);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void GpuScene::Update(const std::vector<Object*>& objects)
+{
+	PROFILE_ZONE("GpuScene::Update");
+
+	UploadTransforms();
+
+	if (Object::GetSceneVersion() != builtVersion)
+	{
+		BuildCommands(objects);
+		builtVersion = Object::GetSceneVersion();
+	}
+}
+
+void GpuScene::UploadTransforms()
+{
+	size_t slotCount = TransformPool::GetSlotCount();
+	TransformPool::TakeDirtySlots(dirtySlots);
+
+	if (slotCount == 0)
+	{
+		return;
+	}
+
+	bool uploadAll = false;
+
+	if (slotCount > transformCapacity)
+	{
+		transformCapacity = std::max(slotCount, transformCapacity * 2);
+
+		if (transformBuffer == 0)
+		{
+			glGenBuffers(1, &transformBuffer);
+		}
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, transformBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(ObjectTransform) * transformCapacity, nullptr, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+		std::vector<GLuint> objectIndices(transformCapacity);
+		for (size_t i = 0; i < transformCapacity; i++)
+		{
+			objectIndices[i] = (GLuint)i;
+		}
+
+		bool createdIndices = objectIndexBuffer == 0;
+		if (createdIndices)
+		{
+			glGenBuffers(1, &objectIndexBuffer);
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, objectIndexBuffer);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(GLuint) * transformCapacity, objectIndices.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		if (createdIndices)
+		{
+			SetupVertexArray();
+		}
+
+		uploadAll = true;
+	}
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, transformBuffer);
+
+	// Past a quarter of the pool one upload beats many small ones
+	if (uploadAll || dirtySlots.size() > slotCount / 4)
+	{
+		transformStaging.resize(slotCount);
+		for (size_t i = 0; i < slotCount; i++)
+		{
+			transformStaging[i] = PackTransform(i);
+		}
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(ObjectTransform) * slotCount, transformStaging.data());
+	}
+	else
+	{
+		for (unsigned int slot : dirtySlots)
+		{
+			ObjectTransform transform = PackTransform(slot);
+			glBufferSubData(GL_SHADER_STORAGE_BUFFER, sizeof(ObjectTransform) * slot, sizeof(ObjectTransform), &transform);
+		}
+	}
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void GpuScene::BuildCommands(const std::vector<Object*>& objects)
+{
+	PROFILE_ZONE("GpuScene::BuildCommands");
+
+	std::vector<SceneDrawEntry> entries;
+
+	for (Object* object : objects)
+	{
+		Model* model = object->getModel();
+		if (!model)
+		{
+			continue;
+		}
+
+		for (size_t mesh = 0; mesh < model->GetMeshCount(); mesh++)
+		{
+			int range = model->GetMeshRange(mesh);
+			if (range < 0)
+			{
+				continue;
+			}
+
+			SceneDrawEntry entry;
+			entry.texture = model->GetMeshTexture(mesh);
+			entry.command.count = meshRanges[range].indexCount;
+			entry.command.instanceCount = 1;
+			entry.command.firstIndex = meshRanges[range].firstIndex;
+			entry.command.baseVertex = meshRanges[range].baseVertex;
+			entry.command.baseInstance = object->getTransformSlot();
+			entry.bounds = model->GetMeshBoundingBox(mesh);
+			entries.push_back(entry);
+		}
+	}
+
+	// Commands sharing a texture become one draw call in the main pass
+	std::stable_sort(entries.begin(), entries.end(), [](const SceneDrawEntry& a, const SceneDrawEntry& b) { return a.texture < b.texture; });
+
+	commands.clear();
+	groups.clear();
+	submittedTriangleCount = 0;
+
+	// Two vec4s per command: model-space center, then extent
+	std::vector<glm::vec4> bounds;
+	bounds.reserve(entries.size() * 2);
+
+	for (const SceneDrawEntry& entry : entries)
+	{
+		if (groups.empty() || groups.back().texture != entry.texture)
+		{
+			groups.push_back({ entry.texture, (GLuint)commands.size(), 0 });
+		}
+		groups.back().commandCount++;
+
+		commands.push_back(entry.command);
+		bounds.push_back(glm::vec4(entry.bounds.center, 0.0f));
+		bounds.push_back(glm::vec4(entry.bounds.extent, 0.0f));
+		submittedTriangleCount += entry.command.count / 3;
+	}
+
+	if (commands.empty())
+	{
+		return;
+	}
+
+	if (commandBuffer == 0)
+	{
+		glGenBuffers(1, &commandBuffer);
+		glGenBuffers(1, &boundsBuffer);
+	}
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(DrawElementsIndirectCommand) * commands.size(), commands.data(), GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, boundsBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(glm::vec4) * bounds.size(), bounds.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	// Fresh commands draw everything
+	commandsCulled = false;
+}
+
+void GpuScene::CullCommands(const CullVolume* volume)
+{
+	// Without a volume the commands only need restoring after an earlier pass culled them
+	if (!volume && !commandsCulled)
+	{
+		return;
+	}
+
+	cullProgram.UseShader();
+
+	if (volume)
+	{
+		glUniform1i(uniformCullMode, volume->isSphere ? CULL_MODE_SPHERE : CULL_MODE_FRUSTUM);
+		glUniform4fv(uniformPlanes, 6, glm::value_ptr(volume->planes[0]));
+		glUniform4f(uniformSphere, volume->sphereCenter.x, volume->sphereCenter.y, volume->sphereCenter.z, volume->sphereRadius);
+	}
+	else
+	{
+		glUniform1i(uniformCullMode, CULL_MODE_NONE);
+	}
+	glUniform1ui(uniformCommandCount, (GLuint)commands.size());
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, TRANSFORM_BINDING, transformBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BOUNDS_BINDING, boundsBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COMMAND_BINDING, commandBuffer);
+
+	glDispatchCompute((GLuint)((commands.size() + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE), 1, 1);
+
+	// The draws read the instance counts through the indirect buffer
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+
+	commandsCulled = volume != nullptr;
+}
+
+void GpuScene::Draw(Shader* program, const CullVolume* volume, bool depthOnly)
+{
+	PROFILE_ZONE("GpuScene::Draw");
+
+	if (commands.empty() || vertexArray == 0)
+	{
+		return;
+	}
+
+	CullCommands(volume);
+
+	program->UseShader();
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, TRANSFORM_BINDING, transformBuffer);
+	glBindVertexArray(vertexArray);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+
+	if (depthOnly)
+	{
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, 0, (GLsizei)commands.size(), 0);
+		Mesh::AddRenderStats(1, submittedTriangleCount);
+	}
+	else
+	{
+		for (const SceneDrawGroup& group : groups)
+		{
+			if (group.texture)
+			{
+				group.texture->UseTexture();
+			}
+
+			glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)(sizeof(DrawElementsIndirectCommand) * group.firstCommand), group.commandCount, 0);
+		}
+		Mesh::AddRenderStats((unsigned int)groups.size(), submittedTriangleCount);
+	}
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	Mesh::Unbind();
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <vector>
+
+#include <GL\glew.h>
+
+#include <glm\glm.hpp>
+
+#include "Geometry.h"
+#include "Culling.h"
+#include "Shader.h"
+#include "Texture.h"
+
+class Object;
+
+// Layout glMultiDrawElementsIndirect reads from the indirect buffer
+struct DrawElementsIndirectCommand
+{
+	GLuint count;
+	GLuint instanceCount;
+	GLuint firstIndex;
+	GLint baseVertex;
+	GLuint baseInstance;	// the object's TransformPool slot
+};
+
+// std430 element of the transform buffer, the normal matrix is padded to four columns
+struct ObjectTransform
+{
+	glm::mat4 worldMatrix;
+	glm::mat4 normalMatrix;
+};
+
+// Where a mesh lives in the shared vertex and index buffers
+struct SceneMeshRange
+{
+	GLuint firstIndex;
+	GLuint indexCount;
+	GLint baseVertex;
+};
+
+// Draws sharing a texture, contiguous in the indirect buffer
+struct SceneDrawGroup
+{
+	Texture* texture;
+	GLuint firstCommand;
+	GLsizei commandCount;
+};
+
+// GL 4.3 copy of the scene drawn with one glMultiDrawElementsIndirect per pass (per texture in the main pass).
+// Every mesh is appended to one vertex and one index buffer, every TransformPool slot is mirrored in a storage
+// buffer, and each object mesh is an indirect command whose baseInstance selects the object's transform.
+// A compute shader can cull the commands against the pass's volume so the CPU cost no longer grows with the scene.
+class GpuScene
+{
+public:
+	// Needs multi-draw indirect, storage buffers and compute shaders
+	static bool IsSupported();
+
+	// Creates the culling program, call once the context is current
+	static bool Init();
+
+	// Copies the mesh into the shared buffers, -1 when unsupported
+	static int AddMesh(const GLfloat* vertices, unsigned int numOfVertices, const unsigned int* indices, unsigned int numOfIndices);
+	static void RemoveMesh(int range);
+
+	// Uploads the transforms changed since the last call and rebuilds the commands when objects or models changed
+	static void Update(const std::vector<Object*>& objects);
+
+	// Draws every command with program, the culling stage first zeroes the ones outside volume when given.
+	// Depth-only passes ignore textures and submit a single call
+	static void Draw(Shader* program, const CullVolume* volume, bool depthOnly);
+
+	static size_t GetCommandCount() { return commands.size(); }
+	static size_t GetGroupCount() { return groups.size(); }
+
+private:
+	static GLuint vertexArray, vertexBuffer, indexBuffer;
+	static GLsizeiptr vertexCapacity, vertexUsed, indexCapacity, indexUsed;
+	static std::vector<SceneMeshRange> meshRanges;
+	static unsigned int liveMeshes;
+
+	static GLuint transformBuffer, objectIndexBuffer;
+	static size_t transformCapacity;
+	static std::vector<unsigned int> dirtySlots;
+	static std::vector<ObjectTransform> transformStaging;
+
+	static GLuint commandBuffer, boundsBuffer;
+	static std::vector<DrawElementsIndirectCommand> commands;
+	static std::vector<SceneDrawGroup> groups;
+	// Every command's triangles, the compute cull runs on the GPU later so culled ones are included
+	static unsigned long long submittedTriangleCount;
+	static unsigned int builtVersion;
+	static bool commandsCulled;
+
+	static Shader cullProgram;
+	static GLint uniformCullMode, uniformPlanes, uniformSphere, uniformCommandCount;
+
+	static void SetupVertexArray();
+	static void UploadTransforms();
+	static void BuildCommands(const std::vector<Object*>& objects);
+	static void CullCommands(const CullVolume* volume);
+};
@@ -0,0 +1,43 @@
+#include "InstanceBuffer.h"
+
+#include <cstddef>
+
+GLuint InstanceBuffer::buffer = 0;
+
+void InstanceBuffer::BindAttributes(GLuint firstInstance)
+{
+	if (buffer == 0)
+	{
+		glGenBuffers(1, &buffer);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+	size_t base = sizeof(InstanceData) * firstInstance;
+
+	for (GLuint i = 0; i < 4; i++)
+	{
+		GLuint location = INSTANCE_ATTRIBUTE_LOCATION + i;
+		glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(base + offsetof(InstanceData, worldMatrix) + sizeof(glm::vec4) * i));
+		glVertexAttribDivisor(location, 1);
+		glEnableVertexAttribArray(location);
+	}
+
+	for (GLuint i = 0; i < 3; i++)
+	{
+		GLuint location = INSTANCE_ATTRIBUTE_LOCATION + 4 + i;
+		glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(base + offsetof(InstanceData, normalMatrix) + sizeof(glm::vec3) * i));
+		glVertexAttribDivisor(location, 1);
+		glEnableVertexAttribArray(location);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstanceBuffer::Upload(const InstanceData* instances, size_t count)
+{
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	// Respecifying the whole store lets the driver hand out fresh memory while earlier batches are still drawing
+	glBufferData(GL_ARRAY_BUFFER, sizeof(InstanceData) * count, instances, GL_STREAM_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <GL\glew.h>
+
+#include <glm\glm.hpp>
+
+// First vertex attribute of the per-instance data: the world matrix takes four locations, the normal matrix three
+const GLuint INSTANCE_ATTRIBUTE_LOCATION = 3;
+
+struct InstanceData
+{
+	glm::mat4 worldMatrix;
+	glm::mat3 normalMatrix;
+};
+
+// Per-instance attributes for instanced draws. Every mesh VAO reads them from this one buffer,
+// which is refilled once per pass with the instances of every batch.
+class InstanceBuffer
+{
+public:
+	// Points the instance attributes of the bound VAO at the buffer, from firstInstance on
+	static void BindAttributes(GLuint firstInstance);
+
+	static void Upload(const InstanceData* instances, size_t count);
+
+private:
+	static GLuint buffer;
+};
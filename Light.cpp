@@ -1,22 +1,34 @@
-#include "Light.h"
-
-Light::Light()
-{
-	colour = glm::vec3(1.0f, 1.0f, 1.0f);
-	ambientIntensity = 1.0f;
-	diffuseIntensity = 0.0f;
-}
-
-Light::Light(GLuint shadowWidth, GLuint shadowHeight, GLfloat red, GLfloat green, GLfloat blue, GLfloat aIntensity, GLfloat dIntensity)
-{
-	colour = glm::vec3(red, green, blue);
-	ambientIntensity = aIntensity;
-	diffuseIntensity = dIntensity;
-
-	shadowMap = new ShadowMap();
-	shadowMap->Init(shadowWidth, shadowHeight);
-}
-
-Light::~Light()
-{
-}
+#include "Light.h"
+
+Light::Light()
+{
+	colour = glm::vec3(1.0f, 1.0f, 1.0f);
+	ambientIntensity = 1.0f;
+	diffuseIntensity = 0.0f;
+
+	shadowMap = nullptr;
+	shadowSize = 0;
+	shadowAllocation = {};
+}
+
+Light::Light(GLuint shadowWidth, GLuint shadowHeight, GLfloat red, GLfloat green, GLfloat blue, GLfloat aIntensity, GLfloat dIntensity)
+{
+	colour = glm::vec3(red, green, blue);
+	ambientIntensity = aIntensity;
+	diffuseIntensity = dIntensity;
+
+	shadowMap = nullptr;
+	shadowSize = shadowWidth;
+	shadowAllocation = {};
+}
+
+void Light::FillBaseData(LightData& data)
+{
+	data.colour = colour;
+	data.ambientIntensity = ambientIntensity;
+	data.diffuseIntensity = diffuseIntensity;
+}
+
+Light::~Light()
+{
+}
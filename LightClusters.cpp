@@ -0,0 +1,283 @@
+#include "LightClusters.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "CpuProfiler.h"
+
+static bool SphereTouchesBox(const glm::vec3& center, float radius, const glm::vec3& boxMin, const glm::vec3& boxMax)
+{
+	glm::vec3 closest = glm::max(boxMin, glm::min(center, boxMax));
+	glm::vec3 offset = closest - center;
+	return glm::dot(offset, offset) <= radius * radius;
+}
+
+static int ClusterTile(float ndc, int tiles)
+{
+	return std::max(0, std::min((int)((ndc * 0.5f + 0.5f) * tiles), tiles - 1));
+}
+
+LightClusters::LightClusters()
+{
+	lightBuffer = 0;
+	clusterBuffer = 0;
+	indexBuffer = 0;
+	lightTexture = 0;
+	clusterTexture = 0;
+	indexTexture = 0;
+	lightCapacity = 0;
+	indexCapacity = 0;
+
+	clusterWidth = 0;
+	clusterHeight = 0;
+	nearPlane = 0.1f;
+	farPlane = 100.0f;
+	clusterScale = glm::vec4(0.0f);
+
+	stats = { 0, 0, 0 };
+}
+
+void LightClusters::Init()
+{
+	glGenBuffers(1, &lightBuffer);
+	glGenBuffers(1, &clusterBuffer);
+	glGenBuffers(1, &indexBuffer);
+	glGenTextures(1, &lightTexture);
+	glGenTextures(1, &clusterTexture);
+	glGenTextures(1, &indexTexture);
+
+	// Never empty, so the textures always have a store to fetch from
+	lightCapacity = 64 * sizeof(ClusterLightData);
+	indexCapacity = 1024 * sizeof(GLuint);
+	GLsizeiptr clusterSize = CLUSTER_COUNT * 2 * sizeof(GLuint);
+
+	struct { GLuint buffer, texture; GLenum format; GLsizeiptr size; } stores[] = {
+		{ lightBuffer, lightTexture, GL_RGBA32F, lightCapacity },
+		{ clusterBuffer, clusterTexture, GL_RG32UI, clusterSize },
+		{ indexBuffer, indexTexture, GL_R32UI, indexCapacity }
+	};
+
+	for (const auto& store : stores)
+	{
+		glBindBuffer(GL_TEXTURE_BUFFER, store.buffer);
+		glBufferData(GL_TEXTURE_BUFFER, store.size, nullptr, GL_DYNAMIC_DRAW);
+
+		glBindTexture(GL_TEXTURE_BUFFER, store.texture);
+		glTexBuffer(GL_TEXTURE_BUFFER, store.format, store.buffer);
+	}
+
+	glBindTexture(GL_TEXTURE_BUFFER, 0);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+	clusterRanges.assign(CLUSTER_COUNT * 2, 0);
+	clusterCounts.assign(CLUSTER_COUNT, 0);
+}
+
+void LightClusters::Clear()
+{
+	lights.clear();
+}
+
+void LightClusters::AddPointLight(PointLight* light, int shadowIndex)
+{
+	ClusterLightData data;
+	light->FillLightData(data);
+	data.shadowIndex = (GLfloat)shadowIndex;
+	lights.push_back(data);
+}
+
+void LightClusters::AddSpotLight(SpotLight* light, int shadowIndex)
+{
+	ClusterLightData data;
+	light->FillLightData(data);
+	data.shadowIndex = (GLfloat)shadowIndex;
+	lights.push_back(data);
+}
+
+void LightClusters::UpdateClusterBounds(const glm::mat4& projection, GLuint viewportWidth, GLuint viewportHeight)
+{
+	clusterProjection = projection;
+	clusterWidth = viewportWidth;
+	clusterHeight = viewportHeight;
+
+	// Planes of a GL perspective projection
+	nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+	farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+
+	float sliceScale = CLUSTER_GRID_Z / logf(farPlane / nearPlane);
+	clusterScale = glm::vec4((float)CLUSTER_GRID_X / viewportWidth, (float)CLUSTER_GRID_Y / viewportHeight,
+		sliceScale, -sliceScale * logf(nearPlane));
+
+	clusterMin.resize(CLUSTER_COUNT);
+	clusterMax.resize(CLUSTER_COUNT);
+
+	for (int z = 0; z < CLUSTER_GRID_Z; z++)
+	{
+		float nearDepth = nearPlane * powf(farPlane / nearPlane, (float)z / CLUSTER_GRID_Z);
+		float farDepth = nearPlane * powf(farPlane / nearPlane, (float)(z + 1) / CLUSTER_GRID_Z);
+
+		for (int y = 0; y < CLUSTER_GRID_Y; y++)
+		{
+			float bottom = -1.0f + 2.0f * y / CLUSTER_GRID_Y;
+			float top = -1.0f + 2.0f * (y + 1) / CLUSTER_GRID_Y;
+
+			for (int x = 0; x < CLUSTER_GRID_X; x++)
+			{
+				float left = -1.0f + 2.0f * x / CLUSTER_GRID_X;
+				float right = -1.0f + 2.0f * (x + 1) / CLUSTER_GRID_X;
+
+				// The tile's edges fan out with depth, so the box spans both ends of the slice
+				float xs[4] = { left * nearDepth, left * farDepth, right * nearDepth, right * farDepth };
+				float ys[4] = { bottom * nearDepth, bottom * farDepth, top * nearDepth, top * farDepth };
+
+				int cluster = (z * CLUSTER_GRID_Y + y) * CLUSTER_GRID_X + x;
+				clusterMin[cluster] = glm::vec3(*std::min_element(xs, xs + 4) / projection[0][0],
+					*std::min_element(ys, ys + 4) / projection[1][1], -farDepth);
+				clusterMax[cluster] = glm::vec3(*std::max_element(xs, xs + 4) / projection[0][0],
+					*std::max_element(ys, ys + 4) / projection[1][1], -nearDepth);
+			}
+		}
+	}
+}
+
+void LightClusters::Build(const glm::mat4& view, const glm::mat4& projection, GLuint viewportWidth, GLuint viewportHeight)
+{
+	PROFILE_ZONE("LightClusters::Build");
+
+	if (clusterMin.empty() || projection != clusterProjection || viewportWidth != clusterWidth || viewportHeight != clusterHeight)
+	{
+		UpdateClusterBounds(projection, viewportWidth, viewportHeight);
+	}
+
+	pairs.clear();
+	std::fill(clusterCounts.begin(), clusterCounts.end(), 0);
+
+	for (GLuint i = 0; i < lights.size(); i++)
+	{
+		const ClusterLightData& light = lights[i];
+		if (light.range <= 0.0f)
+		{
+			continue;
+		}
+
+		glm::vec3 center = glm::vec3(view * glm::vec4(light.position, 1.0f));
+		float radius = light.range;
+
+		float nearDepth = -center.z - radius;
+		float farDepth = -center.z + radius;
+		if (farDepth < nearPlane || nearDepth > farPlane)
+		{
+			continue;
+		}
+
+		int z0 = nearDepth <= nearPlane ? 0 : (int)(logf(nearDepth / nearPlane) * clusterScale.z);
+		int z1 = std::min((int)(logf(std::min(farDepth, farPlane) / nearPlane) * clusterScale.z), CLUSTER_GRID_Z - 1);
+
+		// Tiles under the projection of the sphere's view space box, every tile once it reaches the near plane
+		int x0 = 0, x1 = CLUSTER_GRID_X - 1;
+		int y0 = 0, y1 = CLUSTER_GRID_Y - 1;
+		if (nearDepth > nearPlane)
+		{
+			float xs[4] = { (center.x - radius) / nearDepth, (center.x - radius) / farDepth, (center.x + radius) / nearDepth, (center.x + radius) / farDepth };
+			float ys[4] = { (center.y - radius) / nearDepth, (center.y - radius) / farDepth, (center.y + radius) / nearDepth, (center.y + radius) / farDepth };
+
+			x0 = ClusterTile(*std::min_element(xs, xs + 4) * projection[0][0], CLUSTER_GRID_X);
+			x1 = ClusterTile(*std::max_element(xs, xs + 4) * projection[0][0], CLUSTER_GRID_X);
+			y0 = ClusterTile(*std::min_element(ys, ys + 4) * projection[1][1], CLUSTER_GRID_Y);
+			y1 = ClusterTile(*std::max_element(ys, ys + 4) * projection[1][1], CLUSTER_GRID_Y);
+		}
+
+		for (int z = z0; z <= z1; z++)
+		{
+			for (int y = y0; y <= y1; y++)
+			{
+				for (int x = x0; x <= x1; x++)
+				{
+					GLuint cluster = (z * CLUSTER_GRID_Y + y) * CLUSTER_GRID_X + x;
+					if (SphereTouchesBox(center, radius, clusterMin[cluster], clusterMax[cluster]))
+					{
+						pairs.push_back(cluster);
+						pairs.push_back(i);
+						clusterCounts[cluster]++;
+					}
+				}
+			}
+		}
+	}
+
+	// Counting sort of the overlaps by cluster, the count doubles as the fill cursor
+	GLuint offset = 0;
+	stats.maxClusterLights = 0;
+	for (int cluster = 0; cluster < CLUSTER_COUNT; cluster++)
+	{
+		clusterRanges[cluster * 2] = offset;
+		clusterRanges[cluster * 2 + 1] = 0;
+		offset += clusterCounts[cluster];
+		stats.maxClusterLights = std::max(stats.maxClusterLights, clusterCounts[cluster]);
+	}
+
+	lightIndices.resize(std::max(offset, 1u));
+	for (size_t i = 0; i < pairs.size(); i += 2)
+	{
+		GLuint* range = &clusterRanges[pairs[i] * 2];
+		lightIndices[range[0] + range[1]++] = pairs[i + 1];
+	}
+
+	stats.lights = (unsigned int)lights.size();
+	stats.references = offset;
+
+	if (!lights.empty())
+	{
+		Upload(lightBuffer, lightTexture, GL_RGBA32F, lightCapacity, lights.data(), lights.size() * sizeof(ClusterLightData));
+	}
+	GLsizeiptr clusterSize = clusterRanges.size() * sizeof(GLuint);
+	Upload(clusterBuffer, clusterTexture, GL_RG32UI, clusterSize, clusterRanges.data(), clusterSize);
+	Upload(indexBuffer, indexTexture, GL_R32UI, indexCapacity, lightIndices.data(), lightIndices.size() * sizeof(GLuint));
+}
+
+void LightClusters::Upload(GLuint buffer, GLuint texture, GLenum format, GLsizeiptr& capacity, const void* data, GLsizeiptr size)
+{
+	glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+
+	if (size > capacity)
+	{
+		// Grow with headroom, and point the texture at the new store
+		capacity = size + size / 2;
+		glBufferData(GL_TEXTURE_BUFFER, capacity, nullptr, GL_DYNAMIC_DRAW);
+
+		glBindTexture(GL_TEXTURE_BUFFER, texture);
+		glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
+		glBindTexture(GL_TEXTURE_BUFFER, 0);
+	}
+
+	glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightClusters::FillLightsData(LightsBlock& data)
+{
+	data.clusterGrid = glm::ivec4(CLUSTER_GRID_X, CLUSTER_GRID_Y, CLUSTER_GRID_Z, 0);
+	data.clusterScale = clusterScale;
+}
+
+void LightClusters::Read(GLenum textureUnit)
+{
+	GLuint textures[] = { lightTexture, clusterTexture, indexTexture };
+	for (GLenum i = 0; i < 3; i++)
+	{
+		glActiveTexture(textureUnit + i);
+		glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+	}
+}
+
+LightClusters::~LightClusters()
+{
+	GLuint buffers[] = { lightBuffer, clusterBuffer, indexBuffer };
+	GLuint textures[] = { lightTexture, clusterTexture, indexTexture };
+
+	if (lightBuffer)
+	{
+		glDeleteBuffers(3, buffers);
+		glDeleteTextures(3, textures);
+	}
+}
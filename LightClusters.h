@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+
+#include <GL\glew.h>
+
+#include <glm\glm.hpp>
+
+#include "UniformBlocks.h"
+#include "PointLight.h"
+#include "SpotLight.h"
+
+// Froxels: screen tiles split into depth slices spaced exponentially between the camera's near and far planes
+const int CLUSTER_GRID_X = 16;
+const int CLUSTER_GRID_Y = 9;
+const int CLUSTER_GRID_Z = 24;
+const int CLUSTER_COUNT = CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z;
+
+struct LightClusterStats
+{
+	unsigned int lights;
+	unsigned int references;		// light indices over every cluster
+	unsigned int maxClusterLights;
+};
+
+// Assigns point and spot lights to the froxels their range reaches, so the main shaders only loop over the
+// lights of the fragment's cluster instead of every light in the scene. Built on the CPU each frame and read through
+// buffer textures: the lights, an offset and count per cluster, and the clusters' light indices back to back.
+class LightClusters
+{
+public:
+	LightClusters();
+
+	// Creates the buffers and textures, call once the context is current
+	void Init();
+
+	// Lights are gathered from scratch each frame, shadowIndex is the light's ShadowTransforms slot or -1
+	void Clear();
+	void AddPointLight(PointLight* light, int shadowIndex);
+	void AddSpotLight(SpotLight* light, int shadowIndex);
+
+	// Sorts the gathered lights into the clusters of this camera and viewport and uploads them
+	void Build(const glm::mat4& view, const glm::mat4& projection, GLuint viewportWidth, GLuint viewportHeight);
+
+	// Grid size and the lookup scales for the Lights block
+	void FillLightsData(LightsBlock& data);
+
+	// Binds the light, cluster and index textures to three units from textureUnit
+	void Read(GLenum textureUnit);
+
+	const LightClusterStats& GetStats() { return stats; }
+
+	~LightClusters();
+
+private:
+	GLuint lightBuffer, clusterBuffer, indexBuffer;
+	GLuint lightTexture, clusterTexture, indexTexture;
+	GLsizeiptr lightCapacity, indexCapacity;
+
+	std::vector<ClusterLightData> lights;
+	std::vector<GLuint> clusterRanges;		// offset and count per cluster
+	std::vector<GLuint> clusterCounts;
+	std::vector<GLuint> lightIndices;
+	std::vector<GLuint> pairs;				// cluster and light of every overlap, before the counting sort
+
+	// View space bounds of every cluster, rebuilt when the projection or viewport changes
+	std::vector<glm::vec3> clusterMin, clusterMax;
+	glm::mat4 clusterProjection;
+	GLuint clusterWidth, clusterHeight;
+
+	float nearPlane, farPlane;
+	glm::vec4 clusterScale;
+
+	LightClusterStats stats;
+
+	void UpdateClusterBounds(const glm::mat4& projection, GLuint viewportWidth, GLuint viewportHeight);
+	void Upload(GLuint buffer, GLuint texture, GLenum format, GLsizeiptr& capacity, const void* data, GLsizeiptr size);
+};
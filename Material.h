@@ -1,19 +1,19 @@
-#pragma once
-
-#include <GL\glew.h>
-
-class Material
-{
-public:
-	Material();
-	Material(GLfloat sIntensity, GLfloat shine);
-
-	void UseMaterial(GLuint specularIntensityLocation, GLuint shininessLocation);
-
-	~Material();
-
-private: 
-	GLfloat specularIntensity;
-	GLfloat shininess;
-};
-
+#pragma once
+
+#include <GL\glew.h>
+
+class Material
+{
+public:
+	Material();
+	Material(GLfloat sIntensity, GLfloat shine);
+
+	void UseMaterial(GLuint specularIntensityLocation, GLuint shininessLocation);
+
+	~Material();
+
+private: 
+	GLfloat specularIntensity;
+	GLfloat shininess;
+};
+
@@ -1,75 +1,113 @@
-#include "Mesh.h"
-
-Mesh::Mesh()
-{
-	VAO = 0;
-	VBO = 0;
-	IBO = 0;
-	indexCount = 0;
-}
-
-void Mesh::CreateMesh(GLfloat *vertices, unsigned int *indices, unsigned int numOfVertices, unsigned int numOfIndices)
-{
-	indexCount = numOfIndices;
-
-	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
-
-	glGenBuffers(1, &IBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices[0]) * numOfIndices, indices, GL_STATIC_DRAW);
-
-	glGenBuffers(1, &VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices[0]) * numOfVertices, vertices, GL_STATIC_DRAW);
-
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(vertices[0]) * 8, 0);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(vertices[0]) * 8, (void*)(sizeof(vertices[0]) * 3));
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(vertices[0]) * 8, (void*)(sizeof(vertices[0]) * 5));
-	glEnableVertexAttribArray(2);
-
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-	glBindVertexArray(0);
-}
-
-void Mesh::RenderMesh()
-{
-	glBindVertexArray(VAO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
-	glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
-}
-
-void Mesh::ClearMesh()
-{
-	if (IBO != 0)
-	{
-		glDeleteBuffers(1, &IBO);
-		IBO = 0;
-	}
-
-	if (VBO != 0)
-	{
-		glDeleteBuffers(1, &VBO);
-		VBO = 0;
-	}
-
-	if (VAO != 0)
-	{
-		glDeleteVertexArrays(1, &VAO);
-		VAO = 0;
-	}
-
-	indexCount = 0;
-}
-
-
-Mesh::~Mesh()
-{
-	ClearMesh();
-}
+#include "Mesh.h"
+
+unsigned int Mesh::drawCallCount = 0;
+unsigned long long Mesh::triangleCount = 0;
+
+Mesh::Mesh()
+{
+	VAO = 0;
+	VBO = 0;
+	IBO = 0;
+	indexCount = 0;
+}
+
+void Mesh::CreateMesh(GLfloat *vertices, unsigned int *indices, unsigned int numOfVertices, unsigned int numOfIndices)
+{
+	indexCount = numOfIndices;
+
+	glGenVertexArrays(1, &VAO);
+	glBindVertexArray(VAO);
+
+	glGenBuffers(1, &IBO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices[0]) * numOfIndices, indices, GL_STATIC_DRAW);
+
+	glGenBuffers(1, &VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices[0]) * numOfVertices, vertices, GL_STATIC_DRAW);
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(vertices[0]) * 8, 0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(vertices[0]) * 8, (void*)(sizeof(vertices[0]) * 3));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(vertices[0]) * 8, (void*)(sizeof(vertices[0]) * 5));
+	glEnableVertexAttribArray(2);
+
+	InstanceBuffer::BindAttributes(0);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// Unbind the VAO first so it keeps the index buffer, binding it is then enough to draw
+	glBindVertexArray(0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void Mesh::RenderMesh()
+{
+	Bind();
+	Draw();
+	Unbind();
+}
+
+void Mesh::Bind()
+{
+	glBindVertexArray(VAO);
+}
+
+void Mesh::Draw()
+{
+	glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+	drawCallCount++;
+	triangleCount += indexCount / 3;
+}
+
+void Mesh::DrawInstanced(GLsizei instanceCount, GLuint firstInstance)
+{
+	if (GLEW_ARB_base_instance)
+	{
+		glDrawElementsInstancedBaseInstance(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0, instanceCount, firstInstance);
+	}
+	else
+	{
+		// GL 3.3 has no base instance, offset the attributes instead
+		InstanceBuffer::BindAttributes(firstInstance);
+		glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0, instanceCount);
+	}
+
+	drawCallCount++;
+	triangleCount += (unsigned long long)(indexCount / 3) * instanceCount;
+}
+
+void Mesh::Unbind()
+{
+	glBindVertexArray(0);
+}
+
+void Mesh::ClearMesh()
+{
+	if (IBO != 0)
+	{
+		glDeleteBuffers(1, &IBO);
+		IBO = 0;
+	}
+
+	if (VBO != 0)
+	{
+		glDeleteBuffers(1, &VBO);
+		VBO = 0;
+	}
+
+	if (VAO != 0)
+	{
+		glDeleteVertexArrays(1, &VAO);
+		VAO = 0;
+	}
+
+	indexCount = 0;
+}
+
+
+Mesh::~Mesh()
+{
+	ClearMesh();
+}
@@ -1,20 +1,40 @@
-#pragma once
-
-#include <GL\glew.h>
-
-class Mesh
-{
-public:
-	Mesh();
-
-	void CreateMesh(GLfloat *vertices, unsigned int *indices, unsigned int numOfVertices, unsigned int numOfIndices);
-	void RenderMesh();
-	void ClearMesh();
-
-	~Mesh();
-
-private:
-	GLuint VAO, VBO, IBO;
-	GLsizei indexCount;
-};
-
+#pragma once
+
+#include <GL\glew.h>
+
+#include "InstanceBuffer.h"
+
+class Mesh
+{
+public:
+	Mesh();
+
+	void CreateMesh(GLfloat *vertices, unsigned int *indices, unsigned int numOfVertices, unsigned int numOfIndices);
+	void RenderMesh();
+
+	// Split binding and drawing so a sorted queue can draw runs of the same mesh with one bind
+	void Bind();
+	void Draw();
+	// Draws the mesh once per instance in the InstanceBuffer, starting at firstInstance
+	void DrawInstanced(GLsizei instanceCount, GLuint firstInstance);
+	static void Unbind();
+
+	GLuint GetVAO() { return VAO; }
+	void ClearMesh();
+
+	static unsigned int GetDrawCallCount() { return drawCallCount; }
+	static unsigned long long GetTriangleCount() { return triangleCount; }
+	static void ResetRenderStats() { drawCallCount = 0; triangleCount = 0; }
+	// For draws that bypass Mesh, such as the indirect ones of GpuScene
+	static void AddRenderStats(unsigned int drawCalls, unsigned long long triangles) { drawCallCount += drawCalls; triangleCount += triangles; }
+
+	~Mesh();
+
+private:
+	GLuint VAO, VBO, IBO;
+	GLsizei indexCount;
+
+	static unsigned int drawCallCount;
+	static unsigned long long triangleCount;
+};
+
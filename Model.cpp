@@ -1,146 +1,186 @@
-#include "Model.h"
-
-Model::Model()
-{
-}
-
-void Model::RenderModel()
-{
-	for (size_t i = 0; i < meshList.size(); i++)
-	{
-		unsigned int materialIndex = meshToTex[i];
-
-		if (materialIndex < textureList.size() && textureList[materialIndex])
-		{
-			textureList[materialIndex]->UseTexture();
-		}
-
-		meshList[i]->RenderMesh();
-	}
-}
-
-void Model::LoadModel(const std::string & fileName)
-{
-	Assimp::Importer importer;
-	const aiScene *scene = importer.ReadFile(fileName, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices);
-
-	if (!scene)
-	{
-		printf("Model (%s) failed to load: %s", fileName.c_str(), importer.GetErrorString());
-		return;
-	}
-
-	LoadNode(scene->mRootNode, scene);
-
-	LoadMaterials(scene);
-}
-
-void Model::LoadNode(aiNode * node, const aiScene * scene)
-{
-	for (size_t i = 0; i < node->mNumMeshes; i++)
-	{
-		LoadMesh(scene->mMeshes[node->mMeshes[i]], scene);
-	}
-
-	for (size_t i = 0; i < node->mNumChildren; i++)
-	{
-		LoadNode(node->mChildren[i], scene);
-	}
-}
-
-void Model::LoadMesh(aiMesh * mesh, const aiScene * scene)
-{
-	std::vector<GLfloat> vertices;
-	std::vector<unsigned int> indices;
-
-	for (size_t i = 0; i < mesh->mNumVertices; i++)
-	{
-		vertices.insert(vertices.end(), { mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z });
-		if (mesh->mTextureCoords[0])
-		{
-			vertices.insert(vertices.end(), { mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y });
-		}
-		else {
-			vertices.insert(vertices.end(), { 0.0f, 0.0f });
-		}
-		vertices.insert(vertices.end(), { -mesh->mNormals[i].x, -mesh->mNormals[i].y, -mesh->mNormals[i].z });
-	}
-
-	for (size_t i = 0; i < mesh->mNumFaces; i++)
-	{
-		aiFace face = mesh->mFaces[i];
-		for (size_t j = 0; j < face.mNumIndices; j++)
-		{
-			indices.push_back(face.mIndices[j]);
-		}
-	}
-
-	Mesh* newMesh = new Mesh();
-	newMesh->CreateMesh(&vertices[0], &indices[0], vertices.size(), indices.size());
-	meshList.push_back(newMesh);
-	meshToTex.push_back(mesh->mMaterialIndex);
-}
-
-void Model::LoadMaterials(const aiScene * scene)
-{
-	textureList.resize(scene->mNumMaterials);
-	
-	for (size_t i = 0; i < scene->mNumMaterials; i++)
-	{
-		aiMaterial* material = scene->mMaterials[i];
-
-		textureList[i] = nullptr;
-
-		if (material->GetTextureCount(aiTextureType_DIFFUSE))
-		{
-			aiString path;
-			if (material->GetTexture(aiTextureType_DIFFUSE, 0, &path) == AI_SUCCESS)
-			{
-				int idx = std::string(path.data).rfind("\\");
-				std::string filename = std::string(path.data).substr(idx + 1);
-
-				std::string texPath = std::string("Textures/") + filename;
-
-				textureList[i] = new Texture(texPath.c_str());
-
-				if (!textureList[i]->LoadTexture())
-				{
-					printf("Failed to load texture at: %s\n", texPath.c_str());
-					delete textureList[i];
-					textureList[i] = nullptr;
-				}
-			}
-		}
-
-		if (!textureList[i])
-		{
-			textureList[i] = new Texture("Textures/plain.png");
-			textureList[i]->LoadTextureA();
-		}
-	}
-}
-
-void Model::ClearModel()
-{
-	for (size_t i = 0; i < meshList.size(); i++)
-	{
-		if (meshList[i])
-		{
-			delete meshList[i];
-			meshList[i] = nullptr;
-		}
-	}
-
-	for (size_t i = 0; i < textureList.size(); i++)
-	{
-		if (textureList[i])
-		{
-			delete textureList[i];
-			textureList[i] = nullptr;
-		}
-	}
-}
-
-Model::~Model()
-{
-}
+#include "Model.h"
+
+#include "GpuScene.h"
+
+Model::Model()
+{
+	boundingBox.center = glm::vec3(0.0f, 0.0f, 0.0f);
+	boundingBox.extent = glm::vec3(0.0f, 0.0f, 0.0f);
+}
+
+void Model::RenderModel()
+{
+	for (size_t i = 0; i < meshList.size(); i++)
+	{
+		unsigned int materialIndex = meshToTex[i];
+
+		if (materialIndex < textureList.size() && textureList[materialIndex])
+		{
+			textureList[materialIndex]->UseTexture();
+		}
+
+		meshList[i]->RenderMesh();
+	}
+}
+
+Texture* Model::GetMeshTexture(size_t mesh)
+{
+	unsigned int materialIndex = meshToTex[mesh];
+	return materialIndex < textureList.size() ? textureList[materialIndex].get() : nullptr;
+}
+
+bool Model::IsMeshVisible(size_t mesh, const glm::mat4& worldMatrix, const CullVolume& volume)
+{
+	// The caller has already tested the model's box, a lone mesh has the same one
+	if (meshList.size() == 1)
+	{
+		return true;
+	}
+
+	// Spheres grow by the largest axis scale so they stay conservative under non-uniform scaling
+	float scale = std::max(glm::length(glm::vec3(worldMatrix[0])), std::max(glm::length(glm::vec3(worldMatrix[1])), glm::length(glm::vec3(worldMatrix[2]))));
+
+	// The cheaper sphere test first, it can only reject
+	BoundingSphere sphere;
+	sphere.center = glm::vec3(worldMatrix * glm::vec4(meshSpheres[mesh].center, 1.0f));
+	sphere.radius = meshSpheres[mesh].radius * scale;
+
+	return SphereInVolume(volume, sphere) && BoxInVolume(volume, TransformBoundingBox(meshBoxes[mesh], worldMatrix));
+}
+
+bool Model::LoadModel(const std::string & fileName)
+{
+	PROFILE_ZONE("Model::LoadModel");
+
+	Assimp::Importer importer;
+	PROFILE_ZONE_BEGIN("Assimp::ReadFile");
+	const aiScene *scene = importer.ReadFile(fileName, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices);
+	PROFILE_ZONE_END();
+
+	if (!scene)
+	{
+		printf("Model (%s) failed to load: %s", fileName.c_str(), importer.GetErrorString());
+		return false;
+	}
+
+	LoadNode(scene->mRootNode, scene);
+
+	LoadMaterials(scene);
+
+	return true;
+}
+
+void Model::LoadNode(aiNode * node, const aiScene * scene)
+{
+	for (size_t i = 0; i < node->mNumMeshes; i++)
+	{
+		LoadMesh(scene->mMeshes[node->mMeshes[i]], scene);
+	}
+
+	for (size_t i = 0; i < node->mNumChildren; i++)
+	{
+		LoadNode(node->mChildren[i], scene);
+	}
+}
+
+void Model::LoadMesh(aiMesh * mesh, const aiScene * scene)
+{
+	PROFILE_ZONE("Model::LoadMesh");
+
+	std::vector<GLfloat> vertices;
+	std::vector<unsigned int> indices;
+
+	InterleaveVertices(mesh, vertices);
+
+	for (size_t i = 0; i < mesh->mNumFaces; i++)
+	{
+		aiFace face = mesh->mFaces[i];
+		for (size_t j = 0; j < face.mNumIndices; j++)
+		{
+			indices.push_back(face.mIndices[j]);
+		}
+	}
+
+	Mesh* newMesh = new Mesh();
+	newMesh->CreateMesh(&vertices[0], &indices[0], vertices.size(), indices.size());
+	meshList.push_back(newMesh);
+	meshToTex.push_back(mesh->mMaterialIndex);
+	meshRanges.push_back(GpuScene::AddMesh(&vertices[0], vertices.size(), &indices[0], indices.size()));
+
+	BoundingBox box;
+	BoundingSphere sphere;
+	CalculateBounds(&vertices[0], mesh->mNumVertices, 8, box, sphere);
+
+	boundingBox = meshBoxes.empty() ? box : MergeBoundingBoxes(boundingBox, box);
+	meshBoxes.push_back(box);
+	meshSpheres.push_back(sphere);
+}
+
+void Model::LoadMaterials(const aiScene * scene)
+{
+	PROFILE_ZONE("Model::LoadMaterials");
+
+	textureList.resize(scene->mNumMaterials);
+	
+	for (size_t i = 0; i < scene->mNumMaterials; i++)
+	{
+		aiMaterial* material = scene->mMaterials[i];
+
+		textureList[i] = nullptr;
+
+		if (material->GetTextureCount(aiTextureType_DIFFUSE))
+		{
+			aiString path;
+			if (material->GetTexture(aiTextureType_DIFFUSE, 0, &path) == AI_SUCCESS)
+			{
+				int idx = std::string(path.data).rfind("\\");
+				std::string filename = std::string(path.data).substr(idx + 1);
+
+				std::string texPath = std::string("Textures/") + filename;
+
+				textureList[i] = AssetRegistry::GetTexture(texPath, false);
+
+				if (!textureList[i])
+				{
+					printf("Failed to load texture at: %s\n", texPath.c_str());
+				}
+			}
+		}
+
+		if (!textureList[i])
+		{
+			textureList[i] = AssetRegistry::GetTexture("Textures/plain.png", true);
+		}
+	}
+}
+
+void Model::ClearModel()
+{
+	for (size_t i = 0; i < meshList.size(); i++)
+	{
+		if (meshList[i])
+		{
+			delete meshList[i];
+			meshList[i] = nullptr;
+		}
+	}
+
+	for (int range : meshRanges)
+	{
+		GpuScene::RemoveMesh(range);
+	}
+
+	meshList.clear();
+	meshToTex.clear();
+	meshRanges.clear();
+	meshBoxes.clear();
+	meshSpheres.clear();
+
+	// Textures are shared between models, the registry frees each one with its last user
+	textureList.clear();
+}
+
+Model::~Model()
+{
+	ClearModel();
+}
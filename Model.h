@@ -1,34 +1,63 @@
-#pragma once
-
-#include <vector>
-#include <string>
-
-#include <assimp\Importer.hpp>
-#include <assimp\scene.h>
-#include <assimp\postprocess.h>
-
-#include "Mesh.h"
-#include "Texture.h"
-
-class Model
-{
-public:
-	Model();
-
-	void LoadModel(const std::string& fileName);
-	void RenderModel();
-	void ClearModel();
-
-	~Model();
-
-private:
-
-	void LoadNode(aiNode *node, const aiScene *scene);
-	void LoadMesh(aiMesh *mesh, const aiScene *scene);
-	void LoadMaterials(const aiScene *scene);
-
-	std::vector<Mesh*> meshList;
-	std::vector<Texture*> textureList;
-	std::vector<unsigned int> meshToTex;
-};
-
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+
+#include <assimp\Importer.hpp>
+#include <assimp\scene.h>
+#include <assimp\postprocess.h>
+
+#include "Mesh.h"
+#include "Texture.h"
+#include "CpuProfiler.h"
+#include "Geometry.h"
+#include "AssetRegistry.h"
+#include "Culling.h"
+
+class Model
+{
+public:
+	Model();
+
+	// Models own GPU buffers, share them through AssetRegistry handles instead of copying
+	Model(const Model&) = delete;
+	Model& operator=(const Model&) = delete;
+
+	bool LoadModel(const std::string& fileName);
+	void RenderModel();
+	void ClearModel();
+
+	size_t GetMeshCount() { return meshList.size(); }
+	Mesh* GetMesh(size_t mesh) { return meshList[mesh]; }
+	// nullptr when the mesh's material has no texture
+	Texture* GetMeshTexture(size_t mesh);
+
+	// Whether the mesh's bounds, placed by the world matrix, touch the volume
+	bool IsMeshVisible(size_t mesh, const glm::mat4& worldMatrix, const CullVolume& volume);
+
+	// Model space, around every mesh
+	const BoundingBox& GetBoundingBox() { return boundingBox; }
+	const BoundingBox& GetMeshBoundingBox(size_t mesh) { return meshBoxes[mesh]; }
+
+	// The mesh's copy in GpuScene, -1 without one
+	int GetMeshRange(size_t mesh) { return meshRanges[mesh]; }
+
+	~Model();
+
+private:
+
+	void LoadNode(aiNode *node, const aiScene *scene);
+	void LoadMesh(aiMesh *mesh, const aiScene *scene);
+	void LoadMaterials(const aiScene *scene);
+
+	std::vector<Mesh*> meshList;
+	std::vector<std::shared_ptr<Texture>> textureList;
+	std::vector<unsigned int> meshToTex;
+	std::vector<int> meshRanges;
+
+	std::vector<BoundingBox> meshBoxes;
+	std::vector<BoundingSphere> meshSpheres;
+	BoundingBox boundingBox;
+};
+
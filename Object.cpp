@@ -1 +1,178 @@
-#include "Object.h"
+#include "Object.h"
+
+#include <algorithm>
+
+
+std::vector<Object*> Object::pendingObjects;
+unsigned int Object::sceneVersion = 0;
+
+unsigned int Object::frame = 1;
+std::vector<Object*> Object::movingObjects;
+std::vector<BoundingBox> Object::staticCasterChanges;
+
+// Frames without a move before an object counts as a static caster again
+static const unsigned int STATIC_CASTER_FRAMES = 30;
+
+Object::Object()
+{
+	transform.position = glm::vec3(0.0f, 0.0f, 0.0f);
+	transform.rotation = glm::vec3(0.0f, 0.0f, 0.0f);
+	transform.scale = glm::vec3(1.0f, 1.0f, 1.0f);
+
+	transformSlot = TransformPool::Allocate();
+	isDirty = false;
+	isPending = false;
+	isPlaced = false;
+	isMoving = false;
+	lastMoveFrame = 0;
+	MarkDirty();
+
+	tree = nullptr;
+	treeProxy = AABB_TREE_NULL;
+
+	sceneVersion++;
+
+	isSelected = false;
+	name = "";
+}
+
+Object::Object(std::shared_ptr<Model> model_, std::string& name_) : Object()
+{
+	model = model_;
+	name = name_.c_str();
+}
+
+void Object::MarkDirty()
+{
+	isDirty = true;
+
+	if (!isPending)
+	{
+		pendingObjects.push_back(this);
+		isPending = true;
+	}
+}
+
+void Object::UpdatePendingTransforms()
+{
+	for (Object* object : pendingObjects)
+	{
+		object->isPending = false;
+		if (object->isDirty) object->UpdateMatrices();
+	}
+
+	pendingObjects.clear();
+}
+
+void Object::AdvanceFrame()
+{
+	frame++;
+	staticCasterChanges.clear();
+
+	for (size_t i = 0; i < movingObjects.size(); )
+	{
+		Object* object = movingObjects[i];
+		if (frame - object->lastMoveFrame <= STATIC_CASTER_FRAMES)
+		{
+			i++;
+			continue;
+		}
+
+		// Settled where it is, static shadows around it need it drawn in
+		object->isMoving = false;
+		staticCasterChanges.push_back(object->getWorldBounds());
+
+		movingObjects[i] = movingObjects.back();
+		movingObjects.pop_back();
+	}
+}
+
+void Object::SettleMovingObjects()
+{
+	for (Object* object : movingObjects)
+	{
+		object->isMoving = false;
+	}
+
+	movingObjects.clear();
+	staticCasterChanges.clear();
+}
+
+void Object::UpdateMatrices()
+{
+	glm::mat4& world = TransformPool::GetWorldMatrix(transformSlot);
+
+	// The first placement isn't a move, new objects change the scene version instead
+	if (isPlaced && model)
+	{
+		if (!isMoving)
+		{
+			// Static shadows still hold it where it was
+			staticCasterChanges.push_back(TransformBoundingBox(model->GetBoundingBox(), world));
+			movingObjects.push_back(this);
+			isMoving = true;
+		}
+		lastMoveFrame = frame;
+	}
+	isPlaced = true;
+
+	world = ComposeModelMatrix(transform.position, transform.rotation, transform.scale);
+	TransformPool::GetNormalMatrix(transformSlot) = ComposeNormalMatrix(world, transform.scale);
+	TransformPool::MarkDirty(transformSlot);
+
+	isDirty = false;
+
+	if (tree)
+	{
+		tree->MoveProxy(treeProxy, getWorldBounds());
+	}
+}
+
+BoundingBox Object::getWorldBounds()
+{
+	if (!model)
+	{
+		return { transform.position, glm::vec3(0.0f, 0.0f, 0.0f) };
+	}
+
+	return TransformBoundingBox(model->GetBoundingBox(), getWorldMatrix());
+}
+
+void Object::AddToTree(AabbTree* tree_)
+{
+	RemoveFromTree();
+
+	// Bounds first, they may refresh the matrices and this object isn't in the tree yet
+	BoundingBox bounds = getWorldBounds();
+
+	tree = tree_;
+	treeProxy = tree->CreateProxy(bounds, this);
+}
+
+void Object::RemoveFromTree()
+{
+	if (tree)
+	{
+		tree->DestroyProxy(treeProxy);
+		tree = nullptr;
+		treeProxy = AABB_TREE_NULL;
+	}
+}
+
+Object::~Object()
+{
+	RemoveFromTree();
+
+	if (isPending)
+	{
+		pendingObjects.erase(std::find(pendingObjects.begin(), pendingObjects.end(), this));
+	}
+
+	if (isMoving)
+	{
+		movingObjects.erase(std::find(movingObjects.begin(), movingObjects.end(), this));
+	}
+
+	TransformPool::Free(transformSlot);
+	sceneVersion++;
+}
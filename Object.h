@@ -1,65 +1,136 @@
-#pragma once
-
-#include <GL\glew.h>
-#include <GLFW\glfw3.h>
-#include <glm\glm.hpp>
-
-#include "model.h"
-
-struct Transform
-{
-	glm::vec3 position;
-	glm::vec3 rotation;
-	glm::vec3 scale;
-};
-
-class Object
-{
-public:
-	Object() {}
-	Object(Model& model_, std::string& name_) {
-		model = model_;
-		name = name_.c_str();
-
-		setScale(1.0f, 1.0f, 1.0f);
-	}
-	~Object(){}
-
-	glm::vec3 getPos() { return transform.position; }
-	glm::vec3 getRot() { return transform.rotation; }
-	glm::vec3 getScale() { return transform.scale; }
-
-	void setPos(float x, float y, float z) {
-		transform.position.x = x;
-		transform.position.y = y;
-		transform.position.z = z;
-	}
-
-	void setRot(float x, float y, float z) {
-		transform.rotation.x = x;
-		transform.rotation.y = y;
-		transform.rotation.z = z;
-	}
-
-	void setScale(float x, float y, float z) {
-		transform.scale.x = x;
-		transform.scale.y = y;
-		transform.scale.z = z;
-	}
-
-	Model getModel() { return model; }
-	void setModel(Model model_) { model = model_; }
-
-	bool getIsSelected() { return isSelected; }
-	void setIsSelected(bool isSelected_) { isSelected = isSelected_; }
-
-	const char* getName() { return name; }
-	void setName(const char* name_) { name = name_; }
-
-private:
-	Transform transform;
-	Model model;
-	bool isSelected;
-	const char* name;
-};
-
+#pragma once
+
+#include <GL\glew.h>
+#include <GLFW\glfw3.h>
+#include <glm\glm.hpp>
+
+#include <memory>
+#include <vector>
+
+#include "model.h"
+#include "TransformPool.h"
+#include "AabbTree.h"
+
+struct Transform
+{
+	glm::vec3 position;
+	glm::vec3 rotation;
+	glm::vec3 scale;
+};
+
+class Object
+{
+public:
+	Object();
+	Object(std::shared_ptr<Model> model_, std::string& name_);
+
+	// Each object owns a TransformPool slot
+	Object(const Object&) = delete;
+	Object& operator=(const Object&) = delete;
+
+	~Object();
+
+	glm::vec3 getPos() { return transform.position; }
+	glm::vec3 getRot() { return transform.rotation; }
+	glm::vec3 getScale() { return transform.scale; }
+
+	void setPos(float x, float y, float z) {
+		setTransformComponent(transform.position, glm::vec3(x, y, z));
+	}
+
+	void setRot(float x, float y, float z) {
+		setTransformComponent(transform.rotation, glm::vec3(x, y, z));
+	}
+
+	void setScale(float x, float y, float z) {
+		setTransformComponent(transform.scale, glm::vec3(x, y, z));
+	}
+
+	// Cached in the TransformPool, recomputed only after the transform has changed
+	const glm::mat4& getWorldMatrix() {
+		if (isDirty) UpdateMatrices();
+		return TransformPool::GetWorldMatrix(transformSlot);
+	}
+
+	const glm::mat3& getNormalMatrix() {
+		if (isDirty) UpdateMatrices();
+		return TransformPool::GetNormalMatrix(transformSlot);
+	}
+
+	// Refreshes the matrices and tree bounds of every object changed since the last call.
+	// Passes that read the pool or tree directly call this first
+	static void UpdatePendingTransforms();
+
+	// The object keeps its tree bounds current until it is removed or destroyed
+	void AddToTree(AabbTree* tree_);
+	void RemoveFromTree();
+
+	unsigned int getTransformSlot() { return transformSlot; }
+
+	// World-space box around the model
+	BoundingBox getWorldBounds();
+
+	Model* getModel() { return model.get(); }
+	std::shared_ptr<Model> getModelHandle() { return model; }
+	void setModel(std::shared_ptr<Model> model_) {
+		model = model_;
+		sceneVersion++;
+		MarkDirty();
+	}
+
+	// Changes whenever an object is created, destroyed or given another model
+	static unsigned int GetSceneVersion() { return sceneVersion; }
+
+	// Shadow caching. Objects moved within the last few frames are dynamic casters, drawn over cached
+	// shadows of the static ones. Call AdvanceFrame once per frame before UpdatePendingTransforms
+	static void AdvanceFrame();
+	static unsigned int GetFrame() { return frame; }
+	static const std::vector<Object*>& GetMovingObjects() { return movingObjects; }
+	// Treats every moving object as settled where it is without reporting the moves, for setup done before any
+	// shadow was cached
+	static void SettleMovingObjects();
+	// World bounds where static casters appeared or disappeared this frame, cached shadows touching them are stale
+	static const std::vector<BoundingBox>& GetStaticCasterChanges() { return staticCasterChanges; }
+	bool isStaticCaster() { return !isMoving; }
+
+	bool getIsSelected() { return isSelected; }
+	void setIsSelected(bool isSelected_) { isSelected = isSelected_; }
+
+	const char* getName() { return name; }
+	void setName(const char* name_) { name = name_; }
+
+private:
+	Transform transform;
+	unsigned int transformSlot;
+	bool isDirty;
+	bool isPending;
+	bool isPlaced;
+	bool isMoving;
+	unsigned int lastMoveFrame;
+
+	AabbTree* tree;
+	int treeProxy;
+
+	static std::vector<Object*> pendingObjects;
+	static unsigned int sceneVersion;
+
+	static unsigned int frame;
+	static std::vector<Object*> movingObjects;
+	static std::vector<BoundingBox> staticCasterChanges;
+
+	std::shared_ptr<Model> model;
+	bool isSelected;
+	const char* name;
+
+	void setTransformComponent(glm::vec3& component, glm::vec3 value) {
+		if (component != value) {
+			component = value;
+			MarkDirty();
+		}
+	}
+
+	void MarkDirty();
+
+	void UpdateMatrices();
+};
+
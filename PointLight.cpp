@@ -1,77 +1,117 @@
-#include "PointLight.h"
-
-
-
-PointLight::PointLight() : Light()
-{
-	position = glm::vec3(0.0f, 0.0f, 0.0f);
-	constant = 1.0f;
-	linear = 0.0f;
-	exponent = 0.0f;
-}
-
-PointLight::PointLight(GLuint shadowWidth, GLuint shadowHeight,
-						GLfloat near, GLfloat far, 
-						GLfloat red, GLfloat green, GLfloat blue,
-						GLfloat aIntensity, GLfloat dIntensity, 
-						GLfloat xPos, GLfloat yPos, GLfloat zPos, 
-						GLfloat con, GLfloat lin, GLfloat exp) : Light(shadowWidth, shadowHeight, red, green, blue, aIntensity, dIntensity)
-{
-	position = glm::vec3(xPos, yPos, zPos);
-	constant = con;
-	linear = lin;
-	exponent = exp;
-
-	farPlane = far;
-
-	float aspect = (float)shadowWidth / (float)shadowHeight;
-	lightProj = glm::perspective(glm::radians(90.0f), aspect, near, far);
-
-	shadowMap = new OmniShadowMap();
-	shadowMap->Init(shadowWidth, shadowHeight);
-}
-
-void PointLight::UseLight(GLuint ambientIntensityLocation, GLuint ambientColourLocation,
-	GLuint diffuseIntensityLocation, GLuint positionLocation,
-	GLuint constantLocation, GLuint linearLocation, GLuint exponentLocation)
-{
-	glUniform3f(ambientColourLocation, colour.x, colour.y, colour.z);
-	glUniform1f(ambientIntensityLocation, ambientIntensity);
-	glUniform1f(diffuseIntensityLocation, diffuseIntensity);
-
-	glUniform3f(positionLocation, position.x, position.y, position.z);
-	glUniform1f(constantLocation, constant);
-	glUniform1f(linearLocation, linear);
-	glUniform1f(exponentLocation, exponent);
-}
-
-std::vector<glm::mat4> PointLight::CalculateLightTransform()
-{
-	std::vector<glm::mat4> lightMatrices;
-	//+x, -x
-	lightMatrices.push_back(lightProj * glm::lookAt(position, position + glm::vec3(1.0, 0.0, 0.0), glm::vec3(0.0, -1.0, 0.0)));
-	lightMatrices.push_back(lightProj * glm::lookAt(position, position + glm::vec3(-1.0, 0.0, 0.0), glm::vec3(0.0, -1.0, 0.0)));
-
-	//+y, -y
-	lightMatrices.push_back(lightProj * glm::lookAt(position, position + glm::vec3(0.0, 1.0, 0.0), glm::vec3(0.0, 0.0, 1.0)));
-	lightMatrices.push_back(lightProj * glm::lookAt(position, position + glm::vec3(0.0, -1.0, 0.0), glm::vec3(0.0, 0.0, -1.0)));
-
-	//+z, -z
-	lightMatrices.push_back(lightProj * glm::lookAt(position, position + glm::vec3(0.0, 0.0, 1.0), glm::vec3(0.0, -1.0, 0.0)));
-	lightMatrices.push_back(lightProj * glm::lookAt(position, position + glm::vec3(0.0, 0.0, -1.0), glm::vec3(0.0, -1.0, 0.0)));
-
-	return lightMatrices;
-}
-
-GLfloat PointLight::GetFarPlane()
-{
-	return farPlane;
-}
-glm::vec3 PointLight::GetPosition()
-{
-	return position;
-}
-
-PointLight::~PointLight()
-{
-}
+#include "PointLight.h"
+
+
+
+PointLight::PointLight() : Light()
+{
+	position = glm::vec3(0.0f, 0.0f, 0.0f);
+	constant = 1.0f;
+	linear = 0.0f;
+	exponent = 0.0f;
+
+	farPlane = 100.0f;
+	lightProj = glm::perspective(glm::radians(90.0f), 1.0f, 0.01f, farPlane);
+}
+
+PointLight::PointLight(GLuint shadowWidth, GLuint shadowHeight,
+						GLfloat near, GLfloat far, 
+						GLfloat red, GLfloat green, GLfloat blue,
+						GLfloat aIntensity, GLfloat dIntensity, 
+						GLfloat xPos, GLfloat yPos, GLfloat zPos, 
+						GLfloat con, GLfloat lin, GLfloat exp) : Light(shadowWidth, shadowHeight, red, green, blue, aIntensity, dIntensity)
+{
+	position = glm::vec3(xPos, yPos, zPos);
+	constant = con;
+	linear = lin;
+	exponent = exp;
+
+	farPlane = far;
+
+	lightProj = glm::perspective(glm::radians(90.0f), 1.0f, near, far);
+}
+
+PointLight::PointLight(glm::vec3 pos, glm::vec3 colour_, GLfloat intensity, GLfloat range) : Light()
+{
+	colour = colour_;
+	ambientIntensity = 0.0f;
+	diffuseIntensity = intensity;
+
+	// Reaches 1/256 of its brightness at range, see GetRange
+	position = pos;
+	constant = 1.0f;
+	linear = 0.0f;
+	exponent = (256.0f * intensity * glm::max(glm::max(colour.x, colour.y), colour.z) - 1.0f) / (range * range);
+
+	farPlane = range;
+	lightProj = glm::perspective(glm::radians(90.0f), 1.0f, 0.01f, farPlane);
+}
+
+void PointLight::FillLightData(ClusterLightData& data)
+{
+	data.position = position;
+	data.range = GetRange();
+	data.colour = colour;
+	data.ambientIntensity = ambientIntensity;
+	data.diffuseIntensity = diffuseIntensity;
+	data.constant = constant;
+	data.linear = linear;
+	data.exponent = exponent;
+	data.direction = glm::vec3(0.0f, 0.0f, 0.0f);
+	data.edge = -2.0f;
+	data.farPlane = farPlane;
+	data.shadowIndex = -1.0f;
+	data.padding[0] = data.padding[1] = 0.0f;
+}
+
+GLfloat PointLight::GetRange()
+{
+	// Solve exponent * d^2 + linear * d + constant = 256 * brightness for d
+	float brightness = glm::max(glm::max(colour.x, colour.y), colour.z) * glm::max(ambientIntensity, diffuseIntensity);
+	float c = constant - 256.0f * brightness;
+	if (c >= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	if (exponent > 0.0f)
+	{
+		return (-linear + sqrtf(linear * linear - 4.0f * exponent * c)) / (2.0f * exponent);
+	}
+	if (linear > 0.0f)
+	{
+		return -c / linear;
+	}
+
+	return farPlane;
+}
+
+std::vector<glm::mat4> PointLight::CalculateLightTransform()
+{
+	std::vector<glm::mat4> lightMatrices;
+	//+x, -x
+	lightMatrices.push_back(lightProj * glm::lookAt(position, position + glm::vec3(1.0, 0.0, 0.0), glm::vec3(0.0, -1.0, 0.0)));
+	lightMatrices.push_back(lightProj * glm::lookAt(position, position + glm::vec3(-1.0, 0.0, 0.0), glm::vec3(0.0, -1.0, 0.0)));
+
+	//+y, -y
+	lightMatrices.push_back(lightProj * glm::lookAt(position, position + glm::vec3(0.0, 1.0, 0.0), glm::vec3(0.0, 0.0, 1.0)));
+	lightMatrices.push_back(lightProj * glm::lookAt(position, position + glm::vec3(0.0, -1.0, 0.0), glm::vec3(0.0, 0.0, -1.0)));
+
+	//+z, -z
+	lightMatrices.push_back(lightProj * glm::lookAt(position, position + glm::vec3(0.0, 0.0, 1.0), glm::vec3(0.0, -1.0, 0.0)));
+	lightMatrices.push_back(lightProj * glm::lookAt(position, position + glm::vec3(0.0, 0.0, -1.0), glm::vec3(0.0, -1.0, 0.0)));
+
+	return lightMatrices;
+}
+
+GLfloat PointLight::GetFarPlane()
+{
+	return farPlane;
+}
+glm::vec3 PointLight::GetPosition()
+{
+	return position;
+}
+
+PointLight::~PointLight()
+{
+}
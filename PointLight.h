@@ -1,39 +1,41 @@
-#pragma once
-#include "Light.h"
-
-#include <vector>
-
-#include "OmniShadowMap.h"
-
-class PointLight :
-	public Light
-{
-public:
-	PointLight();
-	PointLight(GLuint shadowWidth, GLuint shadowHeight,
-		GLfloat near, GLfloat far,
-		GLfloat red, GLfloat green, GLfloat blue,
-		GLfloat aIntensity, GLfloat dIntensity,
-		GLfloat xPos, GLfloat yPos, GLfloat zPos,
-		GLfloat con, GLfloat lin, GLfloat exp);
-
-	void UseLight(GLuint ambientIntensityLocation, GLuint ambientColourLocation,
-		GLuint diffuseIntensityLocation, GLuint positionLocation,
-		GLuint constantLocation, GLuint linearLocation, GLuint exponentLocation);
-
-	std::vector<glm::mat4> CalculateLightTransform();
-	GLfloat GetFarPlane();
-	glm::vec3 GetPosition();
-
-
-
-	~PointLight();
-
-protected:
-	glm::vec3 position;
-
-	GLfloat constant, linear, exponent;
-
-	GLfloat farPlane;
-};
-
+#pragma once
+#include "Light.h"
+
+#include <vector>
+
+class PointLight :
+	public Light
+{
+public:
+	PointLight();
+	PointLight(GLuint shadowWidth, GLuint shadowHeight,
+		GLfloat near, GLfloat far,
+		GLfloat red, GLfloat green, GLfloat blue,
+		GLfloat aIntensity, GLfloat dIntensity,
+		GLfloat xPos, GLfloat yPos, GLfloat zPos,
+		GLfloat con, GLfloat lin, GLfloat exp);
+	// An unshadowed fixture whose light fades out at range
+	PointLight(glm::vec3 pos, glm::vec3 colour_, GLfloat intensity, GLfloat range);
+
+	// Without a shadow slot, the clusters set it
+	void FillLightData(ClusterLightData& data);
+
+	// Distance at which the attenuated light falls below 1/256 of its brightness, the far plane when it never does
+	GLfloat GetRange();
+
+	std::vector<glm::mat4> CalculateLightTransform();
+	GLfloat GetFarPlane();
+	glm::vec3 GetPosition();
+
+
+
+	~PointLight();
+
+protected:
+	glm::vec3 position;
+
+	GLfloat constant, linear, exponent;
+
+	GLfloat farPlane;
+};
+
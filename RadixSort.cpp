@@ -0,0 +1,65 @@
+#include "RadixSort.h"
+
+bool RadixSort64(uint64_t* keys, uint32_t* values, uint64_t* keyScratch, uint32_t* valueScratch, size_t count)
+{
+	if (count < 2)
+	{
+		return false;
+	}
+
+	// One read of the keys builds the histograms for all eight passes
+	size_t histograms[8][256] = {};
+
+	for (size_t i = 0; i < count; i++)
+	{
+		uint64_t key = keys[i];
+		for (int pass = 0; pass < 8; pass++)
+		{
+			histograms[pass][(key >> (pass * 8)) & 0xff]++;
+		}
+	}
+
+	uint64_t* sourceKeys = keys;
+	uint32_t* sourceValues = values;
+	uint64_t* targetKeys = keyScratch;
+	uint32_t* targetValues = valueScratch;
+	bool inScratch = false;
+
+	for (int pass = 0; pass < 8; pass++)
+	{
+		size_t* histogram = histograms[pass];
+		int shift = pass * 8;
+
+		if (histogram[(sourceKeys[0] >> shift) & 0xff] == count)
+		{
+			continue;
+		}
+
+		size_t offset = 0;
+		for (int bucket = 0; bucket < 256; bucket++)
+		{
+			size_t bucketCount = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += bucketCount;
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			size_t target = histogram[(sourceKeys[i] >> shift) & 0xff]++;
+			targetKeys[target] = sourceKeys[i];
+			targetValues[target] = sourceValues[i];
+		}
+
+		uint64_t* swapKeys = sourceKeys;
+		sourceKeys = targetKeys;
+		targetKeys = swapKeys;
+
+		uint32_t* swapValues = sourceValues;
+		sourceValues = targetValues;
+		targetValues = swapValues;
+
+		inScratch = !inScratch;
+	}
+
+	return inScratch;
+}
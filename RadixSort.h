@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Sorts keys ascending and moves each value with its key, stable. LSD radix over bytes,
+// skipping every byte position where all keys agree. The scratch arrays must hold count entries,
+// and the sorted result may be left in either pair: the return value says which (true for the scratch).
+bool RadixSort64(uint64_t* keys, uint32_t* values, uint64_t* keyScratch, uint32_t* valueScratch, size_t count);
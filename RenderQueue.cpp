@@ -0,0 +1,147 @@
+#include "RenderQueue.h"
+
+#include <glm\gtc\type_ptr.hpp>
+
+RenderQueue::RenderQueue()
+{
+	depthOnly = false;
+	ResetStats();
+}
+
+void RenderQueue::Begin(bool depthOnly_)
+{
+	depthOnly = depthOnly_;
+
+	items.clear();
+	keys.clear();
+	instances.clear();
+}
+
+void RenderQueue::AddItem(const RenderItem& item)
+{
+	uint64_t program = item.instanceCount > 0 ? 1 : 0;
+	uint64_t texture = (!depthOnly && item.texture) ? item.texture->GetTextureID() : 0;
+	uint64_t vertexArray = item.mesh->GetVAO();
+
+	// 4 bits of program, 20 of texture name, 24 of vertex array name, the low 16 bits are spare
+	keys.push_back((program << 60) | ((texture & 0xfffff) << 40) | ((vertexArray & 0xffffff) << 16));
+	items.push_back(item);
+}
+
+void RenderQueue::AddDraw(Mesh* mesh, Texture* texture, const glm::mat4* worldMatrix, const glm::mat3* normalMatrix)
+{
+	AddItem({ mesh, texture, worldMatrix, normalMatrix, 0, 0 });
+}
+
+GLuint RenderQueue::AddInstance(const glm::mat4& worldMatrix, const glm::mat3& normalMatrix)
+{
+	instances.push_back({ worldMatrix, normalMatrix });
+	return instances.size() - 1;
+}
+
+void RenderQueue::AddInstancedDraw(Mesh* mesh, Texture* texture, GLuint firstInstance, GLsizei instanceCount)
+{
+	AddItem({ mesh, texture, nullptr, nullptr, firstInstance, instanceCount });
+}
+
+void RenderQueue::Submit(Shader* program, Shader* instancedProgram)
+{
+	PROFILE_ZONE("RenderQueue::Submit");
+
+	size_t count = items.size();
+	if (count == 0)
+	{
+		return;
+	}
+
+	order.resize(count);
+	keyScratch.resize(count);
+	orderScratch.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		order[i] = i;
+	}
+
+	PROFILE_ZONE_BEGIN("RadixSort64");
+	const uint32_t* sorted = RadixSort64(keys.data(), order.data(), keyScratch.data(), orderScratch.data(), count) ? orderScratch.data() : order.data();
+	PROFILE_ZONE_END();
+
+	if (!instances.empty())
+	{
+		InstanceBuffer::Upload(instances.data(), instances.size());
+	}
+
+	Shader* currentProgram = nullptr;
+	GLuint uniformModel = 0, uniformNormalMatrix = 0;
+	Texture* currentTexture = nullptr;
+	Mesh* currentMesh = nullptr;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const RenderItem& item = items[sorted[i]];
+
+		Shader* itemProgram = item.instanceCount > 0 ? instancedProgram : program;
+		if (itemProgram != currentProgram)
+		{
+			itemProgram->UseShader();
+			uniformModel = itemProgram->GetModelLocation();
+			uniformNormalMatrix = itemProgram->GetNormalMatrixLocation();
+			currentProgram = itemProgram;
+			stats.programBinds++;
+		}
+
+		// Unsorted, each draw bound its texture and vertex array. Depth-only passes and untextured items need no texture,
+		// so they neither bind nor skip one
+		if (!depthOnly && item.texture)
+		{
+			if (item.texture != currentTexture)
+			{
+				item.texture->UseTexture();
+				currentTexture = item.texture;
+				stats.textureBinds++;
+			}
+			else
+			{
+				stats.skippedBinds++;
+			}
+		}
+
+		if (item.mesh != currentMesh)
+		{
+			item.mesh->Bind();
+			currentMesh = item.mesh;
+			stats.vertexArrayBinds++;
+		}
+		else
+		{
+			stats.skippedBinds++;
+		}
+
+		if (item.instanceCount > 0)
+		{
+			item.mesh->DrawInstanced(item.instanceCount, item.firstInstance);
+		}
+		else
+		{
+			glUniformMatrix4fv(uniformModel, 1, GL_FALSE, glm::value_ptr(*item.worldMatrix));
+			// Depth-only programs have no normals
+			if (!depthOnly)
+			{
+				glUniformMatrix3fv(uniformNormalMatrix, 1, GL_FALSE, glm::value_ptr(*item.normalMatrix));
+			}
+			item.mesh->Draw();
+		}
+	}
+
+	Mesh::Unbind();
+	stats.items += count;
+}
+
+void RenderQueue::ResetStats()
+{
+	stats = { 0, 0, 0, 0, 0 };
+}
+
+RenderQueue::~RenderQueue()
+{
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+#include <GL\glew.h>
+
+#include <glm\glm.hpp>
+
+#include "Mesh.h"
+#include "Texture.h"
+#include "Shader.h"
+#include "InstanceBuffer.h"
+#include "RadixSort.h"
+
+struct RenderItem
+{
+	Mesh* mesh;
+	Texture* texture;
+	const glm::mat4* worldMatrix;	// per-object draws
+	const glm::mat3* normalMatrix;
+	GLuint firstInstance;			// instanced draws
+	GLsizei instanceCount;			// 0 for per-object draws
+};
+
+// Binds issued and skipped since the last ResetStats()
+struct RenderQueueStats
+{
+	unsigned int items;
+	unsigned int programBinds;
+	unsigned int textureBinds;
+	unsigned int vertexArrayBinds;
+	unsigned int skippedBinds;
+};
+
+// Collects the draws of a pass, sorts them by state and submits them binding only what changes.
+// Keys from most to least significant: program (per-object or instanced), texture, vertex array.
+class RenderQueue
+{
+public:
+	RenderQueue();
+
+	// Depth-only passes leave textures out of the keys and never bind them
+	void Begin(bool depthOnly_);
+
+	void AddDraw(Mesh* mesh, Texture* texture, const glm::mat4* worldMatrix, const glm::mat3* normalMatrix);
+
+	// Instances are shared by every mesh of a model, add them once and queue each mesh against the range
+	GLuint AddInstance(const glm::mat4& worldMatrix, const glm::mat3& normalMatrix);
+	void AddInstancedDraw(Mesh* mesh, Texture* texture, GLuint firstInstance, GLsizei instanceCount);
+
+	// Per-object draws set the model and normal matrices of program, instanced draws switch to instancedProgram
+	void Submit(Shader* program, Shader* instancedProgram);
+
+	const RenderQueueStats& GetStats() { return stats; }
+	void ResetStats();
+
+	~RenderQueue();
+
+private:
+	bool depthOnly;
+
+	std::vector<RenderItem> items;
+	std::vector<uint64_t> keys;
+	std::vector<uint32_t> order;
+	std::vector<uint64_t> keyScratch;
+	std::vector<uint32_t> orderScratch;
+
+	std::vector<InstanceData> instances;
+
+	RenderQueueStats stats;
+
+	void AddItem(const RenderItem& item);
+};
@@ -0,0 +1,65 @@
+#include "RenderTarget.h"
+
+RenderTarget::RenderTarget()
+{
+	FBO = 0;
+	colourBuffer = 0;
+	depthBuffer = 0;
+	targetWidth = 0;
+	targetHeight = 0;
+}
+
+bool RenderTarget::Init(unsigned int width, unsigned int height)
+{
+	targetWidth = width; targetHeight = height;
+
+	glGenFramebuffers(1, &FBO);
+	glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+
+	glGenRenderbuffers(1, &colourBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, colourBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colourBuffer);
+
+	glGenRenderbuffers(1, &depthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	GLenum Status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if (Status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		printf("Framebuffer error: %i\n", Status);
+		return false;
+	}
+
+	return true;
+}
+
+void RenderTarget::Write()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+}
+
+RenderTarget::~RenderTarget()
+{
+	if (FBO)
+	{
+		glDeleteFramebuffers(1, &FBO);
+	}
+
+	if (colourBuffer)
+	{
+		glDeleteRenderbuffers(1, &colourBuffer);
+	}
+
+	if (depthBuffer)
+	{
+		glDeleteRenderbuffers(1, &depthBuffer);
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdio.h>
+
+#include <GL\glew.h>
+
+class RenderTarget
+{
+public:
+	RenderTarget();
+
+	bool Init(unsigned int width, unsigned int height);
+
+	void Write();
+
+	GLuint GetWidth() { return targetWidth; }
+	GLuint GetHeight() { return targetHeight; }
+
+	~RenderTarget();
+
+private:
+	GLuint FBO, colourBuffer, depthBuffer;
+	GLuint targetWidth, targetHeight;
+};
@@ -0,0 +1,101 @@
+#include "SceneLoader.h"
+
+SceneLoader::SceneLoader()
+{
+	fileLocation = "";
+}
+
+SceneLoader::SceneLoader(const char* fileLoc)
+{
+	fileLocation = fileLoc;
+}
+
+bool SceneLoader::LoadScene(std::vector<Object*>& objects, std::vector<PointLight>& lights, Camera& camera)
+{
+	std::ifstream fileStream(fileLocation, std::ios::in);
+
+	if (!fileStream.is_open())
+	{
+		printf("Failed to read %s! File doesn't exist.\n", fileLocation);
+		return false;
+	}
+
+	std::string line = "";
+	int lineNumber = 0;
+	while (std::getline(fileStream, line))
+	{
+		lineNumber++;
+
+		std::istringstream tokens(line);
+		std::string keyword;
+		if (!(tokens >> keyword) || keyword[0] == '#')
+		{
+			continue;
+		}
+
+		if (keyword == "camera")
+		{
+			GLfloat x = 0.0f, y = 0.0f, z = 0.0f, yaw = -90.0f, pitch = 0.0f;
+			tokens >> x >> y >> z >> yaw >> pitch;
+
+			camera = Camera(glm::vec3(x, y, z), glm::vec3(0.0f, 1.0f, 0.0f), yaw, pitch, camera.getMoveSpeed(), camera.getTurnSpeed());
+		}
+		else if (keyword == "object")
+		{
+			std::string modelFile;
+			if (!(tokens >> modelFile))
+			{
+				printf("%s:%d: object without a model file\n", fileLocation, lineNumber);
+				continue;
+			}
+
+			float position[3] = { 0.0f, 0.0f, 0.0f };
+			float rotation[3] = { 0.0f, 0.0f, 0.0f };
+			float scale[3] = { 1.0f, 1.0f, 1.0f };
+			tokens >> position[0] >> position[1] >> position[2];
+			tokens >> rotation[0] >> rotation[1] >> rotation[2];
+			tokens >> scale[0] >> scale[1] >> scale[2];
+
+			std::shared_ptr<Model> model = AssetRegistry::GetModel(modelFile);
+			if (!model)
+			{
+				printf("%s:%d: failed to load %s\n", fileLocation, lineNumber, modelFile.c_str());
+				continue;
+			}
+
+			size_t nameStart = modelFile.find_last_of("/\\");
+			nameStart = nameStart == std::string::npos ? 0 : nameStart + 1;
+			std::string* name = new std::string(modelFile.substr(nameStart, modelFile.find_last_of('.') - nameStart));
+
+			Object* object = new Object(model, *name);
+			object->setPos(position[0], position[1], position[2]);
+			object->setRot(rotation[0], rotation[1], rotation[2]);
+			object->setScale(scale[0], scale[1], scale[2]);
+
+			objects.push_back(object);
+		}
+		else if (keyword == "light")
+		{
+			GLfloat x = 0.0f, y = 0.0f, z = 0.0f, red = 1.0f, green = 1.0f, blue = 1.0f, intensity = 1.0f, range = 5.0f;
+			if (!(tokens >> x >> y >> z))
+			{
+				printf("%s:%d: light without a position\n", fileLocation, lineNumber);
+				continue;
+			}
+			tokens >> red >> green >> blue >> intensity >> range;
+
+			lights.push_back(PointLight(glm::vec3(x, y, z), glm::vec3(red, green, blue), intensity, glm::max(range, 0.01f)));
+		}
+		else
+		{
+			printf("%s:%d: unknown entry '%s'\n", fileLocation, lineNumber, keyword.c_str());
+		}
+	}
+
+	fileStream.close();
+	return true;
+}
+
+SceneLoader::~SceneLoader()
+{
+}
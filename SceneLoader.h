@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+
+#include "Object.h"
+#include "Model.h"
+#include "Camera.h"
+#include "PointLight.h"
+
+// Reads a plain text scene description, one entry per line:
+//   camera <x> <y> <z> <yaw> <pitch>
+//   object <model file> [<px> <py> <pz> [<rx> <ry> <rz> [<sx> <sy> <sz>]]]
+//   light <x> <y> <z> [<r> <g> <b> [<intensity> [<range>]]]
+// Blank lines and lines starting with '#' are ignored.
+class SceneLoader
+{
+public:
+	SceneLoader();
+	SceneLoader(const char* fileLoc);
+
+	// Lights are unshadowed fixtures, added to lights
+	bool LoadScene(std::vector<Object*>& objects, std::vector<PointLight>& lights, Camera& camera);
+
+	~SceneLoader();
+
+private:
+	const char* fileLocation;
+};
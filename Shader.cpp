@@ -1,386 +1,399 @@
-#include "Shader.h"
-
-Shader::Shader()
-{
-	shaderID = 0;
-	uniformModel = 0;
-	uniformProjection = 0;
-
-	pointLightCount = 0;
-	spotLightCount = 0;
-}
-
-void Shader::CreateFromString(const char* vertexCode, const char* fragmentCode)
-{
-	CompileShader(vertexCode, fragmentCode);
-}
-
-void Shader::CreateFromFiles(const char* vertexLocation, const char* fragmentLocation)
-{
-	std::string vertexString = ReadFile(vertexLocation);
-	std::string fragmentString = ReadFile(fragmentLocation);
-	const char* vertexCode = vertexString.c_str();
-	const char* fragmentCode = fragmentString.c_str();
-
-	CompileShader(vertexCode, fragmentCode);
-}
-
-void Shader::CreateFromFiles(const char* vertexLocation, const char* geometryLocation, const char* fragmentLocation)
-{
-	std::string vertexString = ReadFile(vertexLocation);
-	std::string geometryString = ReadFile(geometryLocation);
-	std::string fragmentString = ReadFile(fragmentLocation);
-	const char* vertexCode = vertexString.c_str();
-	const char* geometryCode = geometryString.c_str();
-	const char* fragmentCode = fragmentString.c_str();
-
-	CompileShader(vertexCode, geometryCode, fragmentCode);
-}
-
-std::string Shader::ReadFile(const char* fileLocation)
-{
-	std::string content;
-	std::ifstream fileStream(fileLocation, std::ios::in);
-
-	if (!fileStream.is_open()) {
-		printf("Failed to read %s! File doesn't exist.", fileLocation);
-		return "";
-	}
-
-	std::string line = "";
-	while (!fileStream.eof())
-	{
-		std::getline(fileStream, line);
-		content.append(line + "\n");
-	}
-
-	fileStream.close();
-	return content;
-}
-
-void Shader::CompileShader(const char* vertexCode, const char* fragmentCode)
-{
-	shaderID = glCreateProgram();
-
-	if (!shaderID)
-	{
-		printf("Error creating shader program!\n");
-		return;
-	}
-
-	AddShader(shaderID, vertexCode, GL_VERTEX_SHADER);
-	AddShader(shaderID, fragmentCode, GL_FRAGMENT_SHADER);
-
-	CompileProgram();
-}
-
-void Shader::CompileShader(const char* vertexCode, const char* geometryCode, const char* fragmentCode)
-{
-	shaderID = glCreateProgram();
-
-	if (!shaderID)
-	{
-		printf("Error creating shader program!\n");
-		return;
-	}
-
-	AddShader(shaderID, vertexCode, GL_VERTEX_SHADER);
-	AddShader(shaderID, geometryCode, GL_GEOMETRY_SHADER);
-	AddShader(shaderID, fragmentCode, GL_FRAGMENT_SHADER);
-
-	CompileProgram();
-}
-
-void Shader::Validate()
-{
-	GLint result = 0;
-	GLchar eLog[1024] = { 0 };
-
-	glValidateProgram(shaderID);
-	glGetProgramiv(shaderID, GL_VALIDATE_STATUS, &result);
-	if (!result)
-	{
-		glGetProgramInfoLog(shaderID, sizeof(eLog), NULL, eLog);
-		printf("Error validating program: '%s'\n", eLog);
-		return;
-	}
-}
-
-void Shader::CompileProgram() {
-
-	GLint result = 0;
-	GLchar eLog[1024] = { 0 };
-
-	glLinkProgram(shaderID);
-	glGetProgramiv(shaderID, GL_LINK_STATUS, &result);
-	if (!result)
-	{
-		glGetProgramInfoLog(shaderID, sizeof(eLog), NULL, eLog);
-		printf("Error linking program: '%s'\n", eLog);
-		return;
-	}
-
-	uniformProjection = glGetUniformLocation(shaderID, "projection");
-	uniformModel = glGetUniformLocation(shaderID, "model");
-	uniformView = glGetUniformLocation(shaderID, "view");
-	uniformDirectionalLight.uniformColour = glGetUniformLocation(shaderID, "directionalLight.base.colour");
-	uniformDirectionalLight.uniformAmbientIntensity = glGetUniformLocation(shaderID, "directionalLight.base.ambientIntensity");
-	uniformDirectionalLight.uniformDirection = glGetUniformLocation(shaderID, "directionalLight.direction");
-	uniformDirectionalLight.uniformDiffuseIntensity = glGetUniformLocation(shaderID, "directionalLight.base.diffuseIntensity");
-	uniformSpecularIntensity = glGetUniformLocation(shaderID, "material.specularIntensity");
-	uniformShininess = glGetUniformLocation(shaderID, "material.shininess");
-	uniformEyePosition = glGetUniformLocation(shaderID, "eyePosition");
-
-	uniformPointLightCount = glGetUniformLocation(shaderID, "pointLightCount");
-
-	for (size_t i = 0; i < MAX_POINT_LIGHTS; i++)
-	{
-		char locBuff[100] = { '\0' };
-
-		snprintf(locBuff, sizeof(locBuff), "pointLights[%d].base.colour", i);
-		uniformPointLight[i].uniformColour = glGetUniformLocation(shaderID, locBuff);
-
-		snprintf(locBuff, sizeof(locBuff), "pointLights[%d].base.ambientIntensity", i);
-		uniformPointLight[i].uniformAmbientIntensity = glGetUniformLocation(shaderID, locBuff);
-
-		snprintf(locBuff, sizeof(locBuff), "pointLights[%d].base.diffuseIntensity", i);
-		uniformPointLight[i].uniformDiffuseIntensity = glGetUniformLocation(shaderID, locBuff);
-
-		snprintf(locBuff, sizeof(locBuff), "pointLights[%d].position", i);
-		uniformPointLight[i].uniformPosition = glGetUniformLocation(shaderID, locBuff);
-
-		snprintf(locBuff, sizeof(locBuff), "pointLights[%d].constant", i);
-		uniformPointLight[i].uniformConstant = glGetUniformLocation(shaderID, locBuff);
-
-		snprintf(locBuff, sizeof(locBuff), "pointLights[%d].linear", i);
-		uniformPointLight[i].uniformLinear = glGetUniformLocation(shaderID, locBuff);
-
-		snprintf(locBuff, sizeof(locBuff), "pointLights[%d].exponent", i);
-		uniformPointLight[i].uniformExponent = glGetUniformLocation(shaderID, locBuff);
-	}
-
-	uniformSpotLightCount = glGetUniformLocation(shaderID, "spotLightCount");
-
-	for (size_t i = 0; i < MAX_SPOT_LIGHTS; i++)
-	{
-		char locBuff[100] = { '\0' };
-
-		snprintf(locBuff, sizeof(locBuff), "spotLights[%d].base.base.colour", i);
-		uniformSpotLight[i].uniformColour = glGetUniformLocation(shaderID, locBuff);
-
-		snprintf(locBuff, sizeof(locBuff), "spotLights[%d].base.base.ambientIntensity", i);
-		uniformSpotLight[i].uniformAmbientIntensity = glGetUniformLocation(shaderID, locBuff);
-
-		snprintf(locBuff, sizeof(locBuff), "spotLights[%d].base.base.diffuseIntensity", i);
-		uniformSpotLight[i].uniformDiffuseIntensity = glGetUniformLocation(shaderID, locBuff);
-
-		snprintf(locBuff, sizeof(locBuff), "spotLights[%d].base.position", i);
-		uniformSpotLight[i].uniformPosition = glGetUniformLocation(shaderID, locBuff);
-
-		snprintf(locBuff, sizeof(locBuff), "spotLights[%d].base.constant", i);
-		uniformSpotLight[i].uniformConstant = glGetUniformLocation(shaderID, locBuff);
-
-		snprintf(locBuff, sizeof(locBuff), "spotLights[%d].base.linear", i);
-		uniformSpotLight[i].uniformLinear = glGetUniformLocation(shaderID, locBuff);
-
-		snprintf(locBuff, sizeof(locBuff), "spotLights[%d].base.exponent", i);
-		uniformSpotLight[i].uniformExponent = glGetUniformLocation(shaderID, locBuff);
-
-		snprintf(locBuff, sizeof(locBuff), "spotLights[%d].direction", i);
-		uniformSpotLight[i].uniformDirection = glGetUniformLocation(shaderID, locBuff);
-
-		snprintf(locBuff, sizeof(locBuff), "spotLights[%d].edge", i);
-		uniformSpotLight[i].uniformEdge = glGetUniformLocation(shaderID, locBuff);
-	}
-
-	uniformDirectionalLightTransform = glGetUniformLocation(shaderID, "directionalLightTransform");
-	uniformTexture = glGetUniformLocation(shaderID, "theTexture");
-	uniformDirectionalShadowMap = glGetUniformLocation(shaderID, "directionalShadowMap");
-
-	uniformOmniLightPos = glGetUniformLocation(shaderID, "lightPos");
-	uniformFarPlane = glGetUniformLocation(shaderID, "farPlane");
-
-	for (size_t i = 0; i < 6; i++)
-	{
-		char locBuff[100] = { '\0' };
-
-		snprintf(locBuff, sizeof(locBuff), "lightMatrices[%d]", i);
-		uniformLightMatrices[i] = glGetUniformLocation(shaderID, locBuff);
-	}
-
-	for (size_t i = 0; i < MAX_POINT_LIGHTS + MAX_SPOT_LIGHTS; i++)
-	{
-		char locBuff[100] = { '\0' };
-
-		snprintf(locBuff, sizeof(locBuff), "omniShadowMaps[%d].shadowMap", i);
-		uniformOmniShadowMap[i].shadowMap = glGetUniformLocation(shaderID, locBuff);
-
-		snprintf(locBuff, sizeof(locBuff), "omniShadowMaps[%d].farPlane", i);
-		uniformOmniShadowMap[i].farPlane = glGetUniformLocation(shaderID, locBuff);
-	}
-}
-
-GLuint Shader::GetProjectionLocation()
-{
-	return uniformProjection;
-}
-GLuint Shader::GetModelLocation()
-{
-	return uniformModel;
-}
-GLuint Shader::GetViewLocation()
-{
-	return uniformView;
-}
-GLuint Shader::GetAmbientColourLocation()
-{
-	return uniformDirectionalLight.uniformColour;
-}
-GLuint Shader::GetAmbientIntensityLocation()
-{
-	return uniformDirectionalLight.uniformAmbientIntensity;
-}
-GLuint Shader::GetDiffuseIntensityLocation()
-{
-	return uniformDirectionalLight.uniformDiffuseIntensity;
-}
-GLuint Shader::GetDirectionLocation()
-{
-	return uniformDirectionalLight.uniformDirection;
-}
-GLuint Shader::GetSpecularIntensityLocation()
-{
-	return uniformSpecularIntensity;
-}
-GLuint Shader::GetShininessLocation()
-{
-	return uniformShininess;
-}
-GLuint Shader::GetEyePositionLocation()
-{
-	return uniformEyePosition;
-}
-GLuint Shader::GetOmniLightPosLocation()
-{
-	return uniformOmniLightPos;
-}
-GLuint Shader::GetFarPlaneLocation()
-{
-	return uniformFarPlane;
-}
-
-void Shader::SetDirectionalLight(DirectionalLight * dLight)
-{
-	dLight->UseLight(uniformDirectionalLight.uniformAmbientIntensity, uniformDirectionalLight.uniformColour,
-		uniformDirectionalLight.uniformDiffuseIntensity, uniformDirectionalLight.uniformDirection);
-}
-
-void Shader::SetPointLights(PointLight * pLight, unsigned int lightCount, unsigned int textureUnit, unsigned int offset)
-{
-	if (lightCount > MAX_POINT_LIGHTS) lightCount = MAX_POINT_LIGHTS;
-
-	glUniform1i(uniformPointLightCount, lightCount);
-
-	for (size_t i = 0; i < lightCount; i++)
-	{
-		pLight[i].UseLight(uniformPointLight[i].uniformAmbientIntensity, uniformPointLight[i].uniformColour,
-			uniformPointLight[i].uniformDiffuseIntensity, uniformPointLight[i].uniformPosition,
-			uniformPointLight[i].uniformConstant, uniformPointLight[i].uniformLinear, uniformPointLight[i].uniformExponent);
-
-		pLight[i].getShadowMap()->Read(GL_TEXTURE0 + textureUnit + i);
-		glUniform1i(uniformOmniShadowMap[i + offset].shadowMap, textureUnit + i);
-		glUniform1f(uniformOmniShadowMap[i + offset].farPlane, pLight[i].GetFarPlane());
-	}
-}
-
-void Shader::SetSpotLights(SpotLight * sLight, unsigned int lightCount, unsigned int textureUnit, unsigned int offset)
-{
-	if (lightCount > MAX_SPOT_LIGHTS) lightCount = MAX_SPOT_LIGHTS;
-
-	glUniform1i(uniformSpotLightCount, lightCount);
-
-	for (size_t i = 0; i < lightCount; i++)
-	{
-		sLight[i].UseLight(uniformSpotLight[i].uniformAmbientIntensity, uniformSpotLight[i].uniformColour,
-			uniformSpotLight[i].uniformDiffuseIntensity, uniformSpotLight[i].uniformPosition, uniformSpotLight[i].uniformDirection,
-			uniformSpotLight[i].uniformConstant, uniformSpotLight[i].uniformLinear, uniformSpotLight[i].uniformExponent,
-			uniformSpotLight[i].uniformEdge);
-
-		sLight[i].getShadowMap()->Read(GL_TEXTURE0 + textureUnit + i);
-		glUniform1i(uniformOmniShadowMap[i + offset].shadowMap, textureUnit + i);
-		glUniform1f(uniformOmniShadowMap[i + offset].farPlane, sLight[i].GetFarPlane());
-	}
-}
-
-void Shader::SetTexture(GLuint textureUnit)
-{
-	glUniform1i(uniformTexture, textureUnit);
-}
-
-void Shader::SetDirectionalShadowMap(GLuint textureUnit)
-{
-	glUniform1i(uniformDirectionalShadowMap, textureUnit);
-}
-
-void Shader::SetDirectionalLightTransform(glm::mat4* lTransform)
-{
-	glUniformMatrix4fv(uniformDirectionalLightTransform, 1, GL_FALSE, glm::value_ptr(*lTransform));
-}
-
-void Shader::SetLightMatrices(std::vector<glm::mat4> lightMatrices)
-{
-	for (size_t i = 0; i < 6; i++)
-	{
-		glUniformMatrix4fv(uniformLightMatrices[i], 1, GL_FALSE, glm::value_ptr(lightMatrices[i]));
-	}
-}
-
-void Shader::UseShader()
-{
-	glUseProgram(shaderID);
-}
-
-void Shader::ClearShader()
-{
-	if (shaderID != 0)
-	{
-		glDeleteProgram(shaderID);
-		shaderID = 0;
-	}
-
-	uniformModel = 0;
-	uniformProjection = 0;
-}
-
-
-void Shader::AddShader(GLuint theProgram, const char* shaderCode, GLenum shaderType)
-{
-	GLuint theShader = glCreateShader(shaderType);
-
-	const GLchar* theCode[1];
-	theCode[0] = shaderCode;
-
-	GLint codeLength[1];
-	codeLength[0] = strlen(shaderCode);
-
-	glShaderSource(theShader, 1, theCode, codeLength);
-	glCompileShader(theShader);
-
-	GLint result = 0;
-	GLchar eLog[1024] = { 0 };
-
-	glGetShaderiv(theShader, GL_COMPILE_STATUS, &result);
-	if (!result)
-	{
-		glGetShaderInfoLog(theShader, sizeof(eLog), NULL, eLog);
-		printf("Error compiling the %d shader: '%s'\n", shaderType, eLog);
-		return;
-	}
-
-	glAttachShader(theProgram, theShader);
-}
-
-Shader::~Shader()
-{
-	ClearShader();
-}
+#include "Shader.h"
+
+std::unordered_map<unsigned long long, GLuint> Shader::programCache;
+
+// Sizes and constants the C++ side lays data out by, so the shaders never keep a copy of their own.
+// Only integers are formatted, a float through %f would pick up the locale's decimal comma
+static std::string CommonDefines()
+{
+	char buffer[512];
+	snprintf(buffer, sizeof(buffer),
+		"#define MAX_POINT_LIGHTS %d\n#define MAX_SPOT_LIGHTS %d\n#define MAX_SHADOW_CASCADES %d\n"
+		"#define EVSM_POSITIVE_EXPONENT %d.0\n#define EVSM_NEGATIVE_EXPONENT %d.0\n#define MOMENTS_MAX_LEVEL %d\n",
+		MAX_POINT_LIGHTS, MAX_SPOT_LIGHTS, MAX_SHADOW_CASCADES, EVSM_POSITIVE_EXPONENT, EVSM_NEGATIVE_EXPONENT, MOMENTS_MAX_LEVEL);
+	return buffer;
+}
+
+Shader::Shader()
+{
+	shaderID = 0;
+	uniformModel = 0;
+	uniformNormalMatrix = 0;
+}
+
+void Shader::AddDefine(const char* name)
+{
+	defines += "#define ";
+	defines += name;
+	defines += "\n";
+}
+
+void Shader::AddDefine(const char* name, int value)
+{
+	defines += "#define ";
+	defines += name;
+	defines += " " + std::to_string(value) + "\n";
+}
+
+void Shader::CreateFromString(const char* vertexCode, const char* fragmentCode)
+{
+	CompileShader(vertexCode, fragmentCode);
+}
+
+void Shader::CreateFromFiles(const char* vertexLocation, const char* fragmentLocation)
+{
+	std::string vertexString = ReadFile(vertexLocation);
+	std::string fragmentString = ReadFile(fragmentLocation);
+	const char* vertexCode = vertexString.c_str();
+	const char* fragmentCode = fragmentString.c_str();
+
+	CompileShader(vertexCode, fragmentCode);
+}
+
+void Shader::CreateFromFiles(const char* vertexLocation, const char* geometryLocation, const char* fragmentLocation)
+{
+	std::string vertexString = ReadFile(vertexLocation);
+	std::string geometryString = ReadFile(geometryLocation);
+	std::string fragmentString = ReadFile(fragmentLocation);
+	const char* vertexCode = vertexString.c_str();
+	const char* geometryCode = geometryString.c_str();
+	const char* fragmentCode = fragmentString.c_str();
+
+	CompileShader(vertexCode, geometryCode, fragmentCode);
+}
+
+void Shader::CreateComputeFromFile(const char* computeLocation)
+{
+	std::string computeString = ReadFile(computeLocation);
+	const char* computeCode = computeString.c_str();
+
+	CompileComputeShader(computeCode);
+}
+
+std::string Shader::ReadFile(const char* fileLocation)
+{
+	std::set<std::string> included;
+	return ReadSource(fileLocation, included);
+}
+
+std::string Shader::ReadSource(const std::string& fileLocation, std::set<std::string>& included)
+{
+	std::string content;
+	std::ifstream fileStream(fileLocation, std::ios::in);
+
+	if (!fileStream.is_open()) {
+		printf("Failed to read %s! File doesn't exist.", fileLocation.c_str());
+		return "";
+	}
+
+	included.insert(fileLocation);
+	std::string directory = fileLocation.substr(0, fileLocation.find_last_of("/\\") + 1);
+
+	std::string line = "";
+	while (!fileStream.eof())
+	{
+		std::getline(fileStream, line);
+
+		size_t nameStart = line.find('"');
+		size_t nameEnd = line.find('"', nameStart + 1);
+		if (line.compare(0, 8, "#include") == 0 && nameStart != std::string::npos && nameEnd != std::string::npos)
+		{
+			std::string includeLocation = directory + line.substr(nameStart + 1, nameEnd - nameStart - 1);
+			if (included.count(includeLocation) == 0)
+			{
+				content.append(ReadSource(includeLocation, included));
+			}
+			continue;
+		}
+
+		content.append(line + "\n");
+	}
+
+	fileStream.close();
+	return content;
+}
+
+// FNV-1a over the defines and every stage, so the same sources built with the same defines share one program
+unsigned long long Shader::PermutationHash(const char* codes[], int codeCount)
+{
+	unsigned long long hash = 14695981039346656037ull;
+	auto addBytes = [&hash](const char* bytes, size_t length) {
+		for (size_t i = 0; i < length; i++)
+		{
+			hash = (hash ^ (unsigned char)bytes[i]) * 1099511628211ull;
+		}
+	};
+
+	addBytes(defines.c_str(), defines.size() + 1);
+	for (int i = 0; i < codeCount; i++)
+	{
+		addBytes(codes[i], strlen(codes[i]) + 1);
+	}
+
+	return hash;
+}
+
+bool Shader::FindCachedProgram(unsigned long long hash)
+{
+	auto cached = programCache.find(hash);
+	if (cached == programCache.end())
+	{
+		return false;
+	}
+
+	shaderID = cached->second;
+	GetUniformLocations();
+	return true;
+}
+
+void Shader::CompileShader(const char* vertexCode, const char* fragmentCode)
+{
+	const char* codes[] = { vertexCode, fragmentCode };
+	unsigned long long hash = PermutationHash(codes, 2);
+	if (FindCachedProgram(hash))
+	{
+		return;
+	}
+
+	shaderID = glCreateProgram();
+
+	if (!shaderID)
+	{
+		printf("Error creating shader program!\n");
+		return;
+	}
+
+	AddShader(shaderID, vertexCode, GL_VERTEX_SHADER);
+	AddShader(shaderID, fragmentCode, GL_FRAGMENT_SHADER);
+
+	if (CompileProgram())
+	{
+		programCache[hash] = shaderID;
+	}
+}
+
+void Shader::CompileShader(const char* vertexCode, const char* geometryCode, const char* fragmentCode)
+{
+	const char* codes[] = { vertexCode, geometryCode, fragmentCode };
+	unsigned long long hash = PermutationHash(codes, 3);
+	if (FindCachedProgram(hash))
+	{
+		return;
+	}
+
+	shaderID = glCreateProgram();
+
+	if (!shaderID)
+	{
+		printf("Error creating shader program!\n");
+		return;
+	}
+
+	AddShader(shaderID, vertexCode, GL_VERTEX_SHADER);
+	AddShader(shaderID, geometryCode, GL_GEOMETRY_SHADER);
+	AddShader(shaderID, fragmentCode, GL_FRAGMENT_SHADER);
+
+	if (CompileProgram())
+	{
+		programCache[hash] = shaderID;
+	}
+}
+
+void Shader::CompileComputeShader(const char* computeCode)
+{
+	const char* codes[] = { computeCode };
+	unsigned long long hash = PermutationHash(codes, 1);
+	if (FindCachedProgram(hash))
+	{
+		return;
+	}
+
+	shaderID = glCreateProgram();
+
+	if (!shaderID)
+	{
+		printf("Error creating shader program!\n");
+		return;
+	}
+
+	AddShader(shaderID, computeCode, GL_COMPUTE_SHADER);
+
+	if (CompileProgram())
+	{
+		programCache[hash] = shaderID;
+	}
+}
+
+void Shader::Validate()
+{
+	GLint result = 0;
+	GLchar eLog[1024] = { 0 };
+
+	glValidateProgram(shaderID);
+	glGetProgramiv(shaderID, GL_VALIDATE_STATUS, &result);
+	if (!result)
+	{
+		glGetProgramInfoLog(shaderID, sizeof(eLog), NULL, eLog);
+		printf("Error validating program: '%s'\n", eLog);
+		return;
+	}
+}
+
+bool Shader::CompileProgram() {
+
+	PROFILE_ZONE("Shader::CompileProgram");
+
+	GLint result = 0;
+	GLchar eLog[1024] = { 0 };
+
+	glLinkProgram(shaderID);
+	glGetProgramiv(shaderID, GL_LINK_STATUS, &result);
+	if (!result)
+	{
+		glGetProgramInfoLog(shaderID, sizeof(eLog), NULL, eLog);
+		printf("Error linking program: '%s'\n", eLog);
+		return false;
+	}
+
+	// Camera, lights and shadow matrices come from the shared uniform blocks
+	FrameUniforms::BindBlocks(shaderID);
+
+	GetUniformLocations();
+	return true;
+}
+
+void Shader::GetUniformLocations()
+{
+	uniformModel = glGetUniformLocation(shaderID, "model");
+	uniformNormalMatrix = glGetUniformLocation(shaderID, "normalMatrix");
+	uniformSpecularIntensity = glGetUniformLocation(shaderID, "material.specularIntensity");
+	uniformShininess = glGetUniformLocation(shaderID, "material.shininess");
+	uniformTexture = glGetUniformLocation(shaderID, "theTexture");
+	uniformDirectionalShadowMap = glGetUniformLocation(shaderID, "directionalShadowMap");
+	uniformShadowAtlas = glGetUniformLocation(shaderID, "shadowAtlas");
+	uniformLightData = glGetUniformLocation(shaderID, "lightData");
+	uniformClusterRanges = glGetUniformLocation(shaderID, "clusterRanges");
+	uniformClusterLightIndices = glGetUniformLocation(shaderID, "clusterLightIndices");
+	uniformGAlbedo = glGetUniformLocation(shaderID, "gAlbedo");
+	uniformGNormal = glGetUniformLocation(shaderID, "gNormal");
+	uniformGMaterial = glGetUniformLocation(shaderID, "gMaterial");
+	uniformGDepth = glGetUniformLocation(shaderID, "gDepth");
+	uniformDirectionalMoments = glGetUniformLocation(shaderID, "directionalMoments");
+	uniformAtlasMoments = glGetUniformLocation(shaderID, "atlasMoments");
+}
+
+GLuint Shader::GetModelLocation()
+{
+	return uniformModel;
+}
+GLuint Shader::GetNormalMatrixLocation()
+{
+	return uniformNormalMatrix;
+}
+GLuint Shader::GetSpecularIntensityLocation()
+{
+	return uniformSpecularIntensity;
+}
+GLuint Shader::GetShininessLocation()
+{
+	return uniformShininess;
+}
+GLint Shader::GetUniformLocation(const char* name)
+{
+	return glGetUniformLocation(shaderID, name);
+}
+
+void Shader::SetTexture(GLuint textureUnit)
+{
+	glUniform1i(uniformTexture, textureUnit);
+}
+
+void Shader::SetDirectionalShadowMap(GLuint textureUnit)
+{
+	glUniform1i(uniformDirectionalShadowMap, textureUnit);
+}
+
+void Shader::SetShadowAtlas(GLuint textureUnit)
+{
+	glUniform1i(uniformShadowAtlas, textureUnit);
+}
+
+void Shader::SetLightClusters(GLuint textureUnit)
+{
+	glUniform1i(uniformLightData, textureUnit);
+	glUniform1i(uniformClusterRanges, textureUnit + 1);
+	glUniform1i(uniformClusterLightIndices, textureUnit + 2);
+}
+
+void Shader::SetGBuffer(GLuint textureUnit)
+{
+	glUniform1i(uniformGAlbedo, textureUnit);
+	glUniform1i(uniformGNormal, textureUnit + 1);
+	glUniform1i(uniformGMaterial, textureUnit + 2);
+	glUniform1i(uniformGDepth, textureUnit + 3);
+}
+
+void Shader::SetShadowMoments(GLuint textureUnit)
+{
+	glUniform1i(uniformDirectionalMoments, textureUnit);
+	glUniform1i(uniformAtlasMoments, textureUnit + 1);
+}
+
+void Shader::UseShader()
+{
+	glUseProgram(shaderID);
+}
+
+// The program itself stays in the cache for any other Shader built the same way
+void Shader::ClearShader()
+{
+	shaderID = 0;
+	uniformModel = 0;
+}
+
+
+void Shader::AddShader(GLuint theProgram, const char* shaderCode, GLenum shaderType)
+{
+	PROFILE_ZONE("Shader::AddShader");
+
+	GLuint theShader = glCreateShader(shaderType);
+
+	// Defines go straight after the #version line, which has to stay first
+	const char* versionEnd = strchr(shaderCode, '\n');
+	GLint versionLength = versionEnd ? (GLint)(versionEnd - shaderCode + 1) : 0;
+
+	static const std::string commonDefines = CommonDefines();
+
+	const GLchar* theCode[4];
+	theCode[0] = shaderCode;
+	theCode[1] = commonDefines.c_str();
+	theCode[2] = defines.c_str();
+	theCode[3] = shaderCode + versionLength;
+
+	GLint codeLength[4];
+	codeLength[0] = versionLength;
+	codeLength[1] = commonDefines.size();
+	codeLength[2] = defines.size();
+	codeLength[3] = strlen(shaderCode) - versionLength;
+
+	glShaderSource(theShader, 4, theCode, codeLength);
+	glCompileShader(theShader);
+
+	GLint result = 0;
+	GLchar eLog[1024] = { 0 };
+
+	glGetShaderiv(theShader, GL_COMPILE_STATUS, &result);
+	if (!result)
+	{
+		glGetShaderInfoLog(theShader, sizeof(eLog), NULL, eLog);
+		printf("Error compiling the %d shader: '%s'\n", shaderType, eLog);
+		return;
+	}
+
+	glAttachShader(theProgram, theShader);
+}
+
+Shader::~Shader()
+{
+	ClearShader();
+}
@@ -1,119 +1,95 @@
-#pragma once
-
-#include <stdio.h>
-#include <string>
-#include <iostream>
-#include <fstream>
-
-#include <GL\glew.h>
-
-#include <glm\glm.hpp>
-#include <glm\gtc\matrix_transform.hpp>
-#include <glm\gtc\type_ptr.hpp>
-
-#include "CommonValues.h"
-
-#include "DirectionalLight.h"
-#include "PointLight.h"
-#include "SpotLight.h"
-
-class Shader
-{
-public:
-	Shader();
-
-	void CreateFromString(const char* vertexCode, const char* fragmentCode);
-	void CreateFromFiles(const char* vertexLocation, const char* fragmentLocation);
-	void CreateFromFiles(const char* vertexLocation, const char* geometryLocation, const char* fragmentLocation);
-
-	void Validate();
-
-	std::string ReadFile(const char* fileLocation);
-
-	GLuint GetProjectionLocation();
-	GLuint GetModelLocation();
-	GLuint GetViewLocation();
-	GLuint GetAmbientIntensityLocation();
-	GLuint GetAmbientColourLocation();
-	GLuint GetDiffuseIntensityLocation();
-	GLuint GetDirectionLocation();
-	GLuint GetSpecularIntensityLocation();
-	GLuint GetShininessLocation();
-	GLuint GetEyePositionLocation();
-	GLuint GetOmniLightPosLocation();
-	GLuint GetFarPlaneLocation();
-
-	void SetDirectionalLight(DirectionalLight * dLight);
-	void SetPointLights(PointLight * pLight, unsigned int lightCount, unsigned int textureUnit, unsigned int offset);
-	void SetSpotLights(SpotLight * sLight, unsigned int lightCount, unsigned int textureUnit, unsigned int offset);
-	void SetTexture(GLuint textureUnit);
-	void SetDirectionalShadowMap(GLuint textureUnit);
-	void SetDirectionalLightTransform(glm::mat4* lTransform);
-	void SetLightMatrices(std::vector<glm::mat4> lightMatrices);
-
-	void UseShader();
-	void ClearShader();
-
-	~Shader();
-
-private:
-	int pointLightCount;
-	int spotLightCount;
-
-	GLuint shaderID, uniformProjection, uniformModel, uniformView, uniformEyePosition,
-		uniformSpecularIntensity, uniformShininess, 
-		uniformTexture, uniformDirectionalShadowMap, 
-		uniformDirectionalLightTransform,
-		uniformOmniLightPos, uniformFarPlane;
-	
-	GLuint uniformLightMatrices[6];
-
-	struct {
-		GLuint uniformColour;
-		GLuint uniformAmbientIntensity;
-		GLuint uniformDiffuseIntensity;
-
-		GLuint uniformDirection;
-	} uniformDirectionalLight;
-
-	GLuint uniformPointLightCount;
-
-	struct {
-		GLuint uniformColour;
-		GLuint uniformAmbientIntensity;
-		GLuint uniformDiffuseIntensity;
-
-		GLuint uniformPosition;
-		GLuint uniformConstant;
-		GLuint uniformLinear;
-		GLuint uniformExponent;
-	} uniformPointLight[MAX_POINT_LIGHTS];
-
-	GLuint uniformSpotLightCount;
-
-	struct {
-		GLuint uniformColour;
-		GLuint uniformAmbientIntensity;
-		GLuint uniformDiffuseIntensity;
-
-		GLuint uniformPosition;
-		GLuint uniformConstant;
-		GLuint uniformLinear;
-		GLuint uniformExponent;
-
-		GLuint uniformDirection;
-		GLuint uniformEdge;
-	} uniformSpotLight[MAX_SPOT_LIGHTS];
-
-	struct {
-		GLuint shadowMap;
-		GLuint farPlane;
-	} uniformOmniShadowMap[MAX_POINT_LIGHTS + MAX_SPOT_LIGHTS];
-
-	void CompileShader(const char* vertexCode, const char* fragmentCode);
-	void CompileShader(const char* vertexCode, const char* geometryCode, const char* fragmentCode);
-	void AddShader(GLuint theProgram, const char* shaderCode, GLenum shaderType);
-
-	void CompileProgram();
-};
-
+#pragma once
+
+#include <stdio.h>
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <set>
+#include <unordered_map>
+
+#include <GL\glew.h>
+
+#include <glm\glm.hpp>
+#include <glm\gtc\matrix_transform.hpp>
+#include <glm\gtc\type_ptr.hpp>
+
+#include "CommonValues.h"
+#include "CpuProfiler.h"
+
+#include "DirectionalLight.h"
+#include "PointLight.h"
+#include "SpotLight.h"
+#include "FrameUniforms.h"
+
+class Shader
+{
+public:
+	Shader();
+
+	// Prepended to every stage compiled afterwards, for building variants of one source.
+	// The constants of CommonValues.h are defined for every stage ahead of these
+	void AddDefine(const char* name);
+	void AddDefine(const char* name, int value);
+
+	void CreateFromString(const char* vertexCode, const char* fragmentCode);
+	void CreateFromFiles(const char* vertexLocation, const char* fragmentLocation);
+	void CreateFromFiles(const char* vertexLocation, const char* geometryLocation, const char* fragmentLocation);
+	void CreateComputeFromFile(const char* computeLocation);
+
+	void Validate();
+
+	// Splices in #include "file" lines, relative to the including file and each file only once
+	std::string ReadFile(const char* fileLocation);
+
+	GLuint GetModelLocation();
+	GLuint GetNormalMatrixLocation();
+	GLuint GetSpecularIntensityLocation();
+	GLuint GetShininessLocation();
+	// For uniforms of programs outside the lighting set, such as compute shaders
+	GLint GetUniformLocation(const char* name);
+
+	// Light data itself lives in the Lights uniform block, programs only need the shadow map samplers
+	void SetTexture(GLuint textureUnit);
+	void SetDirectionalShadowMap(GLuint textureUnit);
+	void SetShadowAtlas(GLuint textureUnit);
+	// The light, cluster range and light index textures on three units from textureUnit
+	void SetLightClusters(GLuint textureUnit);
+	// The deferred lighting pass's albedo, normal, material and depth on four units from textureUnit
+	void SetGBuffer(GLuint textureUnit);
+	// The cascades' moments on textureUnit, the atlas's on the next one
+	void SetShadowMoments(GLuint textureUnit);
+
+	void UseShader();
+	void ClearShader();
+
+	// Programs are shared by every Shader built from the same sources and defines, and live as long as the context
+	static size_t GetProgramCacheSize() { return programCache.size(); }
+
+	~Shader();
+
+private:
+	GLuint shaderID, uniformModel, uniformNormalMatrix,
+		uniformSpecularIntensity, uniformShininess, 
+		uniformTexture, uniformDirectionalShadowMap, uniformShadowAtlas,
+		uniformLightData, uniformClusterRanges, uniformClusterLightIndices,
+		uniformGAlbedo, uniformGNormal, uniformGMaterial, uniformGDepth,
+		uniformDirectionalMoments, uniformAtlasMoments;
+
+	std::string defines;
+
+	// Linked programs by a hash of their defines and preprocessed stages
+	static std::unordered_map<unsigned long long, GLuint> programCache;
+
+	std::string ReadSource(const std::string& fileLocation, std::set<std::string>& included);
+	unsigned long long PermutationHash(const char* codes[], int codeCount);
+	bool FindCachedProgram(unsigned long long hash);
+
+	void CompileShader(const char* vertexCode, const char* fragmentCode);
+	void CompileShader(const char* vertexCode, const char* geometryCode, const char* fragmentCode);
+	void CompileComputeShader(const char* computeCode);
+	void AddShader(GLuint theProgram, const char* shaderCode, GLenum shaderType);
+
+	bool CompileProgram();
+	void GetUniformLocations();
+};
+
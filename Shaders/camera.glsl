@@ -0,0 +1,7 @@
+// Filled once a frame by FrameUniforms::SetCamera
+layout (std140) uniform Camera
+{
+	mat4 projection;
+	mat4 view;
+	vec3 eyePosition;
+};
@@ -0,0 +1,15 @@
+#version 330
+
+layout (location = 0) in vec3 pos;
+
+uniform mat4 model;
+#include "camera.glsl"
+
+// The lit pass tests against this depth with GL_EQUAL, so gl_Position has to come out bit for bit the same as
+// shader.vert's: same expression, and invariant in both
+invariant gl_Position;
+
+void main()
+{
+	gl_Position = projection * view * model * vec4(pos, 1.0);
+}
@@ -0,0 +1,27 @@
+#version 430
+
+layout (location = 0) in vec3 pos;
+layout (location = 3) in uint objectIndex;
+
+struct ObjectTransform
+{
+	mat4 worldMatrix;
+	mat4 normalMatrix;
+};
+
+layout (std430, binding = 0) readonly buffer ObjectTransforms
+{
+	ObjectTransform transforms[];
+};
+
+#include "camera.glsl"
+
+// Must match shader_indirect.vert, see depth_prepass.vert
+invariant gl_Position;
+
+void main()
+{
+	mat4 worldMatrix = transforms[objectIndex].worldMatrix;
+
+	gl_Position = projection * view * worldMatrix * vec4(pos, 1.0);
+}
@@ -0,0 +1,14 @@
+#version 330
+
+layout (location = 0) in vec3 pos;
+layout (location = 3) in mat4 instanceModel;
+
+#include "camera.glsl"
+
+// Must match shader_instanced.vert, see depth_prepass.vert
+invariant gl_Position;
+
+void main()
+{
+	gl_Position = projection * view * instanceModel * vec4(pos, 1.0);
+}
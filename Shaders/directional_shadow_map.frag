@@ -1,5 +1,5 @@
-#version 330
-
-void main()
-{
+#version 330
+
+void main()
+{
 }
\ No newline at end of file
@@ -1,11 +1,15 @@
-#version 330
-
-layout (location = 0) in vec3 pos;
-
-uniform mat4 model;
-uniform mat4 directionalLightTransform;
-
-void main()
-{
-	gl_Position = directionalLightTransform * model * vec4(pos, 1.0);
-}
+#version 330
+
+layout (location = 0) in vec3 pos;
+
+uniform mat4 model;
+// The cascade or spot light being drawn
+layout (std140) uniform ShadowView
+{
+	mat4 lightTransform;
+};
+
+void main()
+{
+	gl_Position = lightTransform * model * vec4(pos, 1.0);
+}
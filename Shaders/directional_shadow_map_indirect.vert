@@ -0,0 +1,26 @@
+#version 430
+
+layout (location = 0) in vec3 pos;
+layout (location = 3) in uint objectIndex;
+
+struct ObjectTransform
+{
+	mat4 worldMatrix;
+	mat4 normalMatrix;
+};
+
+layout (std430, binding = 0) readonly buffer ObjectTransforms
+{
+	ObjectTransform transforms[];
+};
+
+// The cascade or spot light being drawn
+layout (std140) uniform ShadowView
+{
+	mat4 lightTransform;
+};
+
+void main()
+{
+	gl_Position = lightTransform * transforms[objectIndex].worldMatrix * vec4(pos, 1.0);
+}
@@ -0,0 +1,15 @@
+#version 330
+
+layout (location = 0) in vec3 pos;
+layout (location = 3) in mat4 instanceModel;
+
+// The cascade or spot light being drawn
+layout (std140) uniform ShadowView
+{
+	mat4 lightTransform;
+};
+
+void main()
+{
+	gl_Position = lightTransform * instanceModel * vec4(pos, 1.0);
+}
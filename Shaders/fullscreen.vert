@@ -0,0 +1,8 @@
+#version 330
+
+void main()
+{
+	// Vertices 0, 1 and 2 at (-1,-1), (3,-1) and (-1,3), one triangle that covers the whole viewport
+	vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+	gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,32 @@
+#version 330
+
+in vec4 vCol;
+in vec2 TexCoord;
+in vec3 Normal;
+in vec3 FragPos;
+
+// Must match the GBuffer's colour attachments
+layout (location = 0) out vec4 gAlbedo;
+layout (location = 1) out vec2 gNormal;
+layout (location = 2) out vec2 gMaterial;
+
+struct Material
+{
+	float specularIntensity;
+	float shininess;
+};
+
+uniform sampler2D theTexture;
+
+uniform Material material;
+
+#include "normal_encoding.glsl"
+
+void main()
+{
+	gAlbedo = texture(theTexture, TexCoord);
+	gNormal = EncodeNormal(normalize(Normal));
+	
+	// Intensities up to 8, shininess logarithmically up to 2047
+	gMaterial = vec2(material.specularIntensity / 8.0, log2(material.shininess + 1.0) / 11.0);
+}
@@ -0,0 +1,26 @@
+#version 330
+
+layout (location = 0) in vec3 pos;
+
+uniform mat4 model;
+
+layout (std140) uniform OmniShadow
+{
+	mat4 lightMatrices[6];
+	vec3 lightPos;
+	float farPlane;
+};
+
+// The cube face being drawn
+layout (std140) uniform OmniShadowFace
+{
+	int face;
+};
+
+out vec4 FragPos;
+
+void main()
+{
+	FragPos = model * vec4(pos, 1.0);
+	gl_Position = lightMatrices[face] * FragPos;
+}
@@ -0,0 +1,36 @@
+#version 430
+
+layout (location = 0) in vec3 pos;
+layout (location = 3) in uint objectIndex;
+
+struct ObjectTransform
+{
+	mat4 worldMatrix;
+	mat4 normalMatrix;
+};
+
+layout (std430, binding = 0) readonly buffer ObjectTransforms
+{
+	ObjectTransform transforms[];
+};
+
+layout (std140) uniform OmniShadow
+{
+	mat4 lightMatrices[6];
+	vec3 lightPos;
+	float farPlane;
+};
+
+// The cube face being drawn
+layout (std140) uniform OmniShadowFace
+{
+	int face;
+};
+
+out vec4 FragPos;
+
+void main()
+{
+	FragPos = transforms[objectIndex].worldMatrix * vec4(pos, 1.0);
+	gl_Position = lightMatrices[face] * FragPos;
+}
@@ -0,0 +1,9 @@
+#version 330
+
+layout (location = 0) in vec3 pos;
+layout (location = 3) in mat4 instanceModel;
+
+void main()
+{
+	gl_Position = instanceModel * vec4(pos, 1.0);
+}
@@ -0,0 +1,28 @@
+#version 410
+#extension GL_ARB_shader_viewport_layer_array : require
+
+layout (location = 0) in vec3 pos;
+
+uniform mat4 model;
+
+layout (std140) uniform OmniShadow
+{
+	mat4 lightMatrices[6];
+	vec3 lightPos;
+	float farPlane;
+};
+
+// The cube face being drawn, routed to its atlas tile by gl_ViewportIndex
+layout (std140) uniform OmniShadowFace
+{
+	int face;
+};
+
+out vec4 FragPos;
+
+void main()
+{
+	FragPos = model * vec4(pos, 1.0);
+	gl_Position = lightMatrices[face] * FragPos;
+	gl_ViewportIndex = face;
+}
@@ -0,0 +1,27 @@
+#version 410
+#extension GL_ARB_shader_viewport_layer_array : require
+
+layout (location = 0) in vec3 pos;
+layout (location = 3) in mat4 instanceModel;
+
+layout (std140) uniform OmniShadow
+{
+	mat4 lightMatrices[6];
+	vec3 lightPos;
+	float farPlane;
+};
+
+// The cube face being drawn, routed to its atlas tile by gl_ViewportIndex
+layout (std140) uniform OmniShadowFace
+{
+	int face;
+};
+
+out vec4 FragPos;
+
+void main()
+{
+	FragPos = instanceModel * vec4(pos, 1.0);
+	gl_Position = lightMatrices[face] * FragPos;
+	gl_ViewportIndex = face;
+}
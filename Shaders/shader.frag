@@ -1,232 +1,574 @@
-#version 330
-
-in vec4 vCol;
-in vec2 TexCoord;
-in vec3 Normal;
-in vec3 FragPos;
-in vec4 DirectionalLightSpacePos;
-
-out vec4 colour;
-
-const int MAX_POINT_LIGHTS = 3;
-const int MAX_SPOT_LIGHTS = 3;
-
-struct Light
-{
-	vec3 colour;
-	float ambientIntensity;
-	float diffuseIntensity;
-};
-
-struct DirectionalLight 
-{
-	Light base;
-	vec3 direction;
-};
-
-struct PointLight
-{
-	Light base;
-	vec3 position;
-	float constant;
-	float linear;
-	float exponent;
-};
-
-struct SpotLight
-{
-	PointLight base;
-	vec3 direction;
-	float edge;
-};
-
-struct OmniShadowMap
-{
-	samplerCube shadowMap;
-	float farPlane;
-};
-
-struct Material
-{
-	float specularIntensity;
-	float shininess;
-};
-
-uniform int pointLightCount;
-uniform int spotLightCount;
-
-uniform DirectionalLight directionalLight;
-uniform PointLight pointLights[MAX_POINT_LIGHTS];
-uniform SpotLight spotLights[MAX_SPOT_LIGHTS];
-
-uniform sampler2D theTexture;
-uniform sampler2D directionalShadowMap;
-uniform OmniShadowMap omniShadowMaps[MAX_POINT_LIGHTS + MAX_SPOT_LIGHTS];
-
-uniform Material material;
-
-uniform vec3 eyePosition;
-
-vec3 sampleOffsetDirections[20] = vec3[]
-(
-   vec3( 1,  1,  1), vec3( 1, -1,  1), vec3(-1, -1,  1), vec3(-1,  1,  1), 
-   vec3( 1,  1, -1), vec3( 1, -1, -1), vec3(-1, -1, -1), vec3(-1,  1, -1),
-   vec3( 1,  1,  0), vec3( 1, -1,  0), vec3(-1, -1,  0), vec3(-1,  1,  0),
-   vec3( 1,  0,  1), vec3(-1,  0,  1), vec3( 1,  0, -1), vec3(-1,  0, -1),
-   vec3( 0,  1,  1), vec3( 0, -1,  1), vec3( 0, -1, -1), vec3( 0,  1, -1)
-); 
-
-float CalcDirectionalShadowFactor(DirectionalLight light)
-{
-	vec3 projCoords = DirectionalLightSpacePos.xyz / DirectionalLightSpacePos.w;
-	projCoords = (projCoords * 0.5) + 0.5;
-	
-	float current = projCoords.z;
-	
-	vec3 normal = normalize(Normal);
-	vec3 lightDir = normalize(directionalLight.direction);
-	
-	float bias = max(0.05 * (1.0 - dot(normal, lightDir)), 0.0005);
-
-	
-	float shadow = 0.0;
-	vec2 texelSize = 1.0 / textureSize(directionalShadowMap, 0);
-	for(int x = -1; x <= 1; ++x)
-	{
-		for(int y = -1; y <= 1; ++y)
-		{
-			float pcfDepth = texture(directionalShadowMap, projCoords.xy + vec2(x,y) * texelSize).r;
-			shadow += current - bias > pcfDepth ? 1.0 : 0.0;
-		}
-	}
-
-	shadow /= 9.0;
-	
-	if(projCoords.z > 1.0)
-	{
-		shadow = 0.0;
-	}									
-	
-	return shadow;
-}
-
-float CalcOmniShadowFactor(PointLight light, int shadowIndex)
-{
-	vec3 fragToLight = FragPos - light.position;
-	float currentDepth = length(fragToLight);
-	
-	float shadow = 0.0;
-	float bias = 0.05;
-	int samples = 20;
-	
-	float viewDistance = length(eyePosition - FragPos);
-	float diskRadius = (1.0 + (viewDistance/omniShadowMaps[shadowIndex].farPlane)) / 25.0;
-	
-	for(int i = 0; i < samples; i++)
-	{
-		float closestDepth = texture(omniShadowMaps[shadowIndex].shadowMap, fragToLight + sampleOffsetDirections[i] * diskRadius).r;
-		closestDepth *= omniShadowMaps[shadowIndex].farPlane;
-		if(currentDepth -  bias > closestDepth)
-		{
-			shadow += 1.0;
-		}
-	}
-	
-	
-	shadow /= float(samples);
-	return shadow;
-}
-
-vec4 CalcLightByDirection(Light light, vec3 direction, float shadowFactor)
-{
-	vec4 ambientColour = vec4(light.colour, 1.0f) * light.ambientIntensity;
-	
-	float diffuseFactor = max(dot(normalize(Normal), normalize(direction)), 0.0f);
-	vec4 diffuseColour = vec4(light.colour * light.diffuseIntensity * diffuseFactor, 1.0f);
-	
-	vec4 specularColour = vec4(0, 0, 0, 0);
-	
-	if(diffuseFactor > 0.0f)
-	{
-		vec3 fragToEye = normalize(eyePosition - FragPos);
-		vec3 reflectedVertex = normalize(reflect(direction, normalize(Normal)));
-		
-		float specularFactor = dot(fragToEye, reflectedVertex);
-		if(specularFactor > 0.0f)
-		{
-			specularFactor = pow(specularFactor, material.shininess);
-			specularColour = vec4(light.colour * material.specularIntensity * specularFactor, 1.0f);
-		}
-	}
-
-	return (ambientColour + (1.0 - shadowFactor) * (diffuseColour + specularColour));
-}
-
-vec4 CalcDirectionalLight()
-{
-	float shadowFactor = CalcDirectionalShadowFactor(directionalLight);
-	return CalcLightByDirection(directionalLight.base, directionalLight.direction, shadowFactor);
-}
-
-vec4 CalcPointLight(PointLight pLight, int shadowIndex)
-{
-	vec3 direction = FragPos - pLight.position;
-	float distance = length(direction);
-	direction = normalize(direction);
-	
-	float shadowFactor = CalcOmniShadowFactor(pLight, shadowIndex);
-	
-	vec4 colour = CalcLightByDirection(pLight.base, direction, shadowFactor);
-	float attenuation = pLight.exponent * distance * distance +
-						pLight.linear * distance +
-						pLight.constant;
-	
-	return (colour / attenuation);
-}
-
-vec4 CalcSpotLight(SpotLight sLight, int shadowIndex)
-{
-	vec3 rayDirection = normalize(FragPos - sLight.base.position);
-	float slFactor = dot(rayDirection, sLight.direction);
-	
-	if(slFactor > sLight.edge)
-	{
-		vec4 colour = CalcPointLight(sLight.base, shadowIndex);
-		
-		return colour * (1.0f - (1.0f - slFactor)*(1.0f/(1.0f - sLight.edge)));
-		
-	} else {
-		return vec4(0, 0, 0, 0);
-	}
-}
-
-vec4 CalcPointLights()
-{
-	vec4 totalColour = vec4(0, 0, 0, 0);
-	for(int i = 0; i < pointLightCount; i++)
-	{		
-		totalColour += CalcPointLight(pointLights[i], i);
-	}
-	
-	return totalColour;
-}
-
-vec4 CalcSpotLights()
-{
-	vec4 totalColour = vec4(0, 0, 0, 0);
-	for(int i = 0; i < spotLightCount; i++)
-	{		
-		totalColour += CalcSpotLight(spotLights[i], i + pointLightCount);
-	}
-	
-	return totalColour;
-}
-
-void main()
-{
-	vec4 finalColour = CalcDirectionalLight();
-	finalColour += CalcPointLights();
-	finalColour += CalcSpotLights();
-	
-	colour = texture(theTexture, TexCoord) * finalColour;
+#version 330
+
+// Compiled per frame's needs, see GetMainShaders in main.cpp. POINT_LIGHTS and SPOT_LIGHTS when the clusters hold any
+// of that type, POINT_SHADOWS when any point light has a shadow, SHADOW_MOMENTS to read the prefiltered moments
+// instead of filtering depth. MAX_POINT_LIGHTS, MAX_SPOT_LIGHTS and MAX_SHADOW_CASCADES come from CommonValues.h
+
+// Defined for the deferred lighting pass, which draws a full-screen triangle and reads the
+// surface back from the GBuffer instead of taking it from the vertex shader
+#ifdef DEFERRED_LIGHTING
+vec3 Normal;
+vec3 FragPos;
+#else
+in vec4 vCol;
+in vec2 TexCoord;
+in vec3 Normal;
+in vec3 FragPos;
+#endif
+
+out vec4 colour;
+
+struct Light
+{
+	vec3 colour;
+	float ambientIntensity;
+	float diffuseIntensity;
+};
+
+struct DirectionalLight 
+{
+	Light base;
+	vec3 direction;
+};
+
+struct PointLight
+{
+	Light base;
+	vec3 position;
+	float constant;
+	float linear;
+	float exponent;
+	float farPlane;
+};
+
+struct SpotLight
+{
+	PointLight base;
+	vec3 direction;
+	float edge;
+};
+
+// Unpacked from the five texels LightClusters stores per light
+struct ClusterLight
+{
+	SpotLight light;
+	float range;
+	int shadowIndex;
+};
+
+struct Material
+{
+	float specularIntensity;
+	float shininess;
+};
+
+#include "camera.glsl"
+
+// Point and spot lights are looked up per cluster, see LightClusters
+layout (std140) uniform Lights
+{
+	DirectionalLight directionalLight;
+	ivec4 clusterGrid;
+	vec4 clusterScale;
+	int shadowTaps;				// 1, 4, 8 or 20
+	float shadowTapDistance;	// 0 keeps every tap at any distance
+};
+
+// Atlas rects are corner, size and half a texel of the tile, all zero when the light got no tile
+struct PointShadow
+{
+	vec4 faceRects[6];
+};
+
+struct SpotShadow
+{
+	mat4 lightTransform;
+	vec4 atlasRect;
+	float nearPlane;
+	float farPlane;
+};
+
+// Cascade i covers view depths up to cascadeSplits[i]
+layout (std140) uniform ShadowTransforms
+{
+	mat4 cascadeTransforms[MAX_SHADOW_CASCADES];
+	vec4 cascadeSplits;
+	vec4 cascadeTexelSizes;
+	int cascadeCount;
+	PointShadow pointShadows[MAX_POINT_LIGHTS];
+	SpotShadow spotShadows[MAX_SPOT_LIGHTS];
+};
+
+uniform sampler2D theTexture;
+// Depth comparison samplers, each lookup returns how much of its 2x2 footprint is lit
+uniform sampler2DArrayShadow directionalShadowMap;
+uniform sampler2DShadow shadowAtlas;
+
+// EVSM moments of the cascades and of the atlas, see ShadowMoments
+uniform sampler2DArray directionalMoments;
+uniform sampler2DArray atlasMoments;
+
+uniform samplerBuffer lightData;
+uniform usamplerBuffer clusterRanges;
+uniform usamplerBuffer clusterLightIndices;
+
+#ifdef DEFERRED_LIGHTING
+uniform sampler2D gAlbedo;
+uniform sampler2D gNormal;
+uniform sampler2D gMaterial;
+uniform sampler2D gDepth;
+
+Material material;
+#else
+uniform Material material;
+#endif
+
+// Filter taps over the unit disk, ordered so the first 4 and the first 8 are each spread over the whole disk
+const vec2 poissonDisk[20] = vec2[]
+(
+	vec2(-0.923,  0.315), vec2( 0.912, -0.361), vec2(-0.369, -0.925), vec2( 0.373,  0.890),
+	vec2( 0.040,  0.017), vec2( 0.910,  0.383), vec2(-0.877, -0.400), vec2(-0.412,  0.883),
+	vec2( 0.418, -0.905), vec2( 0.399, -0.363), vec2(-0.319, -0.380), vec2(-0.387,  0.314),
+	vec2( 0.410,  0.398), vec2(-0.038,  0.587), vec2( 0.023, -0.694), vec2( 0.655,  0.004),
+	vec2(-0.673, -0.041), vec2(-0.002,  0.991), vec2(-0.720,  0.650), vec2( 0.667, -0.634)
+);
+
+// Taps for this fragment's shadow filters: the chosen tier up close, one tier fewer each time
+// the distance to the eye doubles past shadowTapDistance
+int ShadowTapCount()
+{
+	int taps = shadowTaps;
+	float distance = length(eyePosition - FragPos);
+	for(float tierDistance = shadowTapDistance; tierDistance > 0.0 && distance > tierDistance && taps > 1; tierDistance *= 2.0)
+	{
+		taps = taps > 8 ? 8 : (taps > 4 ? 4 : 1);
+	}
+	return taps;
+}
+
+// Turns the kernel by a per pixel angle, so neighbouring pixels tap different offsets and
+// the banding of a fixed kernel becomes fine noise
+mat2 ShadowKernelRotation()
+{
+	float angle = 6.2831853 * fract(52.9829189 * fract(dot(gl_FragCoord.xy, vec2(0.06711056, 0.00583715))));
+	float s = sin(angle);
+	float c = cos(angle);
+	return mat2(c, s, -s, c);
+}
+
+// Offset of tap i in units of the kernel radius, a single tap stays centred
+vec2 ShadowTapOffset(int i, int taps, mat2 rotation)
+{
+	return taps == 1 ? vec2(0.0) : rotation * poissonDisk[i];
+}
+
+#include "shadow_moments.glsl"
+
+// Screen space derivatives of FragPos, taken in main while control flow is still uniform. Moment lookups pick
+// their mip from these, implicit derivatives are undefined inside the light loop and jump across cascade
+// edges and cube face seams
+vec3 fragPosDx;
+vec3 fragPosDy;
+
+// Mip whose texels cover a pixel spanning the given number of level 0 texels
+float MomentsLod(float texels)
+{
+	return clamp(log2(max(texels, 1.0)), 0.0, float(MOMENTS_MAX_LEVEL));
+}
+
+// Level 0 texels the pixel at position spans under a light's projection, mapSize texels across
+float ProjectedFootprint(mat4 lightTransform, vec3 position, float mapSize)
+{
+	vec4 centre = lightTransform * vec4(position, 1.0);
+	vec4 x = lightTransform * vec4(position + fragPosDx, 1.0);
+	vec4 y = lightTransform * vec4(position + fragPosDy, 1.0);
+	vec2 dx = (x.xy / x.w - centre.xy / centre.w) * 0.5;
+	vec2 dy = (y.xy / y.w - centre.xy / centre.w) * 0.5;
+	return max(length(dx), length(dy)) * mapSize;
+}
+
+// Chebyshev's bound on the fraction of the filter region at least as far as mean
+float ChebyshevUpperBound(vec2 moments, float mean, float minVariance)
+{
+	float variance = max(moments.y - moments.x * moments.x, minVariance);
+	float d = mean - moments.x;
+	return mean <= moments.x ? 1.0 : variance / (variance + d * d);
+}
+
+// Shadowing from one filtered lookup of the moments. depth runs linearly from 0 at the light to 1 at its far plane
+float CalcMomentsShadow(vec4 moments, float depth)
+{
+	vec4 warped = WarpDepth(depth);
+	float positive = warped.x;
+	float negative = warped.z;
+	
+	float positiveScale = 0.0001 * EVSM_POSITIVE_EXPONENT * positive;
+	float negativeScale = 0.0001 * EVSM_NEGATIVE_EXPONENT * negative;
+	float lit = min(ChebyshevUpperBound(moments.xy, positive, positiveScale * positiveScale),
+		ChebyshevUpperBound(moments.zw, negative, negativeScale * negativeScale));
+	
+	// Cut off the faint tail the bound leaves behind overlapping occluders, where light would bleed through
+	lit = clamp((lit - 0.2) / 0.8, 0.0, 1.0);
+	return 1.0 - lit;
+}
+
+// Every tap is a comparison lookup, which the sampler filters over the four nearest texels
+float CalcDirectionalShadowFactor(DirectionalLight light)
+{
+	// First cascade whose slice of the view frustum holds the fragment, none past the last one
+	float viewDepth = -(view * vec4(FragPos, 1.0)).z;
+	int cascade = 0;
+	while(cascade < cascadeCount && viewDepth > cascadeSplits[cascade])
+	{
+		cascade++;
+	}
+	
+	if(cascade == cascadeCount)
+	{
+		return 0.0;
+	}
+	
+	vec3 normal = normalize(Normal);
+	vec3 lightDir = normalize(-light.direction);
+	
+	// Cascades differ in texel size, so push the lookup out along the normal by a texel-sized
+	// amount rather than biasing depth by a fixed fraction of each cascade's range
+	float slope = 1.0 - max(dot(normal, lightDir), 0.0);
+	vec3 offsetPos = FragPos + normal * cascadeTexelSizes[cascade] * (0.5 + 1.5 * slope);
+	
+	vec4 lightSpacePos = cascadeTransforms[cascade] * vec4(offsetPos, 1.0);
+	vec3 projCoords = lightSpacePos.xyz / lightSpacePos.w;
+	projCoords = (projCoords * 0.5) + 0.5;
+	
+	if(projCoords.z > 1.0)
+	{
+		return 0.0;
+	}
+	
+#ifdef SHADOW_MOMENTS
+	float lod = MomentsLod(ProjectedFootprint(cascadeTransforms[cascade], offsetPos, float(textureSize(directionalMoments, 0).x)));
+	return CalcMomentsShadow(textureLod(directionalMoments, vec3(projCoords.xy, cascade), lod), projCoords.z);
+#else
+	float reference = projCoords.z - 0.0005;
+	
+	int taps = ShadowTapCount();
+	mat2 rotation = ShadowKernelRotation();
+	vec2 kernelRadius = 1.5 / vec2(textureSize(directionalShadowMap, 0).xy);
+	
+	float lit = 0.0;
+	for(int i = 0; i < taps; i++)
+	{
+		vec2 st = projCoords.xy + ShadowTapOffset(i, taps, rotation) * kernelRadius;
+		lit += texture(directionalShadowMap, vec4(st, cascade, reference));
+	}
+	
+	return 1.0 - lit / float(taps);
+#endif
+}
+
+// Where a cube map lookup along direction would land, on the atlas tile of the face it picks, kept inset
+// half texels of level 0 inside it. Faces and their s and t axes follow the GL cube map selection table,
+// matching how the faces were rendered
+vec2 CubeToAtlas(vec3 direction, int shadowIndex, float inset)
+{
+	vec3 absDir = abs(direction);
+	int face;
+	vec3 coords;
+	if(absDir.x >= absDir.y && absDir.x >= absDir.z)
+	{
+		face = direction.x > 0.0 ? 0 : 1;
+		coords = vec3(direction.x > 0.0 ? -direction.z : direction.z, -direction.y, absDir.x);
+	}
+	else if(absDir.y >= absDir.z)
+	{
+		face = direction.y > 0.0 ? 2 : 3;
+		coords = vec3(direction.x, direction.y > 0.0 ? direction.z : -direction.z, absDir.y);
+	}
+	else
+	{
+		face = direction.z > 0.0 ? 4 : 5;
+		coords = vec3(direction.z > 0.0 ? direction.x : -direction.x, -direction.y, absDir.z);
+	}
+	
+	// Stay half a texel of the level read inside the tile so filtering never reads a neighbour
+	vec4 rect = pointShadows[shadowIndex].faceRects[face];
+	vec2 st = clamp(coords.xy / coords.z * 0.5 + 0.5, rect.w * inset, 1.0 - rect.w * inset);
+	return rect.xy + st * rect.z;
+}
+
+float CalcOmniShadowFactor(PointLight light, int shadowIndex)
+{
+	if(pointShadows[shadowIndex].faceRects[0].z == 0.0)
+	{
+		return 0.0;
+	}
+	
+	vec3 fragToLight = FragPos - light.position;
+	float currentDepth = length(fragToLight);
+	
+#ifdef SHADOW_MOMENTS
+	// Near a face's centre st moves half as far as the tangent, which changes by the pixel's size over its distance to the light
+	float tileSize = 0.5 / pointShadows[shadowIndex].faceRects[0].w;
+	float lod = MomentsLod(max(length(fragPosDx), length(fragPosDy)) / currentDepth * 0.5 * tileSize);
+	vec2 st = CubeToAtlas(fragToLight, shadowIndex, exp2(ceil(lod)));
+	return CalcMomentsShadow(textureLod(atlasMoments, vec3(st, 0.0), lod), currentDepth / light.farPlane);
+#else
+	// The faces store distance over farPlane
+	float bias = 0.05;
+	float reference = (currentDepth - bias) / light.farPlane;
+	
+	float viewDistance = length(eyePosition - FragPos);
+	float diskRadius = 1.5 * (1.0 + (viewDistance/light.farPlane)) / 25.0;
+	
+	// The kernel lies in the plane facing the light
+	vec3 axis = fragToLight / currentDepth;
+	vec3 tangent = normalize(cross(axis, abs(axis.y) < 0.99 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0)));
+	vec3 bitangent = cross(axis, tangent);
+	
+	int taps = ShadowTapCount();
+	mat2 rotation = ShadowKernelRotation();
+	
+	float lit = 0.0;
+	for(int i = 0; i < taps; i++)
+	{
+		vec2 offset = ShadowTapOffset(i, taps, rotation) * diskRadius;
+		vec3 direction = fragToLight + tangent * offset.x + bitangent * offset.y;
+		lit += texture(shadowAtlas, vec3(CubeToAtlas(direction, shadowIndex, 1.0), reference));
+	}
+	
+	return 1.0 - lit / float(taps);
+#endif
+}
+
+float CalcSpotShadowFactor(SpotLight light, int spotIndex)
+{
+	SpotShadow spotShadow = spotShadows[spotIndex];
+	vec4 rect = spotShadow.atlasRect;
+	if(rect.z == 0.0)
+	{
+		return 0.0;
+	}
+	
+	vec4 lightSpacePos = spotShadow.lightTransform * vec4(FragPos, 1.0);
+	vec3 projCoords = lightSpacePos.xyz / lightSpacePos.w;
+	projCoords = (projCoords * 0.5) + 0.5;
+	
+	if(projCoords.z > 1.0)
+	{
+		return 0.0;
+	}
+	
+	// Bias by a distance along the cone's axis, so it is in world units like the omni maps',
+	// then take it back to the perspective depth the map holds for the comparison
+	float near = spotShadow.nearPlane;
+	float far = spotShadow.farPlane;
+	float current = dot(FragPos - light.base.position, light.direction);
+#ifdef SHADOW_MOMENTS
+	float lod = MomentsLod(ProjectedFootprint(spotShadow.lightTransform, FragPos, 0.5 / rect.w));
+	// Half a texel of the coarser level read inside the tile, so its filter never reaches a neighbour
+	float inset = rect.w * exp2(ceil(lod));
+	vec2 st = clamp(projCoords.xy, inset, 1.0 - inset);
+	return CalcMomentsShadow(textureLod(atlasMoments, vec3(rect.xy + st * rect.z, 0.0), lod), (current - near) / (far - near));
+#else
+	float bias = 0.05;
+	float reference = (far - near * far / (current - bias)) / (far - near);
+	
+	int taps = ShadowTapCount();
+	mat2 rotation = ShadowKernelRotation();
+	float kernelRadius = 1.5 * 2.0 * rect.w;
+	
+	float lit = 0.0;
+	for(int i = 0; i < taps; i++)
+	{
+		vec2 st = clamp(projCoords.xy + ShadowTapOffset(i, taps, rotation) * kernelRadius, rect.w, 1.0 - rect.w);
+		lit += texture(shadowAtlas, vec3(rect.xy + st * rect.z, reference));
+	}
+	
+	return 1.0 - lit / float(taps);
+#endif
+}
+
+vec4 CalcLightByDirection(Light light, vec3 direction, float shadowFactor)
+{
+	vec4 ambientColour = vec4(light.colour, 1.0f) * light.ambientIntensity;
+	
+	float diffuseFactor = max(dot(normalize(Normal), normalize(direction)), 0.0f);
+	vec4 diffuseColour = vec4(light.colour * light.diffuseIntensity * diffuseFactor, 1.0f);
+	
+	vec4 specularColour = vec4(0, 0, 0, 0);
+	
+	if(diffuseFactor > 0.0f)
+	{
+		vec3 fragToEye = normalize(eyePosition - FragPos);
+		vec3 reflectedVertex = normalize(reflect(direction, normalize(Normal)));
+		
+		float specularFactor = dot(fragToEye, reflectedVertex);
+		if(specularFactor > 0.0f)
+		{
+			specularFactor = pow(specularFactor, material.shininess);
+			specularColour = vec4(light.colour * material.specularIntensity * specularFactor, 1.0f);
+		}
+	}
+
+	return (ambientColour + (1.0 - shadowFactor) * (diffuseColour + specularColour));
+}
+
+vec4 CalcDirectionalLight()
+{
+	float shadowFactor = CalcDirectionalShadowFactor(directionalLight);
+	return CalcLightByDirection(directionalLight.base, directionalLight.direction, shadowFactor);
+}
+
+vec4 CalcAttenuatedLight(PointLight pLight, float shadowFactor)
+{
+	vec3 direction = FragPos - pLight.position;
+	float distance = length(direction);
+	direction = normalize(direction);
+	
+	vec4 colour = CalcLightByDirection(pLight.base, direction, shadowFactor);
+	float attenuation = pLight.exponent * distance * distance +
+						pLight.linear * distance +
+						pLight.constant;
+	
+	return (colour / attenuation);
+}
+
+vec4 CalcPointLight(PointLight pLight, int shadowIndex)
+{
+#ifdef POINT_SHADOWS
+	float shadowFactor = shadowIndex >= 0 ? CalcOmniShadowFactor(pLight, shadowIndex) : 0.0;
+#else
+	float shadowFactor = 0.0;
+#endif
+	return CalcAttenuatedLight(pLight, shadowFactor);
+}
+
+vec4 CalcSpotLight(SpotLight sLight, int spotIndex)
+{
+	vec3 rayDirection = normalize(FragPos - sLight.base.position);
+	float slFactor = dot(rayDirection, sLight.direction);
+	
+	if(slFactor > sLight.edge)
+	{
+		float shadowFactor = spotIndex >= 0 ? CalcSpotShadowFactor(sLight, spotIndex) : 0.0;
+		vec4 colour = CalcAttenuatedLight(sLight.base, shadowFactor);
+		
+		return colour * (1.0f - (1.0f - slFactor)*(1.0f/(1.0f - sLight.edge)));
+		
+	} else {
+		return vec4(0, 0, 0, 0);
+	}
+}
+
+ClusterLight FetchLight(int index)
+{
+	int texel = index * 5;
+	vec4 positionRange = texelFetch(lightData, texel);
+	vec4 colourAmbient = texelFetch(lightData, texel + 1);
+	vec4 attenuation = texelFetch(lightData, texel + 2);
+	vec4 directionEdge = texelFetch(lightData, texel + 3);
+	vec4 shadow = texelFetch(lightData, texel + 4);
+	
+	ClusterLight cLight;
+	cLight.light.base.base = Light(colourAmbient.rgb, colourAmbient.a, attenuation.x);
+	cLight.light.base.position = positionRange.xyz;
+	cLight.light.base.constant = attenuation.y;
+	cLight.light.base.linear = attenuation.z;
+	cLight.light.base.exponent = attenuation.w;
+	cLight.light.base.farPlane = shadow.x;
+	cLight.light.direction = directionEdge.xyz;
+	cLight.light.edge = directionEdge.w;
+	cLight.range = positionRange.w;
+	cLight.shadowIndex = int(shadow.y);
+	return cLight;
+}
+
+// Only the lights LightClusters found reaching this fragment's froxel
+vec4 CalcClusteredLights()
+{
+	float viewDepth = -(view * vec4(FragPos, 1.0)).z;
+	ivec3 cluster = ivec3(gl_FragCoord.xy * clusterScale.xy, log(max(viewDepth, 1e-4)) * clusterScale.z + clusterScale.w);
+	cluster = clamp(cluster, ivec3(0), clusterGrid.xyz - 1);
+	
+	uvec2 range = texelFetch(clusterRanges, (cluster.z * clusterGrid.y + cluster.y) * clusterGrid.x + cluster.x).xy;
+	
+	vec4 totalColour = vec4(0, 0, 0, 0);
+	for(uint i = 0u; i < range.y; i++)
+	{
+		ClusterLight cLight = FetchLight(int(texelFetch(clusterLightIndices, int(range.x + i)).r));
+		if(length(FragPos - cLight.light.base.position) > cLight.range)
+		{
+			continue;
+		}
+		
+		// Point lights have no cone, their edge is below -1. A type the frame has none of is compiled out
+		if(cLight.light.edge < -1.0)
+		{
+#ifdef POINT_LIGHTS
+			totalColour += CalcPointLight(cLight.light.base, cLight.shadowIndex);
+#endif
+		}
+		else
+		{
+#ifdef SPOT_LIGHTS
+			totalColour += CalcSpotLight(cLight.light, cLight.shadowIndex);
+#endif
+		}
+	}
+	
+	return totalColour;
+}
+
+#ifdef DEFERRED_LIGHTING
+#include "normal_encoding.glsl"
+
+// World position of the pixel from its depth, undoing a symmetric GL perspective projection and then the
+// rigid camera transform, so no matrix has to be inverted per pixel
+vec3 ReconstructPosition(vec2 ndc, float depth)
+{
+	float viewZ = -projection[3][2] / (depth * 2.0 - 1.0 + projection[2][2]);
+	vec3 viewPos = vec3(-viewZ * ndc.x / projection[0][0], -viewZ * ndc.y / projection[1][1], viewZ);
+	
+	mat3 rotation = mat3(view);
+	return transpose(rotation) * (viewPos - view[3].xyz);
+}
+#endif
+
+void main()
+{
+#ifdef DEFERRED_LIGHTING
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	float depth = texelFetch(gDepth, pixel, 0).r;
+	FragPos = ReconstructPosition(gl_FragCoord.xy / vec2(textureSize(gDepth, 0)) * 2.0 - 1.0, depth);
+	
+	// Before the discard, derivatives need every pixel of the quad
+	fragPosDx = dFdx(FragPos);
+	fragPosDy = dFdy(FragPos);
+	
+	// Nothing was drawn here, leave the skybox
+	if(depth == 1.0)
+	{
+		discard;
+	}
+	
+	Normal = DecodeNormal(texelFetch(gNormal, pixel, 0).xy);
+	
+	vec2 packedMaterial = texelFetch(gMaterial, pixel, 0).xy;
+	material.specularIntensity = packedMaterial.x * 8.0;
+	material.shininess = exp2(packedMaterial.y * 11.0) - 1.0;
+	
+	vec4 albedo = texelFetch(gAlbedo, pixel, 0);
+#else
+	fragPosDx = dFdx(FragPos);
+	fragPosDy = dFdy(FragPos);
+	
+	vec4 albedo = texture(theTexture, TexCoord);
+#endif
+
+	vec4 finalColour = CalcDirectionalLight();
+#if defined(POINT_LIGHTS) || defined(SPOT_LIGHTS)
+	finalColour += CalcClusteredLights();
+#endif
+	
+	colour = albedo * finalColour;
 }
\ No newline at end of file
@@ -0,0 +1,43 @@
+#version 430
+
+layout (location = 0) in vec3 pos;
+layout (location = 1) in vec2 tex;
+layout (location = 2) in vec3 norm;
+// The draw's baseInstance: this object's slot in the transform buffer
+layout (location = 3) in uint objectIndex;
+
+struct ObjectTransform
+{
+	mat4 worldMatrix;
+	mat4 normalMatrix;
+};
+
+layout (std430, binding = 0) readonly buffer ObjectTransforms
+{
+	ObjectTransform transforms[];
+};
+
+out vec4 vCol;
+out vec2 TexCoord;
+out vec3 Normal;
+out vec3 FragPos;
+
+#include "camera.glsl"
+
+// Must match depth_prepass_indirect.vert, see depth_prepass.vert
+invariant gl_Position;
+
+void main()
+{
+	mat4 worldMatrix = transforms[objectIndex].worldMatrix;
+
+	gl_Position = projection * view * worldMatrix * vec4(pos, 1.0);
+	
+	vCol = vec4(clamp(pos, 0.0f, 1.0f), 1.0f);
+	
+	TexCoord = tex;
+	
+	Normal = mat3(transforms[objectIndex].normalMatrix) * norm;
+	
+	FragPos = (worldMatrix * vec4(pos, 1.0)).xyz; 
+}
@@ -0,0 +1,30 @@
+#version 330
+
+layout (location = 0) in vec3 pos;
+layout (location = 1) in vec2 tex;
+layout (location = 2) in vec3 norm;
+layout (location = 3) in mat4 instanceModel;
+layout (location = 7) in mat3 instanceNormalMatrix;
+
+out vec4 vCol;
+out vec2 TexCoord;
+out vec3 Normal;
+out vec3 FragPos;
+
+#include "camera.glsl"
+
+// Must match depth_prepass_instanced.vert, see depth_prepass.vert
+invariant gl_Position;
+
+void main()
+{
+	gl_Position = projection * view * instanceModel * vec4(pos, 1.0);
+	
+	vCol = vec4(clamp(pos, 0.0f, 1.0f), 1.0f);
+	
+	TexCoord = tex;
+	
+	Normal = instanceNormalMatrix * norm;
+	
+	FragPos = (instanceModel * vec4(pos, 1.0)).xyz; 
+}
@@ -0,0 +1,9 @@
+// The EVSM warp, written by shadow_moments_warp.frag and undone by the main shaders' lookups.
+// depth runs linearly from 0 at the light to 1 at its far plane, the exponents come from CommonValues.h
+vec4 WarpDepth(float depth)
+{
+	float d = depth * 2.0 - 1.0;
+	float positive = exp(EVSM_POSITIVE_EXPONENT * d);
+	float negative = -exp(-EVSM_NEGATIVE_EXPONENT * d);
+	return vec4(positive, positive * positive, negative, negative * negative);
+}
@@ -0,0 +1,28 @@
+#version 330
+
+out vec4 moments;
+
+// Warped and blurred across by shadow_moments_warp.frag, the square starts at the texture's corner
+uniform sampler2D scratch;
+
+uniform ivec4 tile;		// corner and size of the square being written
+
+// Must match shadow_moments_warp.frag
+const int BLUR_RADIUS = 3;
+const float blurWeights[BLUR_RADIUS + 1] = float[](0.2707, 0.2167, 0.1113, 0.0366);
+
+vec4 FetchMoments(ivec2 texel)
+{
+	return texelFetch(scratch, clamp(texel, ivec2(0), ivec2(tile.z - 1)), 0);
+}
+
+void main()
+{
+	ivec2 texel = ivec2(gl_FragCoord.xy) - tile.xy;
+	
+	moments = FetchMoments(texel) * blurWeights[0];
+	for(int i = 1; i <= BLUR_RADIUS; i++)
+	{
+		moments += (FetchMoments(texel - ivec2(0, i)) + FetchMoments(texel + ivec2(0, i))) * blurWeights[i];
+	}
+}
@@ -0,0 +1,52 @@
+#version 330
+
+out vec4 moments;
+
+// DEPTH_ARRAY for the cascades' texture array, the atlas is a plain 2D texture
+#ifdef DEPTH_ARRAY
+uniform sampler2DArray depthMap;
+#else
+uniform sampler2D depthMap;
+#endif
+
+uniform ivec4 tile;			// corner and size of the square in the depth map, and its layer
+uniform vec2 depthPlanes;	// near and far planes of a perspective map, far is 0 when depth is already linear
+
+// Gaussian with a sigma of 1.5 texels, the centre weight first. shadow_moments_blur.frag takes the other axis
+const int BLUR_RADIUS = 3;
+const float blurWeights[BLUR_RADIUS + 1] = float[](0.2707, 0.2167, 0.1113, 0.0366);
+
+float FetchDepth(ivec2 texel)
+{
+	// Never past the square, the neighbouring tiles belong to other lights
+	texel = clamp(texel, tile.xy, tile.xy + tile.z - 1);
+	
+#ifdef DEPTH_ARRAY
+	float depth = texelFetch(depthMap, ivec3(texel, tile.w), 0).r;
+#else
+	float depth = texelFetch(depthMap, texel, 0).r;
+#endif
+
+	if(depthPlanes.y > 0.0)
+	{
+		float near = depthPlanes.x;
+		float far = depthPlanes.y;
+		float distance = near * far / (far - depth * (far - near));
+		depth = (distance - near) / (far - near);
+	}
+	
+	return depth;
+}
+
+#include "shadow_moments.glsl"
+
+void main()
+{
+	ivec2 texel = tile.xy + ivec2(gl_FragCoord.xy);
+	
+	moments = WarpDepth(FetchDepth(texel)) * blurWeights[0];
+	for(int i = 1; i <= BLUR_RADIUS; i++)
+	{
+		moments += (WarpDepth(FetchDepth(texel - ivec2(i, 0))) + WarpDepth(FetchDepth(texel + ivec2(i, 0)))) * blurWeights[i];
+	}
+}
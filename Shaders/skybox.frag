@@ -1,12 +1,12 @@
-#version 330
-
-in vec3 TexCoords;
-
-out vec4 colour;
-
-uniform samplerCube skybox;
-
-void main()
-{
-	colour = texture(skybox, TexCoords);
+#version 330
+
+in vec3 TexCoords;
+
+out vec4 colour;
+
+uniform samplerCube skybox;
+
+void main()
+{
+	colour = texture(skybox, TexCoords);
 }
\ No newline at end of file
@@ -1,14 +1,14 @@
-#version 330
-
-layout (location = 0) in vec3 pos;
-
-out vec3 TexCoords;
-
-uniform mat4 projection;
-uniform mat4 view;
-
-void main()
-{
-	TexCoords = pos;
-	gl_Position = projection * view * vec4(pos, 1.0);
+#version 330
+
+layout (location = 0) in vec3 pos;
+
+out vec3 TexCoords;
+
+#include "camera.glsl"
+
+void main()
+{
+	TexCoords = pos;
+	// Only the camera's rotation, the sky stays at infinity
+	gl_Position = projection * mat4(mat3(view)) * vec4(pos, 1.0);
 }
\ No newline at end of file
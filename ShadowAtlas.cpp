@@ -0,0 +1,193 @@
+#include "ShadowAtlas.h"
+
+#include <algorithm>
+
+#include "Culling.h"
+
+// Every other bit of a Z-order index, so cells along the curve map back to grid coordinates
+static GLuint CompactBits(GLuint bits)
+{
+	bits &= 0x55555555;
+	bits = (bits | (bits >> 1)) & 0x33333333;
+	bits = (bits | (bits >> 2)) & 0x0F0F0F0F;
+	bits = (bits | (bits >> 4)) & 0x00FF00FF;
+	bits = (bits | (bits >> 8)) & 0x0000FFFF;
+	return bits;
+}
+
+static size_t TileCells(GLuint size, unsigned int tileCount)
+{
+	size_t side = size / SHADOW_ATLAS_MIN_TILE;
+	return side * side * tileCount;
+}
+
+ShadowAtlas::ShadowAtlas() : ShadowMap()
+{
+	region = nullptr;
+	regionTiles = 0;
+	tileCount = 0;
+	usage = 0.0f;
+}
+
+GLuint ShadowAtlas::DesiredTileSize(const glm::vec3& center, float radius, const glm::mat4& view, const glm::mat4& projection,
+	GLuint viewportHeight, GLuint maxSize)
+{
+	float distance = glm::length(glm::vec3(view * glm::vec4(center, 1.0f)));
+	if (distance <= radius)
+	{
+		return maxSize;
+	}
+
+	BoundingSphere sphere = { center, radius };
+	if (!SphereInVolume(CreateFrustumVolume(projection * view), sphere))
+	{
+		return 0;
+	}
+
+	// Pixels across the sphere's silhouette
+	float pixels = radius / sqrtf(distance * distance - radius * radius) * projection[1][1] * viewportHeight;
+
+	GLuint size = SHADOW_ATLAS_MIN_TILE;
+	while (size < pixels && size < maxSize)
+	{
+		size *= 2;
+	}
+
+	return std::min(size, maxSize);
+}
+
+void ShadowAtlas::Allocate(std::vector<ShadowRequest>& requests)
+{
+	size_t atlasCells = TileCells(shadowWidth, 1);
+
+	for (ShadowRequest& request : requests)
+	{
+		GLuint current = request.allocation->tileSize;
+		GLuint size = std::min(request.desiredSize, shadowWidth);
+
+		// Shrink only once the side asked for is a quarter of the current side or less
+		if (size > 0 && size < current)
+		{
+			size = size * 4 <= current ? size * 2 : current;
+		}
+
+		request.desiredSize = size;
+	}
+
+	// Over budget, halve the least important tile that can still shrink, or drop the least important shadow
+	size_t usedCells = 0;
+	for (const ShadowRequest& request : requests)
+	{
+		usedCells += TileCells(request.desiredSize, request.tileCount);
+	}
+
+	while (usedCells > atlasCells)
+	{
+		ShadowRequest* shrink = nullptr;
+		ShadowRequest* drop = nullptr;
+		for (ShadowRequest& request : requests)
+		{
+			if (request.desiredSize > SHADOW_ATLAS_MIN_TILE && (!shrink || request.importance < shrink->importance))
+			{
+				shrink = &request;
+			}
+			if (request.desiredSize > 0 && (!drop || request.importance < drop->importance))
+			{
+				drop = &request;
+			}
+		}
+
+		ShadowRequest* request = shrink ? shrink : drop;
+		usedCells -= TileCells(request->desiredSize, request->tileCount);
+		request->desiredSize = shrink ? request->desiredSize / 2 : 0;
+		usedCells += TileCells(request->desiredSize, request->tileCount);
+	}
+
+	order.resize(requests.size());
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+		return requests[a].desiredSize > requests[b].desiredSize;
+	});
+
+	// Sorted largest first, each tile starts on a multiple of its own cell count along the curve,
+	// which is always an aligned square of the grid
+	size_t cursor = 0;
+	tileCount = 0;
+	for (size_t index : order)
+	{
+		ShadowRequest& request = requests[index];
+		ShadowAllocation& allocation = *request.allocation;
+
+		bool moved = allocation.tileSize != request.desiredSize;
+		allocation.tileSize = request.desiredSize;
+
+		for (unsigned int i = 0; i < request.tileCount && request.desiredSize > 0; i++)
+		{
+			ShadowTile tile;
+			tile.x = CompactBits((GLuint)cursor) * SHADOW_ATLAS_MIN_TILE;
+			tile.y = CompactBits((GLuint)cursor >> 1) * SHADOW_ATLAS_MIN_TILE;
+			tile.size = request.desiredSize;
+			cursor += TileCells(request.desiredSize, 1);
+
+			moved = moved || tile.x != allocation.tiles[i].x || tile.y != allocation.tiles[i].y;
+
+			allocation.tiles[i] = tile;
+			allocation.uvRects[i] = glm::vec4((float)tile.x / shadowWidth, (float)tile.y / shadowHeight,
+				(float)tile.size / shadowWidth, 0.5f / tile.size);
+			tileCount++;
+		}
+
+		allocation.moved = moved;
+	}
+
+	usage = (float)cursor / atlasCells;
+}
+
+void ShadowAtlas::SetRegion(const ShadowAllocation* allocation, unsigned int tileCount_)
+{
+	region = allocation;
+	regionTiles = tileCount_;
+}
+
+void ShadowAtlas::Clear()
+{
+	// Only the region's tiles, the rest of the atlas belongs to other lights
+	glEnable(GL_SCISSOR_TEST);
+	for (unsigned int i = 0; i < regionTiles; i++)
+	{
+		const ShadowTile& tile = region->tiles[i];
+		glScissor(tile.x, tile.y, tile.size, tile.size);
+		glClear(GL_DEPTH_BUFFER_BIT);
+	}
+	glDisable(GL_SCISSOR_TEST);
+}
+
+void ShadowAtlas::CopyStaticLayer()
+{
+	if (GLEW_VERSION_4_3)
+	{
+		for (unsigned int i = 0; i < regionTiles; i++)
+		{
+			const ShadowTile& tile = region->tiles[i];
+			glCopyImageSubData(staticMap, GL_TEXTURE_2D, 0, tile.x, tile.y, 0, shadowMap, GL_TEXTURE_2D, 0, tile.x, tile.y, 0, tile.size, tile.size, 1);
+		}
+		return;
+	}
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, staticFBO);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
+	for (unsigned int i = 0; i < regionTiles; i++)
+	{
+		const ShadowTile& tile = region->tiles[i];
+		glBlitFramebuffer(tile.x, tile.y, tile.x + tile.size, tile.y + tile.size, tile.x, tile.y, tile.x + tile.size, tile.y + tile.size,
+			GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+	}
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+
+ShadowAtlas::~ShadowAtlas()
+{
+}
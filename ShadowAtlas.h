@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+
+#include <glm\glm.hpp>
+
+#include "ShadowMap.h"
+
+// Smallest tile handed out, and the grid tiles are placed on
+const GLuint SHADOW_ATLAS_MIN_TILE = 64;
+
+struct ShadowTile
+{
+	GLint x, y;
+	GLsizei size;
+};
+
+// Where a light's shadow lives in the atlas this frame: one tile for a spot light, one per cube face for a point light
+struct ShadowAllocation
+{
+	GLuint tileSize;		// 0 when the light went without a shadow
+	ShadowTile tiles[6];
+	glm::vec4 uvRects[6];	// tile corner and size in atlas coordinates, w is half a texel of the tile
+	bool moved;				// tiles differ from last frame's, so any cached shadow is gone
+};
+
+struct ShadowRequest
+{
+	ShadowAllocation* allocation;
+	unsigned int tileCount;
+	GLuint desiredSize;		// power of two, 0 when the light needs no shadow
+	float importance;
+};
+
+// One depth texture shared by every point and spot light shadow, handed out as power-of-two tiles each frame.
+// Lights that cover more of the screen get larger tiles, and when the budget runs out the least important
+// ones shrink first, so the number of shadowed lights isn't tied to textures or texture units.
+class ShadowAtlas :
+	public ShadowMap
+{
+public:
+	ShadowAtlas();
+
+	// Tile size for a light reaching radius around center, from how many pixels across it appears.
+	// 0 when the light's range is off screen
+	static GLuint DesiredTileSize(const glm::vec3& center, float radius, const glm::mat4& view, const glm::mat4& projection,
+		GLuint viewportHeight, GLuint maxSize);
+
+	// Sizes and packs the requests, largest first along a Z-order curve so power-of-two tiles never overlap.
+	// A tile grows as soon as its light asks for more but only shrinks once it asks for a side a quarter as long
+	// or less, and then to twice the side asked for, so tiles don't churn and throw away cached shadows while lights hover around a size
+	void Allocate(std::vector<ShadowRequest>& requests);
+
+	// Selects the tiles Clear and CopyStaticLayer work on
+	void SetRegion(const ShadowAllocation* allocation, unsigned int tileCount);
+
+	void Clear();
+	void CopyStaticLayer();
+
+	unsigned int GetTileCount() { return tileCount; }
+	float GetUsage() { return usage; }
+
+	~ShadowAtlas();
+
+private:
+	const ShadowAllocation* region;
+	unsigned int regionTiles;
+
+	unsigned int tileCount;
+	float usage;
+
+	std::vector<size_t> order;
+};
@@ -0,0 +1,73 @@
+#include "ShadowCache.h"
+
+#include "Object.h"
+
+static bool SameVolume(const CullVolume& a, const CullVolume& b)
+{
+	if (a.isSphere != b.isSphere)
+	{
+		return false;
+	}
+
+	if (a.isSphere)
+	{
+		return a.sphereCenter == b.sphereCenter && a.sphereRadius == b.sphereRadius;
+	}
+
+	for (int i = 0; i < 6; i++)
+	{
+		if (a.planes[i] != b.planes[i])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+ShadowCache::ShadowCache()
+{
+	valid = false;
+	hasStaticLayer = false;
+	hadDynamicCasters = false;
+	frame = 0;
+	sceneVersion = 0;
+	volume = CullVolume();
+}
+
+ShadowUpdate ShadowCache::Evaluate(const CullVolume& volume_)
+{
+	// Caster changes are only kept for the current frame, a gap may have missed some
+	bool staticChanged = !valid || frame + 1 != Object::GetFrame() || sceneVersion != Object::GetSceneVersion() || !SameVolume(volume, volume_);
+
+	for (size_t i = 0; i < Object::GetStaticCasterChanges().size() && !staticChanged; i++)
+	{
+		staticChanged = BoxInVolume(volume_, Object::GetStaticCasterChanges()[i]);
+	}
+
+	bool dynamicCasters = false;
+	for (Object* object : Object::GetMovingObjects())
+	{
+		if (BoxInVolume(volume_, object->getWorldBounds()))
+		{
+			dynamicCasters = true;
+			break;
+		}
+	}
+
+	valid = true;
+	frame = Object::GetFrame();
+	sceneVersion = Object::GetSceneVersion();
+	volume = volume_;
+
+	// Casters that just left the range still have to be erased from the map
+	bool redrawDynamic = dynamicCasters || hadDynamicCasters;
+	hadDynamicCasters = dynamicCasters;
+
+	if (staticChanged)
+	{
+		return SHADOW_UPDATE_FULL;
+	}
+
+	return redrawDynamic ? SHADOW_UPDATE_DYNAMIC : SHADOW_UPDATE_NONE;
+}
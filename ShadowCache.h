@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Culling.h"
+
+// How much of a light's shadow map has to be redrawn this frame
+enum ShadowUpdate
+{
+	SHADOW_UPDATE_NONE,		// nothing in range changed, the map is reused as is
+	SHADOW_UPDATE_DYNAMIC,	// copy the cached static layer back and draw the moving casters over it
+	SHADOW_UPDATE_FULL		// the light or a static caster in range changed, redraw the static layer too
+};
+
+// Shadow maps redrawn, partly redrawn and reused since the counters were last reset
+struct ShadowCacheStats
+{
+	unsigned int fullUpdates;
+	unsigned int dynamicUpdates;
+	unsigned int skippedUpdates;
+};
+
+// Per-light record of what its shadow map was drawn from. Compares the light's volume and the casters
+// that moved, settled or changed in range against the previous frame.
+class ShadowCache
+{
+public:
+	ShadowCache();
+
+	// Call once per frame for each shadowed light, skipping a frame forces a full update
+	ShadowUpdate Evaluate(const CullVolume& volume);
+
+	void Invalidate() { valid = false; }
+
+	// Whether the map's static layer matches what the cache recorded, maps redrawn whole leave it behind
+	bool HasStaticLayer() { return hasStaticLayer; }
+	void SetHasStaticLayer(bool hasStaticLayer_) { hasStaticLayer = hasStaticLayer_; }
+
+private:
+	bool valid;
+	bool hasStaticLayer;
+	bool hadDynamicCasters;
+	unsigned int frame;
+	unsigned int sceneVersion;
+	CullVolume volume;
+};
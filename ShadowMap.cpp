@@ -1,66 +1,114 @@
-#include "ShadowMap.h"
-
-
-
-ShadowMap::ShadowMap()
-{
-	FBO = 0;
-	shadowMap = 0;
-}
-
-bool ShadowMap::Init(unsigned int width, unsigned int height)
-{
-	shadowWidth = width; shadowHeight = height;
-
-	glGenFramebuffers(1, &FBO);
-
-	glGenTextures(1, &shadowMap);
-	glBindTexture(GL_TEXTURE_2D, shadowMap);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-	float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-	glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-
-	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
-	glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, shadowMap, 0);
-
-	glDrawBuffer(GL_NONE);
-	glReadBuffer(GL_NONE);
-
-	GLenum Status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-
-	if (Status != GL_FRAMEBUFFER_COMPLETE)
-	{
-		printf("Framebuffer error: %s\n", Status);
-		return false;
-	}
-
-	return true;
-}
-
-void ShadowMap::Write()
-{
-	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
-}
-
-void ShadowMap::Read(GLenum texUnit)
-{
-	glActiveTexture(texUnit);
-	glBindTexture(GL_TEXTURE_2D, shadowMap);
-}
-
-ShadowMap::~ShadowMap()
-{
-	if (FBO)
-	{
-		glDeleteFramebuffers(1, &FBO);
-	}
-
-	if (shadowMap)
-	{
-		glDeleteTextures(1, &shadowMap);
-	}
-}
+#include "ShadowMap.h"
+
+
+
+ShadowMap::ShadowMap()
+{
+	FBO = 0;
+	shadowMap = 0;
+	staticFBO = 0;
+	staticMap = 0;
+}
+
+bool ShadowMap::Init(unsigned int width, unsigned int height)
+{
+	shadowWidth = width; shadowHeight = height;
+
+	return CreateMap(FBO, shadowMap);
+}
+
+bool ShadowMap::CreateMap(GLuint& framebuffer, GLuint& texture)
+{
+	glGenFramebuffers(1, &framebuffer);
+
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, shadowWidth, shadowHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+	float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+	// Read through sampler2DShadow, lookups compare and filter in hardware
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+	glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture, 0);
+
+	glDrawBuffer(GL_NONE);
+	glReadBuffer(GL_NONE);
+
+	GLenum Status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+
+	if (Status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		printf("Framebuffer error: %s\n", Status);
+		return false;
+	}
+
+	return true;
+}
+
+bool ShadowMap::InitStaticLayer()
+{
+	if (staticFBO)
+	{
+		return true;
+	}
+
+	return CreateMap(staticFBO, staticMap);
+}
+
+void ShadowMap::WriteStaticLayer()
+{
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, staticFBO);
+}
+
+void ShadowMap::CopyStaticLayer()
+{
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, staticFBO);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
+	glBlitFramebuffer(0, 0, shadowWidth, shadowHeight, 0, 0, shadowWidth, shadowHeight, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+
+void ShadowMap::Write()
+{
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
+}
+
+void ShadowMap::Clear()
+{
+	glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+void ShadowMap::Read(GLenum texUnit)
+{
+	glActiveTexture(texUnit);
+	glBindTexture(GL_TEXTURE_2D, shadowMap);
+}
+
+ShadowMap::~ShadowMap()
+{
+	if (FBO)
+	{
+		glDeleteFramebuffers(1, &FBO);
+	}
+
+	if (shadowMap)
+	{
+		glDeleteTextures(1, &shadowMap);
+	}
+
+	if (staticFBO)
+	{
+		glDeleteFramebuffers(1, &staticFBO);
+	}
+
+	if (staticMap)
+	{
+		glDeleteTextures(1, &staticMap);
+	}
+}
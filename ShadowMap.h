@@ -1,25 +1,39 @@
-#pragma once
-
-#include <stdio.h>
-
-#include <GL\glew.h>
-
-class ShadowMap
-{
-public:
-	ShadowMap();
-
-	virtual bool Init(unsigned int width, unsigned int height);
-
-	virtual void Write();
-
-	virtual void Read(GLenum TextureUnit);
-
-	GLuint GetShadowWidth() { return shadowWidth; }
-	GLuint GetShadowHeight() { return shadowHeight; }
-
-	~ShadowMap();
-protected:
-	GLuint FBO, shadowMap;
-	GLuint shadowWidth, shadowHeight;
-};
\ No newline at end of file
+#pragma once
+
+#include <stdio.h>
+
+#include <GL\glew.h>
+
+class ShadowMap
+{
+public:
+	ShadowMap();
+
+	virtual bool Init(unsigned int width, unsigned int height);
+
+	virtual void Write();
+
+	// Clears what the next pass draws over, the whole map here
+	virtual void Clear();
+
+	virtual void Read(GLenum TextureUnit);
+
+	// A second map holding only the static casters, copied back under the moving ones whenever those are redrawn.
+	// Created on first use
+	bool InitStaticLayer();
+	virtual void WriteStaticLayer();
+	virtual void CopyStaticLayer();
+
+	GLuint GetShadowTexture() { return shadowMap; }
+	GLuint GetShadowWidth() { return shadowWidth; }
+	GLuint GetShadowHeight() { return shadowHeight; }
+
+	virtual ~ShadowMap();
+protected:
+	GLuint FBO, shadowMap;
+	GLuint staticFBO, staticMap;
+	GLuint shadowWidth, shadowHeight;
+
+	// Creates a depth texture of the map's size and a framebuffer rendering to it
+	virtual bool CreateMap(GLuint& framebuffer, GLuint& texture);
+};
@@ -0,0 +1,213 @@
+#include "ShadowMoments.h"
+
+#include <algorithm>
+#include <cmath>
+
+ShadowMoments::ShadowMoments()
+{
+	momentsTexture = 0;
+	momentsFBO = 0;
+	momentsWidth = 0;
+	momentsHeight = 0;
+	momentsLayers = 0;
+	scratchTexture = 0;
+	scratchFBO = 0;
+	scratchSize = 0;
+	depthSampler = 0;
+	emptyVAO = 0;
+	uniformWarpTile = -1;
+	uniformWarpPlanes = -1;
+	uniformBlurTile = -1;
+}
+
+bool ShadowMoments::Init(GLuint width, GLuint height, GLuint layers)
+{
+	momentsWidth = width; momentsHeight = height; momentsLayers = layers;
+
+	glGenTextures(1, &momentsTexture);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, momentsTexture);
+	for (GLint level = 0; level <= MOMENTS_MAX_LEVEL; level++)
+	{
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA16F, std::max(width >> level, 1u), std::max(height >> level, 1u), layers, 0,
+			GL_RGBA, GL_FLOAT, nullptr);
+	}
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, MOMENTS_MAX_LEVEL);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+
+	// Outside the map reads as the moments of the far plane, fully lit like the depth maps' border
+	float positive = expf((float)EVSM_POSITIVE_EXPONENT);
+	float negative = -expf(-(float)EVSM_NEGATIVE_EXPONENT);
+	float borderColor[] = { positive, positive * positive, negative, negative * negative };
+	glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	glGenFramebuffers(1, &momentsFBO);
+	glBindFramebuffer(GL_FRAMEBUFFER, momentsFBO);
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, momentsTexture, 0, 0);
+
+	GLenum Status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if (Status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		printf("Framebuffer error: %i\n", Status);
+		return false;
+	}
+
+	glGenSamplers(1, &depthSampler);
+	glSamplerParameteri(depthSampler, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glSamplerParameteri(depthSampler, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glSamplerParameteri(depthSampler, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+
+	glGenVertexArrays(1, &emptyVAO);
+
+	if (layers > 1)
+	{
+		warpShader.AddDefine("DEPTH_ARRAY");
+	}
+	warpShader.CreateFromFiles("Shaders/fullscreen.vert", "Shaders/shadow_moments_warp.frag");
+	blurShader.CreateFromFiles("Shaders/fullscreen.vert", "Shaders/shadow_moments_blur.frag");
+
+	uniformWarpTile = warpShader.GetUniformLocation("tile");
+	uniformWarpPlanes = warpShader.GetUniformLocation("depthPlanes");
+	uniformBlurTile = blurShader.GetUniformLocation("tile");
+
+	return true;
+}
+
+bool ShadowMoments::ResizeScratch(GLsizei size)
+{
+	if (size <= scratchSize)
+	{
+		return true;
+	}
+
+	if (scratchTexture)
+	{
+		glDeleteTextures(1, &scratchTexture);
+	}
+	else
+	{
+		glGenFramebuffers(1, &scratchFBO);
+	}
+	scratchSize = size;
+
+	glGenTextures(1, &scratchTexture);
+	glBindTexture(GL_TEXTURE_2D, scratchTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, size, size, 0, GL_RGBA, GL_FLOAT, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, scratchFBO);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, scratchTexture, 0);
+
+	GLenum Status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if (Status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		printf("Framebuffer error: %i\n", Status);
+		return false;
+	}
+
+	return true;
+}
+
+void ShadowMoments::Resolve(GLuint depthTexture, GLuint layer, GLint x, GLint y, GLsizei size, GLfloat nearPlane, GLfloat farPlane)
+{
+	pending.push_back({ depthTexture, layer, x, y, size, nearPlane, farPlane });
+}
+
+void ShadowMoments::Update()
+{
+	if (pending.empty())
+	{
+		return;
+	}
+
+	PROFILE_ZONE("ShadowMoments::Update");
+
+	GLenum depthTarget = momentsLayers > 1 ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D;
+
+	glDisable(GL_DEPTH_TEST);
+	glBindVertexArray(emptyVAO);
+
+	for (const MomentsRegion& region : pending)
+	{
+		if (!ResizeScratch(region.size))
+		{
+			break;
+		}
+
+		// Warp into moments and blur across, into the corner of the scratch texture
+		glBindFramebuffer(GL_FRAMEBUFFER, scratchFBO);
+		glViewport(0, 0, region.size, region.size);
+
+		warpShader.UseShader();
+		glUniform4i(uniformWarpTile, region.x, region.y, region.size, region.layer);
+		glUniform2f(uniformWarpPlanes, region.nearPlane, region.farPlane);
+
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(depthTarget, region.depthTexture);
+		glBindSampler(0, depthSampler);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		glBindSampler(0, 0);
+
+		// Then blur down, back onto the square's place in the moments
+		glBindFramebuffer(GL_FRAMEBUFFER, momentsFBO);
+		glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, momentsTexture, 0, region.layer);
+		glViewport(region.x, region.y, region.size, region.size);
+
+		blurShader.UseShader();
+		glUniform4i(uniformBlurTile, region.x, region.y, region.size, 0);
+
+		glBindTexture(GL_TEXTURE_2D, scratchTexture);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+	}
+
+	pending.clear();
+
+	glBindVertexArray(0);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glEnable(GL_DEPTH_TEST);
+
+	// The whole chain at once, cheaper than per square and only when something was redrawn
+	glBindTexture(GL_TEXTURE_2D_ARRAY, momentsTexture);
+	glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void ShadowMoments::Read(GLenum textureUnit)
+{
+	glActiveTexture(textureUnit);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, momentsTexture);
+}
+
+ShadowMoments::~ShadowMoments()
+{
+	if (momentsFBO)
+	{
+		glDeleteFramebuffers(1, &momentsFBO);
+	}
+
+	if (momentsTexture)
+	{
+		glDeleteTextures(1, &momentsTexture);
+	}
+
+	if (scratchFBO)
+	{
+		glDeleteFramebuffers(1, &scratchFBO);
+		glDeleteTextures(1, &scratchTexture);
+	}
+
+	if (depthSampler)
+	{
+		glDeleteSamplers(1, &depthSampler);
+		glDeleteVertexArrays(1, &emptyVAO);
+	}
+}
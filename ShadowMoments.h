@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+
+#include <GL\glew.h>
+
+#include "Shader.h"
+
+// Exponential variance shadow maps built from the depth maps. Whenever a map is redrawn its tiles are warped into
+// four moments, blurred and mipmapped once, so receivers take one filtered lookup instead of a PCF loop
+// and maps the shadow cache keeps cost nothing to filter. Moments live in a half float texture array, one layer
+// per layer of the depth map, 8 bytes a texel before mips.
+class ShadowMoments
+{
+public:
+	ShadowMoments();
+
+	// layers is 1 when the depth map is a 2D texture
+	bool Init(GLuint width, GLuint height, GLuint layers);
+
+	bool IsInitialised() { return momentsTexture != 0; }
+
+	// Queues the square of the depth map at x, y to be rebuilt by the next Update. Depth is taken as linear
+	// unless farPlane is above 0, then it is perspective depth between nearPlane and farPlane
+	void Resolve(GLuint depthTexture, GLuint layer, GLint x, GLint y, GLsizei size, GLfloat nearPlane, GLfloat farPlane);
+
+	// Warps and blurs every queued square, then rebuilds the mips. Leaves no framebuffer bound
+	void Update();
+
+	void Read(GLenum textureUnit);
+
+	~ShadowMoments();
+
+private:
+	struct MomentsRegion
+	{
+		GLuint depthTexture, layer;
+		GLint x, y;
+		GLsizei size;
+		GLfloat nearPlane, farPlane;
+	};
+
+	std::vector<MomentsRegion> pending;
+
+	GLuint momentsTexture, momentsFBO;
+	GLuint momentsWidth, momentsHeight, momentsLayers;
+
+	// Holds a square between the two blur passes, grown to the largest one resolved
+	GLuint scratchTexture, scratchFBO;
+	GLsizei scratchSize;
+
+	// Reads the depth maps without the comparison their textures are set up for
+	GLuint depthSampler;
+	GLuint emptyVAO;
+
+	Shader warpShader, blurShader;
+	GLint uniformWarpTile, uniformWarpPlanes, uniformBlurTile;
+
+	bool ResizeScratch(GLsizei size);
+};
@@ -1,35 +1,36 @@
-#pragma once
-
-#include <vector>
-#include <string>
-
-#include <GL\glew.h>
-
-#include <glm\glm.hpp>
-#include <glm\gtc\matrix_transform.hpp>
-#include <glm\gtc\type_ptr.hpp>
-
-#include "CommonValues.h"
-
-#include "Mesh.h"
-#include "Shader.h"
-
-class Skybox
-{
-public:
-	Skybox();
-
-	Skybox(std::vector<std::string> faceLocations);
-
-	void DrawSkybox(glm::mat4 viewMatrix, glm::mat4 projectionMatrix);
-
-	~Skybox();
-
-private:
-	Mesh* skyMesh;
-	Shader* skyShader;
-
-	GLuint textureId;
-	GLuint uniformProjection, uniformView;
-};
-
+#pragma once
+
+#include <vector>
+#include <string>
+
+#include <GL\glew.h>
+
+#include <glm\glm.hpp>
+#include <glm\gtc\matrix_transform.hpp>
+#include <glm\gtc\type_ptr.hpp>
+
+#include "CommonValues.h"
+
+#include "Mesh.h"
+#include "Shader.h"
+#include "CpuProfiler.h"
+
+class Skybox
+{
+public:
+	Skybox();
+
+	Skybox(std::vector<std::string> faceLocations);
+
+	// Uses the camera in the Camera uniform block
+	void DrawSkybox();
+
+	~Skybox();
+
+private:
+	Mesh* skyMesh;
+	Shader* skyShader;
+
+	GLuint textureId;
+};
+
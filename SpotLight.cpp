@@ -1,62 +1,81 @@
-#include "SpotLight.h"
-
-
-
-SpotLight::SpotLight() : PointLight()
-{
-	direction = glm::vec3(0.0f, -1.0f, 0.0f);
-	edge = 0.0f;
-	procEdge = cosf(glm::radians(edge));
-	isOn = true;
-}
-
-SpotLight::SpotLight(GLuint shadowWidth, GLuint shadowHeight,
-	GLfloat near, GLfloat far, 
-	GLfloat red, GLfloat green, GLfloat blue,
-	GLfloat aIntensity, GLfloat dIntensity, 
-	GLfloat xPos, GLfloat yPos, GLfloat zPos, 
-	GLfloat xDir, GLfloat yDir, GLfloat zDir, 
-	GLfloat con, GLfloat lin, GLfloat exp, 
-	GLfloat edg) : PointLight(shadowWidth, shadowHeight, near, far, red, green, blue, aIntensity, dIntensity, xPos, yPos, zPos, con, lin, exp)
-{
-	direction = glm::normalize(glm::vec3(xDir, yDir, zDir));
-
-	edge = edg;
-	procEdge = cosf(glm::radians(edge));
-}
-
-void SpotLight::UseLight(GLuint ambientIntensityLocation, GLuint ambientColourLocation, 
-	GLuint diffuseIntensityLocation, GLuint positionLocation, GLuint directionLocation, 
-	GLuint constantLocation, GLuint linearLocation, GLuint exponentLocation, 
-	GLuint edgeLocation)
-{
-	glUniform3f(ambientColourLocation, colour.x, colour.y, colour.z);
-
-	if (isOn)
-	{
-		glUniform1f(ambientIntensityLocation, ambientIntensity);
-		glUniform1f(diffuseIntensityLocation, diffuseIntensity);
-	}
-	else {
-		glUniform1f(ambientIntensityLocation, 0.0f);
-		glUniform1f(diffuseIntensityLocation, 0.0f);
-	}
-
-	glUniform3f(positionLocation, position.x, position.y, position.z);
-	glUniform1f(constantLocation, constant);
-	glUniform1f(linearLocation, linear);
-	glUniform1f(exponentLocation, exponent);
-
-	glUniform3f(directionLocation, direction.x, direction.y, direction.z);
-	glUniform1f(edgeLocation, procEdge);
-}
-
-void SpotLight::SetFlash(glm::vec3 pos, glm::vec3 dir)
-{
-	position = pos;
-	direction = dir;
-}
-
-SpotLight::~SpotLight()
-{
-}
+#include "SpotLight.h"
+
+// A cone only ever needs one frustum. Its tile gets at most as many texels across the cone as a cube face
+// would give it, so narrow cones take small tiles, and never more than the size asked for
+static GLuint SpotShadowSize(GLuint shadowWidth, GLfloat edge)
+{
+	float coneWidth = shadowWidth * tanf(glm::radians(glm::min(edge, 45.0f)));
+
+	GLuint size = 64;
+	while (size < coneWidth && size < shadowWidth)
+	{
+		size *= 2;
+	}
+
+	return glm::min(size, shadowWidth);
+}
+
+SpotLight::SpotLight() : PointLight()
+{
+	direction = glm::vec3(0.0f, -1.0f, 0.0f);
+	edge = 0.0f;
+	procEdge = cosf(glm::radians(edge));
+	isOn = true;
+
+	nearPlane = 0.01f;
+	spotProj = glm::mat4(1.0f);
+}
+
+SpotLight::SpotLight(GLuint shadowWidth, GLuint shadowHeight,
+	GLfloat near, GLfloat far, 
+	GLfloat red, GLfloat green, GLfloat blue,
+	GLfloat aIntensity, GLfloat dIntensity, 
+	GLfloat xPos, GLfloat yPos, GLfloat zPos, 
+	GLfloat xDir, GLfloat yDir, GLfloat zDir, 
+	GLfloat con, GLfloat lin, GLfloat exp, 
+	GLfloat edg) : PointLight(shadowWidth, shadowHeight, near, far, red, green, blue, aIntensity, dIntensity, xPos, yPos, zPos, con, lin, exp)
+{
+	direction = glm::normalize(glm::vec3(xDir, yDir, zDir));
+
+	edge = edg;
+	procEdge = cosf(glm::radians(edge));
+	isOn = true;
+
+	// A texel of margin past the edge keeps filtering inside the map
+	shadowSize = SpotShadowSize(shadowWidth, edge);
+	float fov = glm::min(2.0f * edge * (1.0f + 2.0f / shadowSize), 170.0f);
+
+	nearPlane = near;
+	spotProj = glm::perspective(glm::radians(fov), 1.0f, near, far);
+}
+
+void SpotLight::FillLightData(ClusterLightData& data)
+{
+	PointLight::FillLightData(data);
+
+	if (!isOn)
+	{
+		data.ambientIntensity = 0.0f;
+		data.diffuseIntensity = 0.0f;
+		data.range = 0.0f;
+	}
+
+	data.direction = direction;
+	data.edge = procEdge;
+}
+
+glm::mat4 SpotLight::CalculateSpotTransform()
+{
+	glm::vec3 up = fabs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+	return spotProj * glm::lookAt(position, position + direction, up);
+}
+
+void SpotLight::SetFlash(glm::vec3 pos, glm::vec3 dir)
+{
+	position = pos;
+	direction = dir;
+}
+
+SpotLight::~SpotLight()
+{
+}
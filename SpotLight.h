@@ -1,44 +1,49 @@
-#pragma once
-#include "PointLight.h"
-class SpotLight :
-	public PointLight
-{
-public:
-	SpotLight();
-
-	SpotLight(GLuint shadowWidth, GLuint shadowHeight,
-		GLfloat near, GLfloat far, 
-		GLfloat red, GLfloat green, GLfloat blue,
-		GLfloat aIntensity, GLfloat dIntensity,
-		GLfloat xPos, GLfloat yPos, GLfloat zPos,
-		GLfloat xDir, GLfloat yDir, GLfloat zDir,
-		GLfloat con, GLfloat lin, GLfloat exp,
-		GLfloat edg);
-
-	void UseLight(GLuint ambientIntensityLocation, GLuint ambientColourLocation,
-		GLuint diffuseIntensityLocation, GLuint positionLocation, GLuint directionLocation,
-		GLuint constantLocation, GLuint linearLocation, GLuint exponentLocation,
-		GLuint edgeLocation);
-
-	void SetFlash(glm::vec3 pos, glm::vec3 dir);
-
-	void setDirection(float x, float y, float z) {
-		direction.x = x;
-		direction.y = y;
-		direction.z = z;
-	}
-
-	glm::vec3 getDirection() { return direction; }
-
-	void Toggle() { isOn = !isOn; }
-
-	~SpotLight();
-
-private:
-	glm::vec3 direction;
-
-	GLfloat edge, procEdge;
-
-	bool isOn;
-};
-
+#pragma once
+#include "PointLight.h"
+class SpotLight :
+	public PointLight
+{
+public:
+	SpotLight();
+
+	SpotLight(GLuint shadowWidth, GLuint shadowHeight,
+		GLfloat near, GLfloat far, 
+		GLfloat red, GLfloat green, GLfloat blue,
+		GLfloat aIntensity, GLfloat dIntensity,
+		GLfloat xPos, GLfloat yPos, GLfloat zPos,
+		GLfloat xDir, GLfloat yDir, GLfloat zDir,
+		GLfloat con, GLfloat lin, GLfloat exp,
+		GLfloat edg);
+
+	void FillLightData(ClusterLightData& data);
+
+	// Projection and view of the single perspective shadow map covering the cone
+	glm::mat4 CalculateSpotTransform();
+	GLfloat GetNearPlane() { return nearPlane; }
+
+	void SetFlash(glm::vec3 pos, glm::vec3 dir);
+
+	void setDirection(float x, float y, float z) {
+		direction.x = x;
+		direction.y = y;
+		direction.z = z;
+	}
+
+	glm::vec3 getDirection() { return direction; }
+
+	void Toggle() { isOn = !isOn; }
+	bool IsOn() { return isOn; }
+
+	~SpotLight();
+
+private:
+	glm::vec3 direction;
+
+	GLfloat edge, procEdge;
+
+	GLfloat nearPlane;
+	glm::mat4 spotProj;
+
+	bool isOn;
+};
+
@@ -1,27 +1,29 @@
-#pragma once
-
-#include <GL\glew.h>
-
-#include "CommonValues.h"
-
-class Texture
-{
-public:
-	Texture();
-	Texture(const char* fileLoc);
-
-	bool LoadTexture();
-	bool LoadTextureA();
-
-	void UseTexture();
-	void ClearTexture();
-
-	~Texture();
-
-private:
-	GLuint textureID;
-	int width, height, bitDepth;
-
-	const char* fileLocation;
-};
-
+#pragma once
+
+#include <GL\glew.h>
+
+#include "CommonValues.h"
+#include "CpuProfiler.h"
+
+class Texture
+{
+public:
+	Texture();
+	Texture(const char* fileLoc);
+
+	bool LoadTexture();
+	bool LoadTextureA();
+
+	void UseTexture();
+	GLuint GetTextureID() { return textureID; }
+	void ClearTexture();
+
+	~Texture();
+
+private:
+	GLuint textureID;
+	int width, height, bitDepth;
+
+	const char* fileLocation;
+};
+
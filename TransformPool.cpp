@@ -0,0 +1,51 @@
+#include "TransformPool.h"
+
+std::vector<glm::mat4> TransformPool::worldMatrices;
+std::vector<glm::mat3> TransformPool::normalMatrices;
+std::vector<unsigned int> TransformPool::freeSlots;
+std::vector<unsigned char> TransformPool::slotDirty;
+std::vector<unsigned int> TransformPool::dirtySlots;
+
+unsigned int TransformPool::Allocate()
+{
+	// Reuse freed slots first so the arrays stay dense as objects come and go
+	if (!freeSlots.empty())
+	{
+		unsigned int slot = freeSlots.back();
+		freeSlots.pop_back();
+		return slot;
+	}
+
+	worldMatrices.push_back(glm::mat4(1.0f));
+	normalMatrices.push_back(glm::mat3(1.0f));
+	slotDirty.push_back(0);
+	return worldMatrices.size() - 1;
+}
+
+void TransformPool::Free(unsigned int slot)
+{
+	worldMatrices[slot] = glm::mat4(1.0f);
+	normalMatrices[slot] = glm::mat3(1.0f);
+	freeSlots.push_back(slot);
+	MarkDirty(slot);
+}
+
+void TransformPool::MarkDirty(unsigned int slot)
+{
+	if (!slotDirty[slot])
+	{
+		slotDirty[slot] = 1;
+		dirtySlots.push_back(slot);
+	}
+}
+
+void TransformPool::TakeDirtySlots(std::vector<unsigned int>& slots)
+{
+	for (unsigned int slot : dirtySlots)
+	{
+		slotDirty[slot] = 0;
+	}
+
+	slots.swap(dirtySlots);
+	dirtySlots.clear();
+}
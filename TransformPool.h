@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+
+#include <glm\glm.hpp>
+
+// World and normal matrices of every object, packed in parallel arrays so passes walk them linearly.
+// Objects own a slot for their lifetime and refresh it only when their transform changes.
+class TransformPool
+{
+public:
+	static unsigned int Allocate();
+	static void Free(unsigned int slot);
+
+	static glm::mat4& GetWorldMatrix(unsigned int slot) { return worldMatrices[slot]; }
+	static glm::mat3& GetNormalMatrix(unsigned int slot) { return normalMatrices[slot]; }
+
+	static const glm::mat4* GetWorldMatrices() { return worldMatrices.data(); }
+	static const glm::mat3* GetNormalMatrices() { return normalMatrices.data(); }
+	static size_t GetSlotCount() { return worldMatrices.size(); }
+
+	// Records a slot written since the last TakeDirtySlots, so copies of the pool can update just those
+	static void MarkDirty(unsigned int slot);
+	static void TakeDirtySlots(std::vector<unsigned int>& slots);
+
+private:
+	static std::vector<glm::mat4> worldMatrices;
+	static std::vector<glm::mat3> normalMatrices;
+	static std::vector<unsigned int> freeSlots;
+	static std::vector<unsigned char> slotDirty;
+	static std::vector<unsigned int> dirtySlots;
+};
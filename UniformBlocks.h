@@ -0,0 +1,125 @@
+#pragma once
+
+#include <GL\glew.h>
+
+#include <glm\glm.hpp>
+
+#include "CommonValues.h"
+
+// C++ mirrors of the std140 uniform blocks the shaders share. Members sit at their std140 offsets,
+// vec3s take a vec4 slot and structs round up to 16 bytes, so the padding is spelled out.
+
+const GLuint CAMERA_BLOCK_BINDING = 0;
+const GLuint LIGHTS_BLOCK_BINDING = 1;
+const GLuint SHADOW_TRANSFORMS_BLOCK_BINDING = 2;
+const GLuint OMNI_SHADOW_BLOCK_BINDING = 3;
+const GLuint SHADOW_VIEW_BLOCK_BINDING = 4;
+const GLuint OMNI_SHADOW_FACE_BLOCK_BINDING = 5;
+
+struct CameraBlock
+{
+	glm::mat4 projection;
+	glm::mat4 view;
+	glm::vec3 eyePosition;
+	GLfloat padding;
+};
+
+struct LightData
+{
+	glm::vec3 colour;
+	GLfloat ambientIntensity;
+	GLfloat diffuseIntensity;
+	GLfloat padding[3];
+};
+
+struct DirectionalLightData
+{
+	LightData base;
+	glm::vec3 direction;
+	GLfloat padding;
+};
+
+// Point and spot lights live in the LightClusters buffer texture rather than a block, five RGBA32F texels each
+struct ClusterLightData
+{
+	glm::vec3 position;
+	GLfloat range;			// nothing is lit past it
+	glm::vec3 colour;
+	GLfloat ambientIntensity;
+	GLfloat diffuseIntensity;
+	GLfloat constant;
+	GLfloat linear;
+	GLfloat exponent;
+	glm::vec3 direction;
+	GLfloat edge;			// cosine of the cone's half angle, below -1 for point lights
+	GLfloat farPlane;
+	GLfloat shadowIndex;	// slot in the ShadowTransforms block, -1 without a shadow
+	GLfloat padding[2];
+};
+
+// The froxel grid the main shaders look their lights up in: a cluster is
+// (gl_FragCoord.xy * clusterScale.xy, log(view depth) * clusterScale.z + clusterScale.w).
+// Shadow filters take shadowTaps taps, one tier fewer each time the view distance doubles past shadowTapDistance
+struct LightsBlock
+{
+	DirectionalLightData directionalLight;
+	glm::ivec4 clusterGrid;
+	glm::vec4 clusterScale;
+	GLint shadowTaps;
+	GLfloat shadowTapDistance;
+	GLfloat padding[2];
+};
+
+// Atlas rects as ShadowAllocation::uvRects, all zero when the light got no tile this frame
+struct PointShadowData
+{
+	glm::vec4 faceRects[6];
+};
+
+struct SpotShadowData
+{
+	glm::mat4 lightTransform;
+	glm::vec4 atlasRect;
+	GLfloat nearPlane;
+	GLfloat farPlane;
+	GLfloat padding[2];
+};
+
+// The directional light's cascades, as the main shaders pick between them, and where each point light's faces
+// and each spot light's perspective map sit in the shadow atlas
+struct ShadowTransformsBlock
+{
+	glm::mat4 cascadeTransforms[MAX_SHADOW_CASCADES];
+	glm::vec4 cascadeSplits;
+	glm::vec4 cascadeTexelSizes;
+	GLint cascadeCount;
+	GLint padding[3];
+	PointShadowData pointShadows[MAX_POINT_LIGHTS];
+	SpotShadowData spotShadows[MAX_SPOT_LIGHTS];
+};
+
+// One per cube face, for the passes that draw a point light's faces one at a time
+struct OmniShadowFaceBlock
+{
+	GLint face;
+	GLint padding[3];
+};
+
+// One per cascade then one per spot light, each 2D shadow pass binds its own range
+struct ShadowViewBlock
+{
+	glm::mat4 lightTransform;
+};
+
+// One per shadow-casting point light, each pass binds its own range
+struct OmniShadowBlock
+{
+	glm::mat4 lightMatrices[6];
+	glm::vec3 lightPos;
+	GLfloat farPlane;
+};
+
+static_assert(sizeof(LightData) == 32 && sizeof(DirectionalLightData) == 48 && sizeof(ClusterLightData) == 80
+	&& sizeof(PointShadowData) == 96 && sizeof(SpotShadowData) == 96,
+	"light structs must keep their std140 sizes");
+static_assert(MAX_SHADOW_CASCADES == 4, "cascade splits are packed into a vec4");
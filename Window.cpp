@@ -1,170 +1,186 @@
-#include "Window.h"
-
-Window::Window()
-{
-	width = 800;
-	height = 600;
-
-	for(size_t i = 0; i < 1024; i++)
-	{
-		keys[i] = 0;
-	}
-	
-	xChange = 0.0f;
-	yChange = 0.0f;
-}
-
-Window::Window(GLint windowWidth, GLint windowHeight)
-{
-	width = windowWidth;
-	height = windowHeight;
-
-	for (size_t i = 0; i < 1024; i++)
-	{
-		keys[i] = 0;
-	}
-	
-	xChange = 0.0f;
-	yChange = 0.0f;
-}
-
-int Window::Initialise()
-{
-	if (!glfwInit())
-	{
-		printf("Error Initialising GLFW");
-		glfwTerminate();
-		return 1;
-	}
-
-	// Setup GLFW Windows Properties
-	// OpenGL version
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	// Core Profile
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-	// Allow forward compatiblity
-	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-
-	// Create the window
-	mainWindow = glfwCreateWindow(width, height, "Cadminimum", NULL, NULL);
-	if (!mainWindow)
-	{
-		printf("Error creating GLFW window!");
-		glfwTerminate();
-		return 1;
-	}
-
-	// Get buffer size information
-	glfwGetFramebufferSize(mainWindow, &bufferWidth, &bufferHeight);
-
-	// Set the current context
-	glfwMakeContextCurrent(mainWindow);
-
-	// Handle Key + Mouse Input
-	createCallbacks();
-	glfwSetInputMode(mainWindow, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
-
-	// Allow modern extension access
-	glewExperimental = GL_TRUE;
-
-	GLenum error = glewInit();
-	if (error != GLEW_OK)
-	{
-		printf("Error: %s", glewGetErrorString(error));
-		glfwDestroyWindow(mainWindow);
-		glfwTerminate();
-		return 1;
-	}
-
-	glEnable(GL_DEPTH_TEST);
-
-	// Create Viewport
-	glViewport(0, 0, bufferWidth, bufferHeight);
-
-	glfwSetWindowUserPointer(mainWindow, this);
-}
-
-void Window::createCallbacks()
-{
-	glfwSetKeyCallback(mainWindow, handleKeys);
-	glfwSetMouseButtonCallback(mainWindow, handleMouseButtons);
-	glfwSetCursorPosCallback(mainWindow, handleMouse);
-}
-
-GLfloat Window::getXChange()
-{
-	GLfloat theChange = xChange;
-	xChange = 0.0f;
-	return theChange;
-}
-
-GLfloat Window::getYChange()
-{
-	GLfloat theChange = yChange;
-	yChange = 0.0f;
-	return theChange;
-}
-
-void Window::handleKeys(GLFWwindow* window, int key, int code, int action, int mode)
-{
-	Window* theWindow = static_cast<Window*>(glfwGetWindowUserPointer(window));
-
-	if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
-	{
-		glfwSetWindowShouldClose(window, GL_TRUE);
-	}
-
-	if (key >= 0 && key < 1024)
-	{
-		if (action == GLFW_PRESS)
-		{
-			theWindow->keys[key] = true;
-		}
-		else if (action == GLFW_RELEASE)
-		{
-			theWindow->keys[key] = false;
-		}
-	}
-}
-
-void Window::handleMouseButtons(GLFWwindow* window, int button, int action, int mods)
-{
-	Window* theWindow = static_cast<Window*>(glfwGetWindowUserPointer(window));
-
-	if (button >= 0 && button < 1024)
-	{
-		if (action == GLFW_PRESS)
-		{
-			theWindow->keys[button] = true;
-		}
-		else if (action == GLFW_RELEASE)
-		{
-			theWindow->keys[button] = false;
-		}
-	}
-}
-
-void Window::handleMouse(GLFWwindow* window, double xPos, double yPos)
-{
-	Window* theWindow = static_cast<Window*>(glfwGetWindowUserPointer(window));
-
-	if (theWindow->mouseFirstMoved)
-	{
-		theWindow->lastX = xPos;
-		theWindow->lastY = yPos;
-		theWindow->mouseFirstMoved = false;
-	}
-
-	theWindow->xChange = xPos - theWindow->lastX;
-	theWindow->yChange = theWindow->lastY - yPos;
-
-	theWindow->lastX = xPos;
-	theWindow->lastY = yPos;
-}
-
-Window::~Window()
-{
-	glfwDestroyWindow(mainWindow);
-	glfwTerminate();
-}
+#include "Window.h"
+
+Window::Window()
+{
+	width = 800;
+	height = 600;
+
+	for(size_t i = 0; i < 1024; i++)
+	{
+		keys[i] = 0;
+	}
+	
+	xChange = 0.0f;
+	yChange = 0.0f;
+}
+
+Window::Window(GLint windowWidth, GLint windowHeight)
+{
+	width = windowWidth;
+	height = windowHeight;
+
+	for (size_t i = 0; i < 1024; i++)
+	{
+		keys[i] = 0;
+	}
+	
+	xChange = 0.0f;
+	yChange = 0.0f;
+}
+
+int Window::Initialise()
+{
+	return Initialise(true);
+}
+
+int Window::Initialise(bool visible)
+{
+	if (!glfwInit())
+	{
+		printf("Error Initialising GLFW");
+		glfwTerminate();
+		return 1;
+	}
+
+	// Setup GLFW Windows Properties
+	// OpenGL version, 4.3 enables multi-draw indirect rendering
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	// Core Profile
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// Allow forward compatiblity
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+	// Hidden windows still get a context, which is all headless rendering needs
+	glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
+
+	// Create the window
+	mainWindow = glfwCreateWindow(width, height, "Cadminimum", NULL, NULL);
+	if (!mainWindow)
+	{
+		// Everything else runs on 3.3
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+		mainWindow = glfwCreateWindow(width, height, "Cadminimum", NULL, NULL);
+	}
+	if (!mainWindow)
+	{
+		printf("Error creating GLFW window!");
+		glfwTerminate();
+		return 1;
+	}
+
+	// Get buffer size information
+	glfwGetFramebufferSize(mainWindow, &bufferWidth, &bufferHeight);
+
+	// Set the current context
+	glfwMakeContextCurrent(mainWindow);
+
+	// Handle Key + Mouse Input
+	createCallbacks();
+	glfwSetInputMode(mainWindow, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+
+	// Allow modern extension access
+	glewExperimental = GL_TRUE;
+
+	GLenum error = glewInit();
+	if (error != GLEW_OK)
+	{
+		printf("Error: %s", glewGetErrorString(error));
+		glfwDestroyWindow(mainWindow);
+		glfwTerminate();
+		return 1;
+	}
+
+	glEnable(GL_DEPTH_TEST);
+
+	// Create Viewport
+	glViewport(0, 0, bufferWidth, bufferHeight);
+
+	glfwSetWindowUserPointer(mainWindow, this);
+
+	return 0;
+}
+
+void Window::createCallbacks()
+{
+	glfwSetKeyCallback(mainWindow, handleKeys);
+	glfwSetMouseButtonCallback(mainWindow, handleMouseButtons);
+	glfwSetCursorPosCallback(mainWindow, handleMouse);
+}
+
+GLfloat Window::getXChange()
+{
+	GLfloat theChange = xChange;
+	xChange = 0.0f;
+	return theChange;
+}
+
+GLfloat Window::getYChange()
+{
+	GLfloat theChange = yChange;
+	yChange = 0.0f;
+	return theChange;
+}
+
+void Window::handleKeys(GLFWwindow* window, int key, int code, int action, int mode)
+{
+	Window* theWindow = static_cast<Window*>(glfwGetWindowUserPointer(window));
+
+	if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
+	{
+		glfwSetWindowShouldClose(window, GL_TRUE);
+	}
+
+	if (key >= 0 && key < 1024)
+	{
+		if (action == GLFW_PRESS)
+		{
+			theWindow->keys[key] = true;
+		}
+		else if (action == GLFW_RELEASE)
+		{
+			theWindow->keys[key] = false;
+		}
+	}
+}
+
+void Window::handleMouseButtons(GLFWwindow* window, int button, int action, int mods)
+{
+	Window* theWindow = static_cast<Window*>(glfwGetWindowUserPointer(window));
+
+	if (button >= 0 && button < 1024)
+	{
+		if (action == GLFW_PRESS)
+		{
+			theWindow->keys[button] = true;
+		}
+		else if (action == GLFW_RELEASE)
+		{
+			theWindow->keys[button] = false;
+		}
+	}
+}
+
+void Window::handleMouse(GLFWwindow* window, double xPos, double yPos)
+{
+	Window* theWindow = static_cast<Window*>(glfwGetWindowUserPointer(window));
+
+	if (theWindow->mouseFirstMoved)
+	{
+		theWindow->lastX = xPos;
+		theWindow->lastY = yPos;
+		theWindow->mouseFirstMoved = false;
+	}
+
+	theWindow->xChange = xPos - theWindow->lastX;
+	theWindow->yChange = theWindow->lastY - yPos;
+
+	theWindow->lastX = xPos;
+	theWindow->lastY = yPos;
+}
+
+Window::~Window()
+{
+	glfwDestroyWindow(mainWindow);
+	glfwTerminate();
+}
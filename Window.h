@@ -1,50 +1,51 @@
-#pragma once
-
-#include "stdio.h"
-
-#include <GL\glew.h>
-#include <GLFW\glfw3.h>
-
-class Window
-{
-public:
-	Window();
-
-	Window(GLint windowWidth, GLint windowHeight);
-
-	int Initialise();
-
-	GLint getBufferWidth() { return bufferWidth; }
-	GLint getBufferHeight() { return bufferHeight; }
-
-	bool getShouldClose() { return glfwWindowShouldClose(mainWindow); }
-
-	bool* getsKeys() { return keys; }
-	GLfloat getXChange();
-	GLfloat getYChange();
-
-	void swapBuffers() { glfwSwapBuffers(mainWindow); }
-
-	GLFWwindow* getGLWFWindow() { return mainWindow; }
-
-	~Window();
-
-private:
-	GLFWwindow* mainWindow;
-
-	GLint width, height;
-	GLint bufferWidth, bufferHeight;
-
-	bool keys[1024];
-
-	GLfloat lastX;
-	GLfloat lastY;
-	GLfloat xChange;
-	GLfloat yChange;
-	bool mouseFirstMoved;
-
-	void createCallbacks();
-	static void handleKeys(GLFWwindow* window, int key, int code, int action, int mode);
-	static void handleMouseButtons(GLFWwindow* window, int button, int action, int mods);
-	static void handleMouse(GLFWwindow* window, double xPos, double yPos);
+#pragma once
+
+#include "stdio.h"
+
+#include <GL\glew.h>
+#include <GLFW\glfw3.h>
+
+class Window
+{
+public:
+	Window();
+
+	Window(GLint windowWidth, GLint windowHeight);
+
+	int Initialise();
+	int Initialise(bool visible);
+
+	GLint getBufferWidth() { return bufferWidth; }
+	GLint getBufferHeight() { return bufferHeight; }
+
+	bool getShouldClose() { return glfwWindowShouldClose(mainWindow); }
+
+	bool* getsKeys() { return keys; }
+	GLfloat getXChange();
+	GLfloat getYChange();
+
+	void swapBuffers() { glfwSwapBuffers(mainWindow); }
+
+	GLFWwindow* getGLWFWindow() { return mainWindow; }
+
+	~Window();
+
+private:
+	GLFWwindow* mainWindow;
+
+	GLint width, height;
+	GLint bufferWidth, bufferHeight;
+
+	bool keys[1024];
+
+	GLfloat lastX;
+	GLfloat lastY;
+	GLfloat xChange;
+	GLfloat yChange;
+	bool mouseFirstMoved;
+
+	void createCallbacks();
+	static void handleKeys(GLFWwindow* window, int key, int code, int action, int mode);
+	static void handleMouseButtons(GLFWwindow* window, int button, int action, int mods);
+	static void handleMouse(GLFWwindow* window, double xPos, double yPos);
 };
\ No newline at end of file
@@ -1,588 +1,1972 @@
-#define STB_IMAGE_IMPLEMENTATION
-
-#include <stdio.h>
-#include <string.h>
-#include <cmath>
-#include <vector>
-#include <filesystem>
-
-#include <GL\glew.h>
-#include <GLFW\glfw3.h>
-
-#include <glm\glm.hpp>
-#include <glm\gtc\matrix_transform.hpp>
-#include <glm\gtc\type_ptr.hpp>
-
-#include "imgui\imgui.h"
-#include "imgui\imgui_impl_glfw.h"
-#include "imgui\imgui_impl_opengl3.h"
-
-#include "CommonValues.h"
-
-#include "Window.h"
-#include "Mesh.h"
-#include "Shader.h"
-#include "Camera.h"
-#include "Texture.h"
-#include "DirectionalLight.h"
-#include "PointLight.h"
-#include "SpotLight.h"
-#include "Material.h"
-#include "Object.h"
-#include "Model.h"
-#include "Skybox.h"
-
-const float toRadians = 3.14159265f / 180.0f;
-
-GLuint uniformProjection = 0, uniformModel = 0, uniformView = 0, uniformEyePosition = 0,
-uniformSpecularIntensity = 0, uniformShininess = 0,
-uniformDirectionalLightTransform = 0, uniformOmniLightPos = 0, uniformFarPlane = 0;
-
-Window mainWindow;
-
-std::vector<Shader> shaderList;
-Shader directionalShadowShader;
-Shader omniShadowShader;
-
-Camera camera;
-
-Texture plainTexture;
-
-DirectionalLight mainLight;
-PointLight pointLights[MAX_POINT_LIGHTS];
-SpotLight spotLights[MAX_SPOT_LIGHTS];
-
-Skybox skybox;
-
-unsigned int pointLightCount = 0;
-unsigned int spotLightCount = 0;
-
-GLfloat deltaTime = 0.0f;
-GLfloat lastTime = 0.0f;
-
-GLfloat blackhawkAngle = 0.0f;
-
-static std::vector<Object*> objects;
-// Vertex Shader
-static const char* vShader = "Shaders/shader.vert";
-
-// Fragment Shader
-static const char* fShader = "Shaders/shader.frag";
-
-void calcAverageNormals(unsigned int * indices, unsigned int indiceCount, GLfloat * vertices, unsigned int verticeCount, 
-						unsigned int vLength, unsigned int normalOffset)
-{
-	for (size_t i = 0; i < indiceCount; i += 3)
-	{
-		unsigned int in0 = indices[i] * vLength;
-		unsigned int in1 = indices[i + 1] * vLength;
-		unsigned int in2 = indices[i + 2] * vLength;
-		glm::vec3 v1(vertices[in1] - vertices[in0], vertices[in1 + 1] - vertices[in0 + 1], vertices[in1 + 2] - vertices[in0 + 2]);
-		glm::vec3 v2(vertices[in2] - vertices[in0], vertices[in2 + 1] - vertices[in0 + 1], vertices[in2 + 2] - vertices[in0 + 2]);
-		glm::vec3 normal = glm::cross(v1, v2);
-		normal = glm::normalize(normal);
-		
-		in0 += normalOffset; in1 += normalOffset; in2 += normalOffset;
-		vertices[in0] += normal.x; vertices[in0 + 1] += normal.y; vertices[in0 + 2] += normal.z;
-		vertices[in1] += normal.x; vertices[in1 + 1] += normal.y; vertices[in1 + 2] += normal.z;
-		vertices[in2] += normal.x; vertices[in2 + 1] += normal.y; vertices[in2 + 2] += normal.z;
-	}
-
-	for (size_t i = 0; i < verticeCount / vLength; i++)
-	{
-		unsigned int nOffset = i * vLength + normalOffset;
-		glm::vec3 vec(vertices[nOffset], vertices[nOffset + 1], vertices[nOffset + 2]);
-		vec = glm::normalize(vec);
-		vertices[nOffset] = vec.x; vertices[nOffset + 1] = vec.y; vertices[nOffset + 2] = vec.z;
-	}
-}
-
-
-void CreateShaders()
-{
-	Shader *shader1 = new Shader();
-	shader1->CreateFromFiles(vShader, fShader);
-	shaderList.push_back(*shader1);
-
-	directionalShadowShader.CreateFromFiles("Shaders/directional_shadow_map.vert", "Shaders/directional_shadow_map.frag");
-	omniShadowShader.CreateFromFiles("Shaders/omni_shadow_map.vert", "Shaders/omni_shadow_map.geom", "Shaders/omni_shadow_map.frag");
-}
-
-void RenderScene()
-{
-
-	for (Object* object : objects) {
-		glm::mat4 model(1.0f);
-		model = glm::translate(model, glm::vec3(object->getPos().x, object->getPos().y, object->getPos().z));
-		model = glm::rotate(model, object->getRot().x * toRadians, glm::vec3(1, 0, 0));
-		model = glm::rotate(model, object->getRot().y * toRadians, glm::vec3(0, 1, 0));
-		model = glm::rotate(model, object->getRot().z * toRadians, glm::vec3(0, 0, 1));
-		model = glm::scale(model, glm::vec3(object->getScale().x, object->getScale().y, object->getScale().z));
-		glUniformMatrix4fv(uniformModel, 1, GL_FALSE, glm::value_ptr(model));
-		object->getModel().RenderModel();
-	}
-	//shinyMaterial.UseMaterial(uniformSpecularIntensity, uniformShininess);
-}
-
-void DirectionalShadowMapPass(DirectionalLight* light)
-{
-	directionalShadowShader.UseShader();
-
-	glViewport(0, 0, light->getShadowMap()->GetShadowWidth(), light->getShadowMap()->GetShadowHeight());
-
-	light->getShadowMap()->Write();
-	glClear(GL_DEPTH_BUFFER_BIT);
-
-	uniformModel = directionalShadowShader.GetModelLocation();
-	//directionalShadowShader.SetDirectionalLightTransform(&light->CalculateLightTransform());
-
-	directionalShadowShader.Validate();
-
-	RenderScene();
-
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-}
-
-void OmniShadowMapPass(PointLight* light)
-{
-	omniShadowShader.UseShader();
-
-	glViewport(0, 0, light->getShadowMap()->GetShadowWidth(), light->getShadowMap()->GetShadowHeight());
-
-	light->getShadowMap()->Write();
-	glClear(GL_DEPTH_BUFFER_BIT);
-
-	uniformModel = omniShadowShader.GetModelLocation();
-	uniformOmniLightPos = omniShadowShader.GetOmniLightPosLocation();
-	uniformFarPlane = omniShadowShader.GetFarPlaneLocation();
-
-	glUniform3f(uniformOmniLightPos, light->GetPosition().x, light->GetPosition().y, light->GetPosition().z);
-	glUniform1f(uniformFarPlane, light->GetFarPlane());
-	omniShadowShader.SetLightMatrices(light->CalculateLightTransform());
-
-	omniShadowShader.Validate();
-
-	RenderScene();
-
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-}
-
-void RenderPass(glm::mat4 viewMatrix, glm::mat4 projectionMatrix)
-{
-	glViewport(0, 0, 1366, 768);
-
-	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-	skybox.DrawSkybox(viewMatrix, projectionMatrix);
-
-	shaderList[0].UseShader();
-
-	uniformModel = shaderList[0].GetModelLocation();
-	uniformProjection = shaderList[0].GetProjectionLocation();
-	uniformView = shaderList[0].GetViewLocation();
-	uniformModel = shaderList[0].GetModelLocation();
-	uniformEyePosition = shaderList[0].GetEyePositionLocation();
-	uniformSpecularIntensity = shaderList[0].GetSpecularIntensityLocation();
-	uniformShininess = shaderList[0].GetShininessLocation();
-
-	glUniformMatrix4fv(uniformProjection, 1, GL_FALSE, glm::value_ptr(projectionMatrix));
-	glUniformMatrix4fv(uniformView, 1, GL_FALSE, glm::value_ptr(viewMatrix));
-	glUniform3f(uniformEyePosition, camera.getCameraPosition().x, camera.getCameraPosition().y, camera.getCameraPosition().z);
-
-	shaderList[0].SetDirectionalLight(&mainLight);
-	shaderList[0].SetPointLights(pointLights, pointLightCount, 3, 0);
-	shaderList[0].SetSpotLights(spotLights, spotLightCount, 3 + pointLightCount, pointLightCount);
-	//shaderList[0].SetDirectionalLightTransform(&mainLight.CalculateLightTransform());
-
-	mainLight.getShadowMap()->Read(GL_TEXTURE2);
-	shaderList[0].SetTexture(1);
-	shaderList[0].SetDirectionalShadowMap(2);
-
-	glm::vec3 lowerLight = camera.getCameraPosition();
-	lowerLight.y -= 0.3f;
-	spotLights[0].SetFlash(lowerLight, camera.getCameraDirection());
-
-	shaderList[0].Validate();
-
-	RenderScene();
-}
-
-int main() 
-{
-	mainWindow = Window(1366, 768); // 1280, 1024 or 1024, 768
-	mainWindow.Initialise();
-
-	CreateShaders();
-
-	camera = Camera(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), -60.0f, 0.0f, 5.0f, 0.5f);
-
-	plainTexture = Texture("Textures/plain.png");
-	plainTexture.LoadTextureA();
-
-	mainLight = DirectionalLight(2048, 2048,
-								1.0f, 0.53f, 0.3f, 
-								0.1f, 0.9f,
-								-10.0f, -12.0f, 18.5f);
-
-	pointLights[0] = PointLight(1024, 1024,
-								0.01f, 100.0f,
-								0.0f, 0.0f, 1.0f,
-								0.0f, 1.0f,
-								1.0f, 2.0f, 0.0f,
-								0.3f, 0.2f, 0.1f);
-	pointLightCount++;
-	pointLights[1] = PointLight(1024, 1024,
-								0.01f, 100.0f, 
-								0.0f, 1.0f, 0.0f,
-								0.0f, 1.0f,
-								-4.0f, 3.0f, 0.0f,
-								0.3f, 0.2f, 0.1f);
-	pointLightCount++;
-
-	
-	spotLights[0] = SpotLight(1024, 1024,
-						0.01f, 100.0f, 
-						1.0f, 1.0f, 1.0f,
-						0.0f, 2.0f,
-						0.0f, 0.0f, 0.0f,
-						0.0f, -1.0f, 0.0f,
-						1.0f, 0.0f, 0.0f,
-						20.0f);
-	spotLightCount++;
-	spotLights[1] = SpotLight(1024, 1024,
-						0.01f, 100.0f, 
-						1.0f, 1.0f, 1.0f,
-						0.0f, 1.0f,
-						0.0f, -1.5f, 0.0f,
-						-100.0f, -1.0f, 0.0f,
-						1.0f, 0.0f, 0.0f,
-						20.0f);
-	spotLightCount++;
-
-	std::vector<std::string> skyboxFaces;
-	skyboxFaces.push_back("Textures/Skybox/alpha-island/alpha-island_rt.tga");
-	skyboxFaces.push_back("Textures/Skybox/alpha-island/alpha-island_lf.tga");
-	skyboxFaces.push_back("Textures/Skybox/alpha-island/alpha-island_up.tga");
-	skyboxFaces.push_back("Textures/Skybox/alpha-island/alpha-island_dn.tga");
-	skyboxFaces.push_back("Textures/Skybox/alpha-island/alpha-island_bk.tga");
-	skyboxFaces.push_back("Textures/Skybox/alpha-island/alpha-island_ft.tga");
-
-	skybox = Skybox(skyboxFaces);
-
-	GLuint uniformProjection = 0, uniformModel = 0, uniformView = 0, uniformEyePosition = 0,
-		uniformSpecularIntensity = 0, uniformShininess = 0;
-
-	glm::mat4 projection = glm::perspective(glm::radians(60.0f), (GLfloat)mainWindow.getBufferWidth() / mainWindow.getBufferHeight(), 0.1f, 100.0f);
-
-	IMGUI_CHECKVERSION();
-	ImGui::CreateContext();
-	ImGuiIO& io = ImGui::GetIO();
-	// Setup Platform/Renderer bindings
-	ImGui_ImplGlfw_InitForOpenGL(mainWindow.getGLWFWindow(), true);
-	ImGui_ImplOpenGL3_Init("#version 330");
-	// Setup Dear ImGui style
-	ImGui::StyleColorsDark();
-
-	static bool createObject = false;
-	static bool importObject = false;
-
-	static bool createCube = false;
-	static bool createSphere = false;
-
-	static bool directionalLight = false;
-	static int spotLight = -1;
-	static bool openSpotLight = false;
-	static int pointLight = -1;
-	static bool openPointLight = false;
-
-	static float FOV = 60.0f;
-	static float near = 0.1f;
-	static float far = 100.0f;
-
-	static int currSkybox = 0;
-
-
-
-	// Loop until window closed
-	while (!mainWindow.getShouldClose())
-	{
-		GLfloat now = glfwGetTime(); // SDL_GetPerformanceCounter();
-		deltaTime = now - lastTime; // (now - lastTime)*1000/SDL_GetPerformanceFrequency();
-		lastTime = now;
-
-		// Get + Handle User Input
-		glfwPollEvents();
-
-		camera.keyControl(mainWindow.getsKeys(), deltaTime);
-		if (mainWindow.getsKeys()[GLFW_MOUSE_BUTTON_2]) {
-			camera.mouseControl(mainWindow.getXChange(), mainWindow.getYChange());
-		}
-
-		ImGui_ImplOpenGL3_NewFrame();
-		ImGui_ImplGlfw_NewFrame();
-		ImGui::NewFrame();
-
-		if (mainWindow.getsKeys()[GLFW_KEY_L])
-		{
-			spotLights[0].Toggle();
-			mainWindow.getsKeys()[GLFW_KEY_L] = false;
-		}
-
-		DirectionalShadowMapPass(&mainLight);
-		for (size_t i = 0; i < pointLightCount; i++)
-		{
-			OmniShadowMapPass(&pointLights[i]);
-		}
-		for (size_t i = 0; i < spotLightCount; i++)
-		{
-			OmniShadowMapPass(&spotLights[i]);
-		}
-
-		RenderPass(camera.calculateViewMatrix(), projection);
-
-		// Object hierarchy
-		ImGuiWindowFlags window_flags = 0;
-		window_flags |= ImGuiWindowFlags_MenuBar;
-
-		ImGui::Begin("Settings", NULL, window_flags);
-
-			float moveSpeed = camera.getMoveSpeed();
-			ImGui::DragFloat("Move speed", &moveSpeed, 0.01f, 0.0f, 10.0f);
-			camera.setMoveSpeed(moveSpeed);
-
-			float turnSpeed = camera.getTurnSpeed();
-			ImGui::DragFloat("Turn speed", &turnSpeed, 0.01f, 0.0f, 10.0f);
-			camera.setTurnSpeed(turnSpeed);
-
-			ImGui::DragFloat("Field of view", &FOV, 0.1f, 30.0f, 180.0f);
-			ImGui::DragFloat("Near plane", &near, 0.1f, 0.0f, far);
-			ImGui::DragFloat("Far plane", &far, 0.1f, near);
-			projection = glm::perspective(glm::radians(FOV), (GLfloat)mainWindow.getBufferWidth() / mainWindow.getBufferHeight(), near, far);
-
-			int prevSkybox = currSkybox;
-			const char* skyboxes[] = { "alpha-island", "alps", "arctic", "arrakisday", "ashcanyon", "badomen", "blue", "boulder-bay", 
-									   "bromene-bay", "cloudtop", "cottoncandy", "coward-cove", "craterflake", "criminal-element", 
-									   "cupertin-lake", "darkgloom", "day-at-the-beach", "desertsky", "emeraldfog", "fadeaway", 
-									   "fat-chance-in-hell", "frozen", "frozendusk", "glacier", "greenhaze", "greywash", "habitual-pain", 
-									   "hills", "hills2", "iceflats", "iceflow", "interstellar", "lagoon", "leatherduster", "lilacisles", 
-									   "limon", "lmcity", "majesty", "midnight-silence", "miramar", "mountain", "mudskipper", "nevada", 
-									   "nightsky", "oasisnight", "peaks", "plains-of-abraham", "powderpeak", "purplenebula", "redplanet", 
-									   "rockyvalley", "seeingred", "sep", "shadowpeak", "siege", "snow", "snowy", "sorbin", "ss", "starfield", 
-									   "stormydays", "stratosphere", "sunset", "violentdays" };
-			ImGui::Combo("Skybox", &currSkybox, skyboxes, IM_ARRAYSIZE(skyboxes));
-
-			if (prevSkybox != currSkybox) {
-				std::vector<std::string> skyboxFaces;
-				std::string skyboxName = skyboxes[currSkybox];
-				skyboxFaces.push_back("Textures/Skybox/" + skyboxName + "/" + skyboxName + "_rt.tga");
-				skyboxFaces.push_back("Textures/Skybox/" + skyboxName + "/" + skyboxName + "_lf.tga");
-				skyboxFaces.push_back("Textures/Skybox/" + skyboxName + "/" + skyboxName + "_up.tga");
-				skyboxFaces.push_back("Textures/Skybox/" + skyboxName + "/" + skyboxName + "_dn.tga");
-				skyboxFaces.push_back("Textures/Skybox/" + skyboxName + "/" + skyboxName + "_bk.tga");
-				skyboxFaces.push_back("Textures/Skybox/" + skyboxName + "/" + skyboxName + "_ft.tga");
-
-				skybox = Skybox(skyboxFaces);
-				prevSkybox = currSkybox;
-			}
-			
-
-		ImGui::End();
-
-		ImGui::Begin("Object hierarchy", NULL, window_flags);
-
-			ImGui::PushItemWidth(ImGui::GetFontSize() * -12);
-
-			if (ImGui::BeginMenuBar())
-			{
-				if (ImGui::BeginMenu("File"))
-				{
-					/*if (ImGui::BeginMenu("New")) {
-						if (ImGui::BeginMenu("Object")) {
-							ImGui::MenuItem("Cube", NULL, &createCube);
-							ImGui::MenuItem("Sphere", NULL, &createSphere);
-							ImGui::EndMenu();
-						}
-						ImGui::EndMenu();
-					}*/
-					ImGui::MenuItem("Import", NULL, &importObject);
-					ImGui::EndMenu();
-				}
-
-				ImGui::EndMenuBar();
-			}
-
-			if (ImGui::CollapsingHeader("Objects")) {
-				if (objects.size() == 0) {
-					ImGui::Text("No objects on display!");
-				}
-				else {
-					int ID = 0;
-					for (Object* object : objects) {
-						ImGui::PushID(ID);
-						if (ImGui::Button("X")) {
-							objects.erase(std::find(objects.begin(), objects.end(), object));
-						}
-						ImGui::PopID();
-						ImGui::SameLine();
-						if (ImGui::Selectable(object->getName(), false, ImGuiSelectableFlags_AllowDoubleClick))
-							if (ImGui::IsMouseDoubleClicked(0))
-								object->setIsSelected(true);
-						ID++;
-					}
-				}
-			}
-
-			if (ImGui::CollapsingHeader("Lights")) {
-				if (ImGui::TreeNode("Spotlights")) {
-					int ID = 0;
-					for (SpotLight light : spotLights) {
-						ID++;
-						std::string lightNameStr = "Spotlight " + std::to_string(ID);
-						const char* lightName = lightNameStr.c_str();
-						if (ImGui::Selectable(lightName, false, ImGuiSelectableFlags_AllowDoubleClick)) {
-							if (ImGui::IsMouseDoubleClicked(0)) {
-								spotLight = ID;
-								openSpotLight = true;
-							}
-						}
-					}
-					ImGui::TreePop();
-				}
-
-				if (ImGui::TreeNode("Pointlights")) {
-					int ID = 0;
-					for (PointLight light : pointLights) {
-						ID++;
-						std::string lightNameStr = "Pointlight " + std::to_string(ID);
-						const char* lightName = lightNameStr.c_str();
-						if (ImGui::Selectable(lightName, false, ImGuiSelectableFlags_AllowDoubleClick)) {
-							if (ImGui::IsMouseDoubleClicked(0)) {
-								pointLight = ID;
-								openPointLight = true;
-							}
-						}
-					}
-					ImGui::TreePop();
-				}
-			}
-		ImGui::End();
-
-		if (spotLight > 0) {
-			std::string lightNameStr = "Spotlight " + std::to_string(spotLight);
-			const char* lightName = lightNameStr.c_str();
-			if(ImGui::Begin(lightName, &openSpotLight)) {
-
-				if (ImGui::Button("Toggle light")) {
-					spotLights[spotLight - 1].Toggle();
-				}
-
-				float ambientIntensity = spotLights[spotLight - 1].getAmbientIntensity();
-				ImGui::DragFloat("Ambient intensity", &ambientIntensity, 0.1f, 0.0f, 300.0f);
-				spotLights[spotLight - 1].setAmbientIntensity(ambientIntensity);
-
-				float diffuseIntensity = spotLights[spotLight - 1].getDiffuseIntensity();
-				ImGui::DragFloat("Diffuse intensity", &diffuseIntensity, 0.1f, 0.0f, 300.0f);
-				spotLights[spotLight - 1].setDiffuseIntensity(diffuseIntensity);
-
-				float colours[3] = { spotLights[spotLight-1].getColour().x,
-									spotLights[spotLight-1].getColour().y,
-									spotLights[spotLight-1].getColour().z };
-				ImGui::ColorPicker3("Light colour", colours);
-				spotLights[spotLight-1].setColour(colours);
-
-				if (!openSpotLight) {
-					spotLight = -1;
-				}
-				ImGui::End();
-			}
-		}
-
-		if (pointLight > 0) {
-			std::string lightNameStr = "Pointlight " + std::to_string(pointLight);
-			const char* lightName = lightNameStr.c_str();
-			if (ImGui::Begin(lightName, &openPointLight)) {
-
-				float ambientIntensity = pointLights[pointLight - 1].getAmbientIntensity();
-				ImGui::DragFloat("Ambient intensity", &ambientIntensity, 0.1f, 0.0f, 300.0f);
-				pointLights[pointLight - 1].setAmbientIntensity(ambientIntensity);
-
-				float diffuseIntensity = pointLights[pointLight - 1].getDiffuseIntensity();
-				ImGui::DragFloat("Diffuse intensity", &diffuseIntensity, 0.1f, 0.0f, 300.0f);
-				pointLights[pointLight - 1].setDiffuseIntensity(diffuseIntensity);
-
-				float colours[3] = { pointLights[pointLight-1].getColour().x,
-					pointLights[pointLight-1].getColour().y,
-					pointLights[pointLight-1].getColour().z };
-				ImGui::ColorPicker3("Light colour", colours);
-				printf("Colour: %f\n", colours[1]);
-				pointLights[pointLight-1].setColour(colours);
-
-				if (!openPointLight) {
-					pointLight = -1;
-				}
-				ImGui::End();
-			}
-		}
-
-		if (importObject) {
-			ImGui::Begin("Import object", &importObject);
-				std::string path = "Models";
-				for (const auto& entry : std::filesystem::directory_iterator(path)) {
-					std::string fileName = entry.path().string();
-					if (fileName.find(".obj") != std::string::npos) {
-						fileName = fileName.substr(7);
-						if (ImGui::Selectable(fileName.c_str(), false, ImGuiSelectableFlags_AllowDoubleClick)) {
-							if (ImGui::IsMouseDoubleClicked(0)) {
-								Model* model = new Model();
-								model->LoadModel(entry.path().string());
-
-								std::string* name = new std::string(fileName.substr(0, fileName.find(".obj")));
-								Object* object = new Object(*model, *name);
-
-								objects.push_back(object);
-
-								importObject = false;
-							}
-						}
-					}
-				}
-			ImGui::End();
-		}
-
-		for (Object* object : objects) {
-			if (object->getIsSelected()) {
-				bool isSelected = object->getIsSelected();
-				ImGui::Begin(object->getName(), &isSelected);
-
-					
-
-					float position[4] = { object->getPos().x, object->getPos().y, object->getPos().z, 0.0f };
-					float rotation[4] = { object->getRot().x, object->getRot().y, object->getRot().z, 0.0f };
-					float scale[4] = { object->getScale().x, object->getScale().y, object->getScale().z, 0.0f };
-
-					ImGui::DragFloat3("Position", position, 0.1f);
-					ImGui::DragFloat3("Rotation", rotation, 0.1f);
-					ImGui::DragFloat3("Scale", scale, 0.1f);
-
-					object->setPos(position[0], position[1], position[2]);
-					object->setRot(rotation[0], rotation[1], rotation[2]);
-					object->setScale(scale[0], scale[1], scale[2]);
-
-				ImGui::End();
-
-				object->setIsSelected(isSelected);
-			}
-		}
-
-		ImGui::ShowDemoWindow();
-
-		// Render dear imgui into screen
-		ImGui::Render();
-		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-
-		mainWindow.swapBuffers();
-	}
-
-	return 0;
+#define STB_IMAGE_IMPLEMENTATION
+
+#include <stdio.h>
+#include <string.h>
+#include <cmath>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <functional>
+#include <filesystem>
+
+#include <GL\glew.h>
+#include <GLFW\glfw3.h>
+
+#include <glm\glm.hpp>
+#include <glm\gtc\matrix_transform.hpp>
+#include <glm\gtc\type_ptr.hpp>
+
+#include "imgui\imgui.h"
+#include "imgui\imgui_impl_glfw.h"
+#include "imgui\imgui_impl_opengl3.h"
+
+#include "CommonValues.h"
+
+#include "Window.h"
+#include "Mesh.h"
+#include "Shader.h"
+#include "Camera.h"
+#include "Texture.h"
+#include "DirectionalLight.h"
+#include "PointLight.h"
+#include "SpotLight.h"
+#include "Material.h"
+#include "Object.h"
+#include "Model.h"
+#include "Skybox.h"
+#include "RenderTarget.h"
+#include "FrameStats.h"
+#include "SceneLoader.h"
+#include "GpuProfiler.h"
+#include "CpuProfiler.h"
+#include "CameraPath.h"
+#include "Geometry.h"
+#include "AssetRegistry.h"
+#include "Culling.h"
+#include "AabbTree.h"
+#include "InstanceBuffer.h"
+#include "RenderQueue.h"
+#include "GpuScene.h"
+#include "ShadowCache.h"
+#include "ShadowAtlas.h"
+#include "LightClusters.h"
+#include "GBuffer.h"
+#include "ShadowMoments.h"
+
+const float toRadians = 3.14159265f / 180.0f;
+
+GLuint uniformModel = 0, uniformSpecularIntensity = 0, uniformShininess = 0;
+
+Window mainWindow;
+
+Shader directionalShadowShader;
+Shader omniShadowShader;
+
+// Same passes, but reading world and normal matrices from per-instance attributes
+Shader directionalShadowInstancedShader;
+Shader omniShadowInstancedShader;
+
+// Same passes again, reading the matrices from GpuScene's transform buffer
+Shader directionalShadowIndirectShader;
+Shader omniShadowIndirectShader;
+
+// Omni shadow passes that cull and draw each cube face on its own instead of copying every triangle
+// to all six in a geometry shader. Face passes attach one face at a time, layered ones write gl_Layer
+// from the vertex shader into the whole cube
+Shader omniShadowFaceShader;
+Shader omniShadowFaceInstancedShader;
+Shader omniShadowFaceIndirectShader;
+Shader omniShadowLayeredShader;
+Shader omniShadowLayeredInstancedShader;
+Shader omniShadowLayeredIndirectShader;
+
+// Deferred path: the scene is drawn into the GBuffer with these, then lit once per pixel by a full-screen
+// pass built from the main fragment shader
+Shader gBufferShader;
+Shader gBufferInstancedShader;
+Shader gBufferIndirectShader;
+
+// Position-only programs laying down the camera's depth before the lit forward pass
+Shader depthPrePassShader;
+Shader depthPrePassInstancedShader;
+Shader depthPrePassIndirectShader;
+
+Camera camera;
+
+Texture plainTexture;
+
+DirectionalLight mainLight;
+PointLight pointLights[MAX_POINT_LIGHTS];
+SpotLight spotLights[MAX_SPOT_LIGHTS];
+
+// Unshadowed point lights from the scene file or --fixtures, any number of them
+std::vector<PointLight> fixtureLights;
+LightClusters lightClusters;
+
+Skybox skybox;
+
+// Set in headless mode, the main pass then renders here instead of the window
+RenderTarget* offscreenTarget = nullptr;
+
+// Forward shading stays the default, deferred can be switched on at runtime to compare the two
+bool deferredShading = false;
+GBuffer gBuffer;
+
+// With the pre-pass the forward pass tests GL_EQUAL against the finished depth buffer, so hidden surfaces
+// never run the lighting shader
+bool depthPrePass = false;
+
+GpuProfiler gpuProfiler;
+
+bool frustumCulling = true;
+// Every object in the scene, for culling, light range queries and picking
+AabbTree sceneTree;
+// Refilled by each pass
+std::vector<void*> visibleObjects;
+std::vector<Object*> renderObjects;
+
+// Objects sharing a model are drawn with one instanced call per mesh
+bool instancedRendering = true;
+
+RenderQueue renderQueue;
+
+// On GL 4.3 each pass is one multi-draw indirect call over GpuScene, culled by a compute shader
+bool indirectRendering = true;
+
+CullStats mainCullStats;
+CullStats shadowCullStats;
+CullStats prePassCullStats;
+
+// Shadow maps are only redrawn when their light or the casters in range change
+bool shadowCaching = true;
+ShadowCache directionalShadowCaches[MAX_SHADOW_CASCADES];
+ShadowCache pointShadowCaches[MAX_POINT_LIGHTS];
+ShadowCache spotShadowCaches[MAX_SPOT_LIGHTS];
+ShadowCacheStats shadowCacheStats;
+
+// Point and spot light shadows share one depth texture, tiles sized by how much of the screen each light covers
+ShadowAtlas shadowAtlas;
+GLuint shadowAtlasSize = 4096;
+std::vector<ShadowRequest> shadowRequests;
+
+enum OmniShadowMode
+{
+	OMNI_SHADOW_GEOMETRY,	// one draw, the geometry shader emits each triangle to all six face viewports
+	OMNI_SHADOW_FACES,		// a pass per face, each culled against that face's frustum
+	OMNI_SHADOW_LAYERED		// the same culled draws per face, routed to the face's viewport without changing it
+};
+int omniShadowMode = OMNI_SHADOW_GEOMETRY;
+
+// Shadow filter tiers, taps per lookup. Past shadowTapDistance from the eye lookups drop a tier
+// each time the distance doubles, 0 keeps full quality everywhere
+const int shadowTapTiers[] = { 1, 4, 8, 20 };
+int shadowTaps = 8;
+float shadowTapDistance = 20.0f;
+
+// Alternatively the main shaders read EVSM moments, filtered once whenever a map is redrawn
+bool shadowMoments = false;
+ShadowMoments cascadeMoments;
+ShadowMoments atlasMoments;
+
+unsigned int pointLightCount = 0;
+unsigned int spotLightCount = 0;
+
+// The main fragment shader is specialised to the frame: light types it has none of and the shadow technique not in
+// use are compiled out. A set of programs per combination, each compiled the first time its combination comes up
+const unsigned int MAIN_VARIANT_POINT_LIGHTS = 1;
+const unsigned int MAIN_VARIANT_SPOT_LIGHTS = 2;
+const unsigned int MAIN_VARIANT_POINT_SHADOWS = 4;
+const unsigned int MAIN_VARIANT_SHADOW_MOMENTS = 8;
+
+struct MainShaders
+{
+	Shader forward;
+	Shader instanced;
+	Shader indirect;
+	Shader deferredLighting;
+};
+std::map<unsigned int, MainShaders> mainShaderVariants;
+
+GLfloat deltaTime = 0.0f;
+GLfloat lastTime = 0.0f;
+
+GLfloat blackhawkAngle = 0.0f;
+
+static std::vector<Object*> objects;
+// Vertex Shader
+static const char* vShader = "Shaders/shader.vert";
+
+// Fragment Shader
+static const char* fShader = "Shaders/shader.frag";
+
+// Benchmark replays advance by a fixed step per frame so every run sees the same camera poses
+static const GLfloat benchmarkTimeStep = 1.0f / 60.0f;
+
+struct BenchmarkSettings
+{
+	int frames;
+	int warmup;
+	const char* cameraPathFile;
+	const char* reportFile;
+	int objectCount;	// 0 keeps the scene as loaded
+	int fixtureCount;	// unshadowed point lights added over the scene
+	int lightCount;		// -1 keeps every light
+	bool culling;
+	bool instancing;
+	bool indirect;
+	bool shadowCache;
+	int cascadeCount;	// 0 keeps the light's default
+	int omniShadowMode;	// -1 keeps the best one supported
+	bool deferred;
+	bool depthPrePass;
+	int shadowTaps;		// 0 keeps the default tier
+	bool shadowMoments;
+};
+
+void CreateShaders()
+{
+	directionalShadowShader.CreateFromFiles("Shaders/directional_shadow_map.vert", "Shaders/directional_shadow_map.frag");
+
+	directionalShadowInstancedShader.CreateFromFiles("Shaders/directional_shadow_map_instanced.vert", "Shaders/directional_shadow_map.frag");
+
+	gBufferShader.CreateFromFiles(vShader, "Shaders/gbuffer.frag");
+	gBufferInstancedShader.CreateFromFiles("Shaders/shader_instanced.vert", "Shaders/gbuffer.frag");
+
+	depthPrePassShader.CreateFromFiles("Shaders/depth_prepass.vert", "Shaders/directional_shadow_map.frag");
+	depthPrePassInstancedShader.CreateFromFiles("Shaders/depth_prepass_instanced.vert", "Shaders/directional_shadow_map.frag");
+
+	// gl_ViewportIndex from the geometry shader is GLSL 4.10
+	if (GLEW_VERSION_4_1)
+	{
+		omniShadowShader.CreateFromFiles("Shaders/omni_shadow_map.vert", "Shaders/omni_shadow_map.geom", "Shaders/omni_shadow_map.frag");
+		omniShadowInstancedShader.CreateFromFiles("Shaders/omni_shadow_map_instanced.vert", "Shaders/omni_shadow_map.geom", "Shaders/omni_shadow_map.frag");
+	}
+
+	// GLSL 4.30, these don't compile on older contexts
+	if (GpuScene::Init())
+	{
+		gBufferIndirectShader.CreateFromFiles("Shaders/shader_indirect.vert", "Shaders/gbuffer.frag");
+		depthPrePassIndirectShader.CreateFromFiles("Shaders/depth_prepass_indirect.vert", "Shaders/directional_shadow_map.frag");
+		directionalShadowIndirectShader.CreateFromFiles("Shaders/directional_shadow_map_indirect.vert", "Shaders/directional_shadow_map.frag");
+		omniShadowIndirectShader.CreateFromFiles("Shaders/omni_shadow_map_indirect.vert", "Shaders/omni_shadow_map.geom", "Shaders/omni_shadow_map.frag");
+		omniShadowFaceIndirectShader.CreateFromFiles("Shaders/omni_shadow_map_face_indirect.vert", "Shaders/omni_shadow_map.frag");
+	}
+
+	omniShadowFaceShader.CreateFromFiles("Shaders/omni_shadow_map_face.vert", "Shaders/omni_shadow_map.frag");
+	omniShadowFaceInstancedShader.CreateFromFiles("Shaders/omni_shadow_map_face_instanced.vert", "Shaders/omni_shadow_map.frag");
+	omniShadowMode = OMNI_SHADOW_FACES;
+
+	// gl_ViewportIndex from a vertex shader needs ARB_shader_viewport_layer_array, written against GLSL 4.10
+	if (GLEW_ARB_shader_viewport_layer_array && GLEW_VERSION_4_1)
+	{
+		omniShadowLayeredShader.CreateFromFiles("Shaders/omni_shadow_map_layered.vert", "Shaders/omni_shadow_map.frag");
+		omniShadowLayeredInstancedShader.CreateFromFiles("Shaders/omni_shadow_map_layered_instanced.vert", "Shaders/omni_shadow_map.frag");
+		if (GpuScene::IsSupported())
+		{
+			omniShadowLayeredIndirectShader.CreateFromFiles("Shaders/omni_shadow_map_layered_indirect.vert", "Shaders/omni_shadow_map.frag");
+		}
+		omniShadowMode = OMNI_SHADOW_LAYERED;
+	}
+}
+
+unsigned int MainShaderVariant()
+{
+	unsigned int variant = 0;
+	if (pointLightCount > 0 || !fixtureLights.empty())
+	{
+		variant |= MAIN_VARIANT_POINT_LIGHTS;
+	}
+	if (pointLightCount > 0)
+	{
+		variant |= MAIN_VARIANT_POINT_SHADOWS;
+	}
+	if (spotLightCount > 0)
+	{
+		variant |= MAIN_VARIANT_SPOT_LIGHTS;
+	}
+	if (shadowMoments)
+	{
+		variant |= MAIN_VARIANT_SHADOW_MOMENTS;
+	}
+	return variant;
+}
+
+// Programs for this frame's lights and shadow technique, compiled on first use
+MainShaders& GetMainShaders()
+{
+	unsigned int variant = MainShaderVariant();
+	auto found = mainShaderVariants.find(variant);
+	if (found != mainShaderVariants.end())
+	{
+		return found->second;
+	}
+
+	MainShaders& shaders = mainShaderVariants[variant];
+	Shader* programs[] = { &shaders.forward, &shaders.instanced, &shaders.indirect, &shaders.deferredLighting };
+	for (Shader* program : programs)
+	{
+		if (variant & MAIN_VARIANT_POINT_LIGHTS) program->AddDefine("POINT_LIGHTS");
+		if (variant & MAIN_VARIANT_SPOT_LIGHTS) program->AddDefine("SPOT_LIGHTS");
+		if (variant & MAIN_VARIANT_POINT_SHADOWS) program->AddDefine("POINT_SHADOWS");
+		if (variant & MAIN_VARIANT_SHADOW_MOMENTS) program->AddDefine("SHADOW_MOMENTS");
+	}
+	shaders.deferredLighting.AddDefine("DEFERRED_LIGHTING");
+
+	shaders.forward.CreateFromFiles(vShader, fShader);
+	shaders.instanced.CreateFromFiles("Shaders/shader_instanced.vert", fShader);
+	shaders.deferredLighting.CreateFromFiles("Shaders/fullscreen.vert", fShader);
+	if (GpuScene::IsSupported())
+	{
+		shaders.indirect.CreateFromFiles("Shaders/shader_indirect.vert", fShader);
+	}
+
+	return shaders;
+}
+
+// The mode --omni-shadows names, or -1 for anything else
+int OmniShadowModeFromName(const char* name)
+{
+	if (strcmp(name, "geometry") == 0) return OMNI_SHADOW_GEOMETRY;
+	if (strcmp(name, "faces") == 0) return OMNI_SHADOW_FACES;
+	if (strcmp(name, "layered") == 0) return OMNI_SHADOW_LAYERED;
+	return -1;
+}
+
+bool OmniShadowModeSupported(int mode)
+{
+	if (mode == OMNI_SHADOW_FACES)
+	{
+		return true;
+	}
+
+	return GLEW_VERSION_4_1 && (mode != OMNI_SHADOW_LAYERED || GLEW_ARB_shader_viewport_layer_array);
+}
+
+bool IndirectRenderingActive()
+{
+	return indirectRendering && GpuScene::IsSupported();
+}
+
+void UpdateObjectTransforms()
+{
+	PROFILE_ZONE("UpdateObjectTransforms");
+
+	Object::AdvanceFrame();
+	Object::UpdatePendingTransforms();
+
+	if (IndirectRenderingActive())
+	{
+		GpuScene::Update(objects);
+	}
+}
+
+void ResetRenderStats()
+{
+	Mesh::ResetRenderStats();
+	renderQueue.ResetStats();
+	mainCullStats = { 0, 0, 0 };
+	shadowCullStats = { 0, 0, 0 };
+	prePassCullStats = { 0, 0, 0 };
+	shadowCacheStats = { 0, 0, 0 };
+}
+
+// End of the run of renderObjects sharing the model of renderObjects[begin]
+size_t ModelRunEnd(size_t begin)
+{
+	size_t end = begin + 1;
+	while (end < renderObjects.size() && renderObjects[end]->getModel() == renderObjects[begin]->getModel()) {
+		end++;
+	}
+	return end;
+}
+
+// Which objects a pass draws, shadow caching draws static and moving casters into separate layers
+enum SceneCasters
+{
+	CASTERS_ALL,
+	CASTERS_STATIC,
+	CASTERS_DYNAMIC
+};
+
+// Queues the objects in the volume and submits them sorted by state. Models shared by several objects
+// are drawn with instancedProgram, once per mesh for all of them. With indirect rendering GpuScene culls
+// and draws everything with indirectProgram instead, so stats aren't counted and casters are ignored
+void RenderScene(const CullVolume& volume, CullStats& stats, Shader* program, Shader* instancedProgram, Shader* indirectProgram, bool depthOnly,
+	SceneCasters casters)
+{
+	PROFILE_ZONE("RenderScene");
+
+	if (IndirectRenderingActive()) {
+		GpuScene::Draw(indirectProgram, frustumCulling ? &volume : nullptr, depthOnly);
+		return;
+	}
+
+	size_t candidates = objects.size();
+
+	if (casters == CASTERS_DYNAMIC) {
+		// Few objects move at once, test them directly rather than query the whole tree
+		renderObjects.clear();
+		for (Object* object : Object::GetMovingObjects()) {
+			if (!frustumCulling || BoxInVolume(volume, object->getWorldBounds())) {
+				renderObjects.push_back(object);
+			}
+		}
+		candidates = Object::GetMovingObjects().size();
+	}
+	else if (frustumCulling) {
+		visibleObjects.clear();
+		PROFILE_ZONE_BEGIN("QueryVolume");
+		sceneTree.QueryVolume(volume, visibleObjects);
+		PROFILE_ZONE_END();
+
+		renderObjects.clear();
+		for (void* visibleObject : visibleObjects) {
+			renderObjects.push_back((Object*)visibleObject);
+		}
+	}
+	else {
+		renderObjects = objects;
+	}
+
+	if (casters == CASTERS_STATIC) {
+		renderObjects.erase(std::remove_if(renderObjects.begin(), renderObjects.end(), [](Object* object) { return !object->isStaticCaster(); }), renderObjects.end());
+		candidates -= Object::GetMovingObjects().size();
+	}
+
+	stats.objectsDrawn += renderObjects.size();
+	stats.objectsCulled += candidates - renderObjects.size();
+
+	if (instancedRendering) {
+		std::sort(renderObjects.begin(), renderObjects.end(), [](Object* a, Object* b) { return a->getModel() < b->getModel(); });
+	}
+
+	PROFILE_ZONE_BEGIN("Fill render queue");
+	renderQueue.Begin(depthOnly);
+
+	for (size_t i = 0; i < renderObjects.size(); ) {
+		size_t end = instancedRendering ? ModelRunEnd(i) : i + 1;
+		Model* model = renderObjects[i]->getModel();
+
+		if (end - i >= 2) {
+			GLuint firstInstance = renderQueue.AddInstance(renderObjects[i]->getWorldMatrix(), renderObjects[i]->getNormalMatrix());
+			for (size_t j = i + 1; j < end; j++) {
+				renderQueue.AddInstance(renderObjects[j]->getWorldMatrix(), renderObjects[j]->getNormalMatrix());
+			}
+
+			for (size_t mesh = 0; mesh < model->GetMeshCount(); mesh++) {
+				renderQueue.AddInstancedDraw(model->GetMesh(mesh), model->GetMeshTexture(mesh), firstInstance, end - i);
+			}
+		}
+		else {
+			const glm::mat4& worldMatrix = renderObjects[i]->getWorldMatrix();
+			const glm::mat3& normalMatrix = renderObjects[i]->getNormalMatrix();
+
+			for (size_t mesh = 0; mesh < model->GetMeshCount(); mesh++) {
+				if (frustumCulling && !model->IsMeshVisible(mesh, worldMatrix, volume)) {
+					stats.meshesCulled++;
+					continue;
+				}
+				renderQueue.AddDraw(model->GetMesh(mesh), model->GetMeshTexture(mesh), &worldMatrix, &normalMatrix);
+			}
+		}
+
+		i = end;
+	}
+	PROFILE_ZONE_END();
+
+	renderQueue.Submit(program, instancedProgram);
+	//shinyMaterial.UseMaterial(uniformSpecularIntensity, uniformShininess);
+}
+
+// Redraws what the light's cache reports as changed, volume being everything the light reaches.
+// drawCasters renders the given casters into the target Write or WriteStaticLayer bound, with the pass's programs already set up.
+// Returns whether the map changed
+bool DrawShadowCasters(ShadowMap* shadowMap, ShadowCache& cache, const CullVolume& volume, const std::function<void(SceneCasters)>& drawCasters)
+{
+	ShadowUpdate update = shadowCaching ? cache.Evaluate(volume) : SHADOW_UPDATE_FULL;
+
+	if (update == SHADOW_UPDATE_NONE)
+	{
+		shadowCacheStats.skippedUpdates++;
+		return false;
+	}
+
+	// GpuScene draws every object in one go, there caching can only skip whole maps
+	if (!shadowCaching || IndirectRenderingActive() || !shadowMap->InitStaticLayer())
+	{
+		shadowMap->Write();
+		shadowMap->Clear();
+		drawCasters(CASTERS_ALL);
+
+		cache.SetHasStaticLayer(false);
+		shadowCacheStats.fullUpdates++;
+		return true;
+	}
+
+	if (update == SHADOW_UPDATE_FULL || !cache.HasStaticLayer())
+	{
+		shadowMap->WriteStaticLayer();
+		shadowMap->Clear();
+		drawCasters(CASTERS_STATIC);
+
+		cache.SetHasStaticLayer(true);
+		shadowCacheStats.fullUpdates++;
+	}
+	else
+	{
+		shadowCacheStats.dynamicUpdates++;
+	}
+
+	shadowMap->CopyStaticLayer();
+	shadowMap->Write();
+	drawCasters(CASTERS_DYNAMIC);
+	return true;
+}
+
+// The depth-only programs drawing through the ShadowView block, for cascades and spot lights
+void SetShadowViewUniforms()
+{
+	if (instancedRendering)
+	{
+		directionalShadowInstancedShader.UseShader();
+		directionalShadowInstancedShader.Validate();
+	}
+
+	if (IndirectRenderingActive())
+	{
+		directionalShadowIndirectShader.UseShader();
+		directionalShadowIndirectShader.Validate();
+	}
+
+	directionalShadowShader.UseShader();
+
+	uniformModel = directionalShadowShader.GetModelLocation();
+
+	directionalShadowShader.Validate();
+}
+
+void DirectionalShadowMapPass(DirectionalLight* light)
+{
+	SetShadowViewUniforms();
+
+	glViewport(0, 0, light->getShadowMap()->GetShadowWidth(), light->getShadowMap()->GetShadowHeight());
+
+	CascadedShadowMap* shadowMap = light->getCascadedShadowMap();
+	for (unsigned int i = 0; i < light->GetCascadeCount(); i++)
+	{
+		FrameUniforms::BindCascadeShadowView(i);
+		shadowMap->SetCascade(i);
+
+		// Casters outside the cascade's ortho box are clipped anyway
+		CullVolume volume = CreateFrustumVolume(light->GetCascadeTransform(i));
+		bool redrawn = DrawShadowCasters(shadowMap, directionalShadowCaches[i], volume, [&](SceneCasters casters) {
+			RenderScene(volume, shadowCullStats, &directionalShadowShader, &directionalShadowInstancedShader, &directionalShadowIndirectShader, true, casters);
+		});
+
+		if (redrawn && shadowMoments)
+		{
+			cascadeMoments.Resolve(shadowMap->GetShadowTexture(), i, 0, 0, shadowMap->GetShadowWidth(), 0.0f, 0.0f);
+		}
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+// Spot lights draw one perspective map into their atlas tile with the same depth-only programs as the cascades
+void SpotShadowMapPass(SpotLight* light, unsigned int spotIndex, ShadowCache& cache)
+{
+	// Unlit or off screen cones got no tile, their maps are skipped until they get one again
+	ShadowAllocation* allocation = light->GetShadowAllocation();
+	if (allocation->tileSize == 0)
+	{
+		cache.Invalidate();
+		return;
+	}
+
+	FrameUniforms::BindSpotShadowView(spotIndex);
+
+	SetShadowViewUniforms();
+
+	const ShadowTile& tile = allocation->tiles[0];
+	glViewport(tile.x, tile.y, tile.size, tile.size);
+	shadowAtlas.SetRegion(allocation, 1);
+
+	CullVolume volume = CreateFrustumVolume(light->CalculateSpotTransform());
+	bool redrawn = DrawShadowCasters(&shadowAtlas, cache, volume, [&](SceneCasters casters) {
+		RenderScene(volume, shadowCullStats, &directionalShadowShader, &directionalShadowInstancedShader, &directionalShadowIndirectShader, true, casters);
+	});
+
+	if (redrawn && shadowMoments)
+	{
+		atlasMoments.Resolve(shadowAtlas.GetShadowTexture(), 0, tile.x, tile.y, tile.size, light->GetNearPlane(), light->GetFarPlane());
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void SetOmniShadowUniforms(Shader* shader)
+{
+	shader->UseShader();
+
+	uniformModel = shader->GetModelLocation();
+
+	shader->Validate();
+}
+
+// One viewport per cube face, for the programs that route triangles to their face with gl_ViewportIndex
+void SetFaceViewports(const ShadowAllocation* allocation)
+{
+	for (GLuint face = 0; face < 6; face++)
+	{
+		const ShadowTile& tile = allocation->tiles[face];
+		glViewportIndexedf(face, (GLfloat)tile.x, (GLfloat)tile.y, (GLfloat)tile.size, (GLfloat)tile.size);
+	}
+}
+
+// pointIndex picks the light's OmniShadow block, the six faces are drawn into the light's atlas tiles
+void OmniShadowMapPass(PointLight* light, unsigned int pointIndex, ShadowCache& cache)
+{
+	ShadowAllocation* allocation = light->GetShadowAllocation();
+	if (allocation->tileSize == 0)
+	{
+		cache.Invalidate();
+		return;
+	}
+
+	FrameUniforms::BindOmniShadow(pointIndex);
+
+	shadowAtlas.SetRegion(allocation, 6);
+	if (omniShadowMode != OMNI_SHADOW_FACES)
+	{
+		SetFaceViewports(allocation);
+	}
+
+	Shader* program = &omniShadowShader;
+	Shader* instancedProgram = &omniShadowInstancedShader;
+	Shader* indirectProgram = &omniShadowIndirectShader;
+	if (omniShadowMode == OMNI_SHADOW_FACES)
+	{
+		program = &omniShadowFaceShader;
+		instancedProgram = &omniShadowFaceInstancedShader;
+		indirectProgram = &omniShadowFaceIndirectShader;
+	}
+	else if (omniShadowMode == OMNI_SHADOW_LAYERED)
+	{
+		program = &omniShadowLayeredShader;
+		instancedProgram = &omniShadowLayeredInstancedShader;
+		indirectProgram = &omniShadowLayeredIndirectShader;
+	}
+
+	if (instancedRendering)
+	{
+		SetOmniShadowUniforms(instancedProgram);
+	}
+	if (IndirectRenderingActive())
+	{
+		SetOmniShadowUniforms(indirectProgram);
+	}
+	SetOmniShadowUniforms(program);
+
+	// Every cube face together covers the sphere out to the far plane, so this draws just the objects in the light's range
+	CullVolume volume = CreateSphereVolume(light->GetPosition(), light->GetFarPlane());
+
+	bool redrawn = false;
+	if (omniShadowMode == OMNI_SHADOW_GEOMETRY)
+	{
+		redrawn = DrawShadowCasters(&shadowAtlas, cache, volume, [&](SceneCasters casters) {
+			RenderScene(volume, shadowCullStats, program, instancedProgram, indirectProgram, true, casters);
+		});
+	}
+	else
+	{
+		// Most casters touch one or two faces, so each face only draws what lies in its own frustum
+		std::vector<glm::mat4> lightMatrices = light->CalculateLightTransform();
+		CullVolume faceVolumes[6];
+		for (GLenum face = 0; face < 6; face++)
+		{
+			faceVolumes[face] = CreateFrustumVolume(lightMatrices[face]);
+		}
+
+		redrawn = DrawShadowCasters(&shadowAtlas, cache, volume, [&](SceneCasters casters) {
+			for (GLenum face = 0; face < 6; face++) {
+				FrameUniforms::BindOmniShadowFace(face);
+				if (omniShadowMode == OMNI_SHADOW_FACES) {
+					const ShadowTile& tile = allocation->tiles[face];
+					glViewport(tile.x, tile.y, tile.size, tile.size);
+				}
+				RenderScene(faceVolumes[face], shadowCullStats, program, instancedProgram, indirectProgram, true, casters);
+			}
+		});
+	}
+
+	// The faces hold distance over the far plane, already linear
+	if (redrawn && shadowMoments)
+	{
+		for (const ShadowTile& tile : allocation->tiles)
+		{
+			atlasMoments.Resolve(shadowAtlas.GetShadowTexture(), 0, tile.x, tile.y, tile.size, 0.0f, 0.0f);
+		}
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+// Filters the moments of every map redrawn this frame
+void ShadowMomentsPass()
+{
+	if (!shadowMoments)
+	{
+		return;
+	}
+
+	gpuProfiler.BeginZone("ShadowMomentsPass");
+	cascadeMoments.Update();
+	atlasMoments.Update();
+	gpuProfiler.EndZone();
+}
+
+// Moments are only rebuilt from maps as they are redrawn, so switching them on drops every cached map
+bool EnableShadowMoments()
+{
+	CascadedShadowMap* cascades = mainLight.getCascadedShadowMap();
+	if (!cascadeMoments.IsInitialised() && !cascadeMoments.Init(cascades->GetShadowWidth(), cascades->GetShadowHeight(), MAX_SHADOW_CASCADES))
+	{
+		return false;
+	}
+	if (!atlasMoments.IsInitialised() && !atlasMoments.Init(shadowAtlas.GetShadowWidth(), shadowAtlas.GetShadowHeight(), 1))
+	{
+		return false;
+	}
+
+	for (ShadowCache& cache : directionalShadowCaches)
+	{
+		cache.Invalidate();
+	}
+	for (ShadowCache& cache : pointShadowCaches)
+	{
+		cache.Invalidate();
+	}
+	for (ShadowCache& cache : spotShadowCaches)
+	{
+		cache.Invalidate();
+	}
+
+	shadowMoments = true;
+	return true;
+}
+
+// Camera and lights are already in the frame's uniform blocks, this binds the program's textures
+void SetMainShaderUniforms(Shader* shader)
+{
+	shader->UseShader();
+
+	uniformModel = shader->GetModelLocation();
+	uniformSpecularIntensity = shader->GetSpecularIntensityLocation();
+	uniformShininess = shader->GetShininessLocation();
+
+	mainLight.getShadowMap()->Read(GL_TEXTURE2);
+	shadowAtlas.Read(GL_TEXTURE3);
+	lightClusters.Read(GL_TEXTURE4);
+	shader->SetTexture(1);
+	shader->SetDirectionalShadowMap(2);
+	shader->SetShadowAtlas(3);
+	shader->SetLightClusters(4);
+	gBuffer.Read(GL_TEXTURE7);
+	shader->SetGBuffer(7);
+	cascadeMoments.Read(GL_TEXTURE11);
+	atlasMoments.Read(GL_TEXTURE12);
+	shader->SetShadowMoments(11);
+
+	shader->Validate();
+}
+
+void SetGBufferUniforms(Shader* shader)
+{
+	shader->UseShader();
+
+	uniformModel = shader->GetModelLocation();
+	uniformSpecularIntensity = shader->GetSpecularIntensityLocation();
+	uniformShininess = shader->GetShininessLocation();
+
+	shader->SetTexture(1);
+
+	shader->Validate();
+}
+
+// Clears the window or offscreen target and draws the skybox behind everything
+void BeginMainTarget()
+{
+	if (offscreenTarget)
+	{
+		offscreenTarget->Write();
+	}
+	else
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+	glViewport(0, 0, mainWindow.getBufferWidth(), mainWindow.getBufferHeight());
+
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	gpuProfiler.BeginZone("Skybox");
+	skybox.DrawSkybox();
+	gpuProfiler.EndZone();
+}
+
+// Lighting cost no longer scales with overdraw: the scene only writes its surfaces, and every pixel is lit once
+void DeferredRenderPass(glm::mat4 viewMatrix, glm::mat4 projectionMatrix)
+{
+	gpuProfiler.BeginZone("GBufferPass");
+
+	gBuffer.Write();
+	glViewport(0, 0, gBuffer.GetWidth(), gBuffer.GetHeight());
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	if (instancedRendering)
+	{
+		SetGBufferUniforms(&gBufferInstancedShader);
+	}
+	if (IndirectRenderingActive())
+	{
+		SetGBufferUniforms(&gBufferIndirectShader);
+	}
+	SetGBufferUniforms(&gBufferShader);
+
+	RenderScene(CreateFrustumVolume(projectionMatrix * viewMatrix), mainCullStats, &gBufferShader, &gBufferInstancedShader, &gBufferIndirectShader, false, CASTERS_ALL);
+
+	gpuProfiler.EndZone();
+
+	BeginMainTarget();
+
+	gpuProfiler.BeginZone("LightingPass");
+
+	// Pixels left at the far plane discard, so the skybox shows through
+	SetMainShaderUniforms(&GetMainShaders().deferredLighting);
+	glDisable(GL_DEPTH_TEST);
+	gBuffer.DrawFullScreen();
+	glEnable(GL_DEPTH_TEST);
+
+	gpuProfiler.EndZone();
+}
+
+void SetDepthPrePassUniforms()
+{
+	if (instancedRendering)
+	{
+		depthPrePassInstancedShader.UseShader();
+		depthPrePassInstancedShader.Validate();
+	}
+
+	if (IndirectRenderingActive())
+	{
+		depthPrePassIndirectShader.UseShader();
+		depthPrePassIndirectShader.Validate();
+	}
+
+	depthPrePassShader.UseShader();
+
+	uniformModel = depthPrePassShader.GetModelLocation();
+
+	depthPrePassShader.Validate();
+}
+
+// Fills the depth buffer only, leaving depth testing at GL_EQUAL with writes off for the lit pass
+void DepthPrePass(const CullVolume& volume)
+{
+	gpuProfiler.BeginZone("DepthPrePass");
+
+	SetDepthPrePassUniforms();
+
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	RenderScene(volume, prePassCullStats, &depthPrePassShader, &depthPrePassInstancedShader, &depthPrePassIndirectShader, true, CASTERS_ALL);
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+	glDepthFunc(GL_EQUAL);
+	glDepthMask(GL_FALSE);
+
+	gpuProfiler.EndZone();
+}
+
+void RenderPass(glm::mat4 viewMatrix, glm::mat4 projectionMatrix)
+{
+	if (deferredShading)
+	{
+		DeferredRenderPass(viewMatrix, projectionMatrix);
+		return;
+	}
+
+	BeginMainTarget();
+
+	CullVolume volume = CreateFrustumVolume(projectionMatrix * viewMatrix);
+	if (depthPrePass)
+	{
+		DepthPrePass(volume);
+	}
+
+	gpuProfiler.BeginZone("RenderPass");
+
+	MainShaders& mainShaders = GetMainShaders();
+	if (instancedRendering)
+	{
+		SetMainShaderUniforms(&mainShaders.instanced);
+	}
+	if (IndirectRenderingActive())
+	{
+		SetMainShaderUniforms(&mainShaders.indirect);
+	}
+	SetMainShaderUniforms(&mainShaders.forward);
+
+	RenderScene(volume, mainCullStats, &mainShaders.forward, &mainShaders.instanced, &mainShaders.indirect, false, CASTERS_ALL);
+
+	glDepthFunc(GL_LESS);
+	glDepthMask(GL_TRUE);
+
+	gpuProfiler.EndZone();
+}
+
+// Hands out this frame's atlas tiles, lights covering more of the screen and brighter ones get the larger tiles.
+// Lights whose tiles moved lose their cached maps
+void AllocateShadowTiles(glm::mat4 viewMatrix, glm::mat4 projectionMatrix)
+{
+	PROFILE_ZONE("AllocateShadowTiles");
+
+	GLuint viewportHeight = mainWindow.getBufferHeight();
+
+	// Sized by the sphere the light actually reaches, lighting and so its shadow stop at its range
+	shadowRequests.clear();
+	for (size_t i = 0; i < pointLightCount; i++)
+	{
+		PointLight* light = &pointLights[i];
+		GLuint size = ShadowAtlas::DesiredTileSize(light->GetPosition(), std::min(light->GetRange(), light->GetFarPlane()), viewMatrix, projectionMatrix,
+			viewportHeight, light->GetShadowSize());
+		shadowRequests.push_back({ light->GetShadowAllocation(), 6, size, size * light->getDiffuseIntensity() });
+	}
+	for (size_t i = 0; i < spotLightCount; i++)
+	{
+		SpotLight* light = &spotLights[i];
+		GLuint size = 0;
+		if (light->IsOn())
+		{
+			size = ShadowAtlas::DesiredTileSize(light->GetPosition(), std::min(light->GetRange(), light->GetFarPlane()), viewMatrix, projectionMatrix,
+				viewportHeight, light->GetShadowSize());
+		}
+		shadowRequests.push_back({ light->GetShadowAllocation(), 1, size, size * light->getDiffuseIntensity() });
+	}
+
+	shadowAtlas.Allocate(shadowRequests);
+
+	for (size_t i = 0; i < pointLightCount; i++)
+	{
+		if (pointLights[i].GetShadowAllocation()->moved)
+		{
+			pointShadowCaches[i].Invalidate();
+		}
+	}
+	for (size_t i = 0; i < spotLightCount; i++)
+	{
+		if (spotLights[i].GetShadowAllocation()->moved)
+		{
+			spotShadowCaches[i].Invalidate();
+		}
+	}
+}
+
+// Fills the uniform blocks every pass of the frame reads
+void UpdateFrameUniforms(glm::mat4 viewMatrix, glm::mat4 projectionMatrix)
+{
+	PROFILE_ZONE("UpdateFrameUniforms");
+
+	// The flashlight follows the camera, move it before its shadow map is drawn
+	glm::vec3 lowerLight = camera.getCameraPosition();
+	lowerLight.y -= 0.3f;
+	spotLights[0].SetFlash(lowerLight, camera.getCameraDirection());
+
+	// Cascades follow the camera, and reach back to every caster in the scene
+	BoundingBox sceneBounds = { glm::vec3(0.0f), glm::vec3(0.0f) };
+	sceneTree.GetBounds(sceneBounds);
+	mainLight.UpdateCascades(viewMatrix, projectionMatrix, sceneBounds);
+
+	AllocateShadowTiles(viewMatrix, projectionMatrix);
+
+	// Shadowed lights are added with their ShadowTransforms slots, fixtures without one
+	lightClusters.Clear();
+	for (size_t i = 0; i < pointLightCount; i++)
+	{
+		lightClusters.AddPointLight(&pointLights[i], (int)i);
+	}
+	for (size_t i = 0; i < spotLightCount; i++)
+	{
+		lightClusters.AddSpotLight(&spotLights[i], (int)i);
+	}
+	for (PointLight& fixture : fixtureLights)
+	{
+		lightClusters.AddPointLight(&fixture, -1);
+	}
+	lightClusters.Build(viewMatrix, projectionMatrix, mainWindow.getBufferWidth(), mainWindow.getBufferHeight());
+
+	FrameUniforms::SetCamera(projectionMatrix, viewMatrix, camera.getCameraPosition());
+	FrameUniforms::SetShadowFilter(shadowTaps, shadowTapDistance);
+	FrameUniforms::SetLights(&mainLight, pointLights, pointLightCount, spotLights, spotLightCount, lightClusters);
+}
+
+void ShadowPasses()
+{
+	gpuProfiler.BeginZone("DirectionalShadowMapPass");
+	DirectionalShadowMapPass(&mainLight);
+	gpuProfiler.EndZone();
+
+	for (size_t i = 0; i < pointLightCount; i++)
+	{
+		gpuProfiler.BeginZone("OmniShadowMapPass point " + std::to_string(i));
+		OmniShadowMapPass(&pointLights[i], i, pointShadowCaches[i]);
+		gpuProfiler.EndZone();
+	}
+	for (size_t i = 0; i < spotLightCount; i++)
+	{
+		gpuProfiler.BeginZone("SpotShadowMapPass " + std::to_string(i));
+		SpotShadowMapPass(&spotLights[i], i, spotShadowCaches[i]);
+		gpuProfiler.EndZone();
+	}
+
+	ShadowMomentsPass();
+}
+
+void ReplicateObjects(size_t count)
+{
+	if (objects.empty())
+	{
+		return;
+	}
+
+	std::vector<Object*> templates = objects;
+	objects.clear();
+
+	// The templates move to their own cells first, copies are offset from where they were loaded
+	std::vector<glm::vec3> templatePositions;
+	for (Object* source : templates)
+	{
+		templatePositions.push_back(source->getPos());
+	}
+
+	// Lay the copies out on a square grid centred on the origin, cycling through the loaded objects
+	const float spacing = 3.0f;
+	size_t gridSize = (size_t)ceil(sqrt((double)count));
+	float gridOffset = (gridSize - 1) * spacing * 0.5f;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		Object* source = templates[i % templates.size()];
+		Object* object = source;
+
+		if (i >= templates.size())
+		{
+			std::string* name = new std::string(source->getName());
+			object = new Object(source->getModelHandle(), *name);
+			object->setRot(source->getRot().x, source->getRot().y, source->getRot().z);
+			object->setScale(source->getScale().x, source->getScale().y, source->getScale().z);
+		}
+
+		glm::vec3 position = templatePositions[i % templates.size()];
+		object->setPos(position.x + (i % gridSize) * spacing - gridOffset, position.y, position.z + (i / gridSize) * spacing - gridOffset);
+
+		if (i >= templates.size())
+		{
+			object->AddToTree(&sceneTree);
+		}
+
+		objects.push_back(object);
+	}
+
+	// Inserted in grid order the tree comes out lopsided, rebuild it once they are all placed
+	Object::UpdatePendingTransforms();
+	sceneTree.Rebuild();
+
+	// The templates were already placed, so moving them marked them as moving casters. Nothing has been drawn yet,
+	// so the measured frames should start from an all-static scene
+	Object::SettleMovingObjects();
+}
+
+// Hangs count fixtures on a grid just above the scene, each reaching a little past its neighbours
+void AddFixtures(size_t count)
+{
+	BoundingBox bounds = { glm::vec3(0.0f), glm::vec3(10.0f, 0.0f, 10.0f) };
+	sceneTree.GetBounds(bounds);
+
+	size_t gridSize = (size_t)ceil(sqrt((double)count));
+	glm::vec3 corner = bounds.center - bounds.extent;
+	float spacingX = 2.0f * bounds.extent.x / gridSize;
+	float spacingZ = 2.0f * bounds.extent.z / gridSize;
+
+	const glm::vec3 colours[] = { glm::vec3(1.0f, 0.9f, 0.8f), glm::vec3(0.8f, 0.9f, 1.0f), glm::vec3(1.0f, 0.8f, 0.6f) };
+	for (size_t i = 0; i < count; i++)
+	{
+		glm::vec3 position = glm::vec3(corner.x + ((i % gridSize) + 0.5f) * spacingX, bounds.center.y + bounds.extent.y + 0.5f,
+			corner.z + ((i / gridSize) + 0.5f) * spacingZ);
+		float range = 1.5f * glm::max(glm::max(spacingX, spacingZ), 1.0f);
+		fixtureLights.push_back(PointLight(position, colours[i % 3], 1.0f, range));
+	}
+}
+
+// Nearest object whose bounds are under the cursor, or nullptr
+Object* PickObject(glm::mat4 viewMatrix, glm::mat4 projectionMatrix)
+{
+	double cursorX, cursorY;
+	int width, height;
+	glfwGetCursorPos(mainWindow.getGLWFWindow(), &cursorX, &cursorY);
+	glfwGetWindowSize(mainWindow.getGLWFWindow(), &width, &height);
+
+	glm::vec2 ndc = glm::vec2(2.0f * cursorX / width - 1.0f, 1.0f - 2.0f * cursorY / height);
+	glm::mat4 inverseViewProjection = glm::inverse(projectionMatrix * viewMatrix);
+
+	glm::vec4 nearPoint = inverseViewProjection * glm::vec4(ndc.x, ndc.y, -1.0f, 1.0f);
+	glm::vec4 farPoint = inverseViewProjection * glm::vec4(ndc.x, ndc.y, 1.0f, 1.0f);
+	glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+	glm::vec3 direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - origin);
+
+	float distance;
+	return (Object*)sceneTree.RayCast(origin, direction, distance);
+}
+
+void SetLightCount(int count)
+{
+	// Point lights are enabled first, the rest of the budget goes to spot lights
+	pointLightCount = std::min(count, MAX_POINT_LIGHTS);
+	spotLightCount = std::min(count - (int)pointLightCount, MAX_SPOT_LIGHTS);
+}
+
+int RunBenchmark(BenchmarkSettings settings, glm::mat4 projection)
+{
+	FrameStats stats;
+	double passStart = 0.0;
+
+	CameraPath cameraPath = CameraPath(settings.cameraPathFile);
+	if (settings.cameraPathFile && !cameraPath.LoadPath())
+	{
+		return 1;
+	}
+
+	if (settings.objectCount > 0)
+	{
+		ReplicateObjects(settings.objectCount);
+	}
+
+	if (settings.fixtureCount > 0)
+	{
+		AddFixtures(settings.fixtureCount);
+	}
+
+	if (settings.lightCount >= 0)
+	{
+		SetLightCount(settings.lightCount);
+	}
+
+	frustumCulling = settings.culling;
+	instancedRendering = settings.instancing;
+	indirectRendering = settings.indirect;
+	shadowCaching = settings.shadowCache;
+	deferredShading = settings.deferred;
+	depthPrePass = settings.depthPrePass;
+	if (settings.shadowTaps > 0)
+	{
+		if (std::find(std::begin(shadowTapTiers), std::end(shadowTapTiers), settings.shadowTaps) == std::end(shadowTapTiers))
+		{
+			printf("Shadow filters take 1, 4, 8 or 20 taps\n");
+			return 1;
+		}
+		shadowTaps = settings.shadowTaps;
+	}
+	if (settings.shadowMoments && !EnableShadowMoments())
+	{
+		return 1;
+	}
+	if (settings.cascadeCount > 0)
+	{
+		mainLight.SetCascadeCount(settings.cascadeCount);
+	}
+	if (settings.omniShadowMode >= 0)
+	{
+		if (!OmniShadowModeSupported(settings.omniShadowMode))
+		{
+			printf("Geometry shader omni shadows need GL 4.1, layered ones ARB_shader_viewport_layer_array as well\n");
+			return 1;
+		}
+		omniShadowMode = settings.omniShadowMode;
+	}
+
+	// glFinish() after each pass so the GPU work is attributed to the pass that issued it
+	auto EndPass = [&](double& passTotal) {
+		glFinish();
+		double now = glfwGetTime();
+		passTotal += (now - passStart) * 1000.0;
+		passStart = now;
+	};
+
+	printf("Rendering %d frames (%d warmup) at %dx%d with %zu objects, %u point and %u spot lights, %zu fixtures, %s shading\n", settings.frames, settings.warmup,
+		mainWindow.getBufferWidth(), mainWindow.getBufferHeight(), objects.size(), pointLightCount, spotLightCount, fixtureLights.size(),
+		deferredShading ? "deferred" : depthPrePass ? "forward with depth pre-pass" : "forward");
+
+	for (int frame = 0; frame < settings.warmup + settings.frames; frame++)
+	{
+		double directionalTime = 0.0, omniTime = 0.0, spotTime = 0.0, momentsTime = 0.0, renderTime = 0.0, frameTime = 0.0;
+
+		if (cameraPath.GetKeyframeCount() > 0)
+		{
+			cameraPath.ApplyToCamera(std::max(frame - settings.warmup, 0) * benchmarkTimeStep, &camera);
+		}
+
+		gpuProfiler.BeginFrame();
+		ResetRenderStats();
+
+		glFinish();
+		double frameStart = glfwGetTime();
+		passStart = frameStart;
+
+		UpdateObjectTransforms();
+		UpdateFrameUniforms(camera.calculateViewMatrix(), projection);
+
+		gpuProfiler.BeginZone("DirectionalShadowMapPass");
+		DirectionalShadowMapPass(&mainLight);
+		gpuProfiler.EndZone();
+		EndPass(directionalTime);
+
+		for (size_t i = 0; i < pointLightCount; i++)
+		{
+			gpuProfiler.BeginZone("OmniShadowMapPass point " + std::to_string(i));
+			OmniShadowMapPass(&pointLights[i], i, pointShadowCaches[i]);
+			gpuProfiler.EndZone();
+			EndPass(omniTime);
+		}
+		for (size_t i = 0; i < spotLightCount; i++)
+		{
+			gpuProfiler.BeginZone("SpotShadowMapPass " + std::to_string(i));
+			SpotShadowMapPass(&spotLights[i], i, spotShadowCaches[i]);
+			gpuProfiler.EndZone();
+			EndPass(spotTime);
+		}
+
+		ShadowMomentsPass();
+		EndPass(momentsTime);
+
+		RenderPass(camera.calculateViewMatrix(), projection);
+		EndPass(renderTime);
+
+		frameTime = (passStart - frameStart) * 1000.0;
+
+		if (frame < settings.warmup)
+		{
+			continue;
+		}
+
+		stats.AddSample("DirectionalShadowMapPass (ms)", directionalTime);
+		stats.AddSample("OmniShadowMapPass (ms)", omniTime);
+		stats.AddSample("SpotShadowMapPass (ms)", spotTime);
+		stats.AddSample("ShadowMomentsPass (ms)", momentsTime);
+		stats.AddSample("RenderPass (ms)", renderTime);
+		stats.AddSample("Frame (ms)", frameTime);
+		stats.AddSample("Draw calls", Mesh::GetDrawCallCount());
+		stats.AddSample("Triangles submitted", (double)Mesh::GetTriangleCount());
+		stats.AddSample("Objects drawn", mainCullStats.objectsDrawn);
+		stats.AddSample("Objects culled", mainCullStats.objectsCulled);
+		stats.AddSample("Shadow casters drawn", shadowCullStats.objectsDrawn);
+		stats.AddSample("Shadow casters culled", shadowCullStats.objectsCulled);
+		stats.AddSample("Meshes culled", mainCullStats.meshesCulled + shadowCullStats.meshesCulled);
+		stats.AddSample("Shadow maps redrawn", shadowCacheStats.fullUpdates);
+		stats.AddSample("Shadow maps moving only", shadowCacheStats.dynamicUpdates);
+		stats.AddSample("Shadow maps cached", shadowCacheStats.skippedUpdates);
+		stats.AddSample("Shadow atlas used (%)", shadowAtlas.GetUsage() * 100.0);
+		stats.AddSample("Light cluster references", lightClusters.GetStats().references);
+		stats.AddSample("Lights in busiest cluster", lightClusters.GetStats().maxClusterLights);
+		stats.AddSample("Program binds", renderQueue.GetStats().programBinds);
+		stats.AddSample("Texture binds", renderQueue.GetStats().textureBinds);
+		stats.AddSample("Vertex array binds", renderQueue.GetStats().vertexArrayBinds);
+		stats.AddSample("Binds skipped", renderQueue.GetStats().skippedBinds);
+
+		// GPU timings lag GPU_PROFILER_FRAMES behind, the first ones resolved are still warmup frames
+		for (size_t i = 0; i < gpuProfiler.GetZoneCount(); i++)
+		{
+			stats.AddSample("GPU " + gpuProfiler.GetZoneName(i) + " (ms)", gpuProfiler.GetLastTime(i));
+		}
+		stats.AddSample("GPU Frame (ms)", gpuProfiler.GetLastFrameTime());
+	}
+
+	stats.PrintReport();
+
+	if (settings.reportFile && !stats.WriteCSV(settings.reportFile))
+	{
+		return 1;
+	}
+
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	BenchmarkSettings benchmark = { 0, 10, nullptr, nullptr, 0, 0, -1, true, true, true, true, 0, -1, false, false, 0, false };
+	const char* sceneFile = nullptr;
+	const char* traceFile = nullptr;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+		{
+			benchmark.frames = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+		{
+			benchmark.warmup = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--path") == 0 && i + 1 < argc)
+		{
+			benchmark.cameraPathFile = argv[++i];
+		}
+		else if (strcmp(argv[i], "--objects") == 0 && i + 1 < argc)
+		{
+			benchmark.objectCount = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--fixtures") == 0 && i + 1 < argc)
+		{
+			benchmark.fixtureCount = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--lights") == 0 && i + 1 < argc)
+		{
+			benchmark.lightCount = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc)
+		{
+			benchmark.reportFile = argv[++i];
+		}
+		else if (strcmp(argv[i], "--cascades") == 0 && i + 1 < argc)
+		{
+			benchmark.cascadeCount = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--omni-shadows") == 0 && i + 1 < argc && OmniShadowModeFromName(argv[i + 1]) >= 0)
+		{
+			benchmark.omniShadowMode = OmniShadowModeFromName(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--no-culling") == 0)
+		{
+			benchmark.culling = false;
+		}
+		else if (strcmp(argv[i], "--no-instancing") == 0)
+		{
+			benchmark.instancing = false;
+		}
+		else if (strcmp(argv[i], "--no-indirect") == 0)
+		{
+			benchmark.indirect = false;
+		}
+		else if (strcmp(argv[i], "--no-shadow-cache") == 0)
+		{
+			benchmark.shadowCache = false;
+		}
+		else if (strcmp(argv[i], "--deferred") == 0)
+		{
+			benchmark.deferred = true;
+		}
+		else if (strcmp(argv[i], "--depth-prepass") == 0)
+		{
+			benchmark.depthPrePass = true;
+		}
+		else if (strcmp(argv[i], "--shadow-taps") == 0 && i + 1 < argc)
+		{
+			benchmark.shadowTaps = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--shadow-moments") == 0)
+		{
+			benchmark.shadowMoments = true;
+		}
+		else if (strcmp(argv[i], "--shadow-atlas") == 0 && i + 1 < argc)
+		{
+			shadowAtlasSize = (GLuint)atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--scene") == 0 && i + 1 < argc)
+		{
+			sceneFile = argv[++i];
+		}
+		else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+		{
+			traceFile = argv[++i];
+		}
+		else
+		{
+			printf("Usage: %s [--frames N [--warmup N] [--path <file>] [--objects N] [--lights N] [--fixtures N] [--cascades N] [--omni-shadows geometry|faces|layered] [--no-culling] [--no-instancing] [--no-indirect] [--no-shadow-cache] [--deferred] [--depth-prepass] [--shadow-taps 1|4|8|20] [--shadow-moments] [--report <file>]] [--shadow-atlas N] [--scene <file>] [--trace <file>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	bool headless = benchmark.frames > 0;
+
+	mainWindow = Window(1366, 768); // 1280, 1024 or 1024, 768
+	if (mainWindow.Initialise(!headless) != 0)
+	{
+		return 1;
+	}
+
+	if (headless)
+	{
+		glfwSwapInterval(0);
+
+		offscreenTarget = new RenderTarget();
+		if (!offscreenTarget->Init(mainWindow.getBufferWidth(), mainWindow.getBufferHeight()))
+		{
+			return 1;
+		}
+	}
+
+	CreateShaders();
+
+	// Tiles are packed on power-of-two boundaries, so the atlas is one too
+	GLint maxTextureSize = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+	GLuint atlasSize = SHADOW_ATLAS_MIN_TILE;
+	while (atlasSize * 2 <= std::min(shadowAtlasSize, (GLuint)maxTextureSize))
+	{
+		atlasSize *= 2;
+	}
+	if (!shadowAtlas.Init(atlasSize, atlasSize))
+	{
+		return 1;
+	}
+
+	lightClusters.Init();
+
+	if (!gBuffer.Init(mainWindow.getBufferWidth(), mainWindow.getBufferHeight()))
+	{
+		return 1;
+	}
+
+	camera = Camera(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), -60.0f, 0.0f, 5.0f, 0.5f);
+
+	plainTexture = Texture("Textures/plain.png");
+	plainTexture.LoadTextureA();
+
+	mainLight = DirectionalLight(2048, 2048,
+								1.0f, 0.53f, 0.3f, 
+								0.1f, 0.9f,
+								-10.0f, -12.0f, 18.5f);
+
+	pointLights[0] = PointLight(1024, 1024,
+								0.01f, 100.0f,
+								0.0f, 0.0f, 1.0f,
+								0.0f, 1.0f,
+								1.0f, 2.0f, 0.0f,
+								0.3f, 0.2f, 0.1f);
+	pointLightCount++;
+	pointLights[1] = PointLight(1024, 1024,
+								0.01f, 100.0f, 
+								0.0f, 1.0f, 0.0f,
+								0.0f, 1.0f,
+								-4.0f, 3.0f, 0.0f,
+								0.3f, 0.2f, 0.1f);
+	pointLightCount++;
+
+	
+	spotLights[0] = SpotLight(1024, 1024,
+						0.01f, 100.0f, 
+						1.0f, 1.0f, 1.0f,
+						0.0f, 2.0f,
+						0.0f, 0.0f, 0.0f,
+						0.0f, -1.0f, 0.0f,
+						1.0f, 0.0f, 0.0f,
+						20.0f);
+	spotLightCount++;
+	spotLights[1] = SpotLight(1024, 1024,
+						0.01f, 100.0f, 
+						1.0f, 1.0f, 1.0f,
+						0.0f, 1.0f,
+						0.0f, -1.5f, 0.0f,
+						-100.0f, -1.0f, 0.0f,
+						1.0f, 0.0f, 0.0f,
+						20.0f);
+	spotLightCount++;
+
+	std::vector<std::string> skyboxFaces;
+	skyboxFaces.push_back("Textures/Skybox/alpha-island/alpha-island_rt.tga");
+	skyboxFaces.push_back("Textures/Skybox/alpha-island/alpha-island_lf.tga");
+	skyboxFaces.push_back("Textures/Skybox/alpha-island/alpha-island_up.tga");
+	skyboxFaces.push_back("Textures/Skybox/alpha-island/alpha-island_dn.tga");
+	skyboxFaces.push_back("Textures/Skybox/alpha-island/alpha-island_bk.tga");
+	skyboxFaces.push_back("Textures/Skybox/alpha-island/alpha-island_ft.tga");
+
+	skybox = Skybox(skyboxFaces);
+
+	GLuint uniformProjection = 0, uniformModel = 0, uniformView = 0, uniformEyePosition = 0,
+		uniformSpecularIntensity = 0, uniformShininess = 0;
+
+	glm::mat4 projection = glm::perspective(glm::radians(60.0f), (GLfloat)mainWindow.getBufferWidth() / mainWindow.getBufferHeight(), 0.1f, 100.0f);
+
+	if (sceneFile)
+	{
+		SceneLoader sceneLoader = SceneLoader(sceneFile);
+		if (!sceneLoader.LoadScene(objects, fixtureLights, camera) && headless)
+		{
+			return 1;
+		}
+	}
+
+	for (Object* object : objects)
+	{
+		object->AddToTree(&sceneTree);
+	}
+	sceneTree.Rebuild();
+
+	if (headless)
+	{
+		int result = RunBenchmark(benchmark, projection);
+
+		if (traceFile)
+		{
+			CpuProfiler::WriteTrace(traceFile);
+		}
+
+		return result;
+	}
+
+	IMGUI_CHECKVERSION();
+	ImGui::CreateContext();
+	ImGuiIO& io = ImGui::GetIO();
+	// Setup Platform/Renderer bindings
+	ImGui_ImplGlfw_InitForOpenGL(mainWindow.getGLWFWindow(), true);
+	ImGui_ImplOpenGL3_Init("#version 330");
+	// Setup Dear ImGui style
+	ImGui::StyleColorsDark();
+
+	static bool createObject = false;
+	static bool importObject = false;
+
+	static bool createCube = false;
+	static bool createSphere = false;
+
+	static bool directionalLight = false;
+	static int spotLight = -1;
+	static bool openSpotLight = false;
+	static int pointLight = -1;
+	static bool openPointLight = false;
+
+	static float FOV = 60.0f;
+	static float near = 0.1f;
+	static float far = 100.0f;
+
+	static int currSkybox = 0;
+
+	static bool showProfiler = false;
+
+	static bool recordPath = false;
+	static GLfloat recordStart = 0.0f;
+	static GLfloat lastKeyframe = 0.0f;
+	static CameraPath recordedPath = CameraPath("camera.path");
+
+
+
+	// Loop until window closed
+	while (!mainWindow.getShouldClose())
+	{
+		PROFILE_ZONE("Frame");
+
+		GLfloat now = glfwGetTime(); // SDL_GetPerformanceCounter();
+		deltaTime = now - lastTime; // (now - lastTime)*1000/SDL_GetPerformanceFrequency();
+		lastTime = now;
+
+		// Get + Handle User Input
+		glfwPollEvents();
+
+		gpuProfiler.BeginFrame();
+		ResetRenderStats();
+
+		camera.keyControl(mainWindow.getsKeys(), deltaTime);
+		if (mainWindow.getsKeys()[GLFW_MOUSE_BUTTON_2]) {
+			camera.mouseControl(mainWindow.getXChange(), mainWindow.getYChange());
+		}
+
+		ImGui_ImplOpenGL3_NewFrame();
+		ImGui_ImplGlfw_NewFrame();
+		ImGui::NewFrame();
+
+		if (mainWindow.getsKeys()[GLFW_KEY_L])
+		{
+			spotLights[0].Toggle();
+			mainWindow.getsKeys()[GLFW_KEY_L] = false;
+		}
+
+		UpdateObjectTransforms();
+
+		// Left click in the viewport opens the clicked object's panel
+		if (mainWindow.getsKeys()[GLFW_MOUSE_BUTTON_1] && !io.WantCaptureMouse)
+		{
+			mainWindow.getsKeys()[GLFW_MOUSE_BUTTON_1] = false;
+
+			PROFILE_ZONE("PickObject");
+			Object* picked = PickObject(camera.calculateViewMatrix(), projection);
+			if (picked)
+			{
+				picked->setIsSelected(true);
+			}
+		}
+
+		UpdateFrameUniforms(camera.calculateViewMatrix(), projection);
+		ShadowPasses();
+
+		RenderPass(camera.calculateViewMatrix(), projection);
+
+		// Object hierarchy
+		ImGuiWindowFlags window_flags = 0;
+		window_flags |= ImGuiWindowFlags_MenuBar;
+
+		PROFILE_ZONE_BEGIN("Settings panel");
+		ImGui::Begin("Settings", NULL, window_flags);
+
+			float moveSpeed = camera.getMoveSpeed();
+			ImGui::DragFloat("Move speed", &moveSpeed, 0.01f, 0.0f, 10.0f);
+			camera.setMoveSpeed(moveSpeed);
+
+			float turnSpeed = camera.getTurnSpeed();
+			ImGui::DragFloat("Turn speed", &turnSpeed, 0.01f, 0.0f, 10.0f);
+			camera.setTurnSpeed(turnSpeed);
+
+			ImGui::DragFloat("Field of view", &FOV, 0.1f, 30.0f, 180.0f);
+			ImGui::DragFloat("Near plane", &near, 0.1f, 0.0f, far);
+			ImGui::DragFloat("Far plane", &far, 0.1f, near);
+			projection = glm::perspective(glm::radians(FOV), (GLfloat)mainWindow.getBufferWidth() / mainWindow.getBufferHeight(), near, far);
+
+			int prevSkybox = currSkybox;
+			const char* skyboxes[] = { "alpha-island", "alps", "arctic", "arrakisday", "ashcanyon", "badomen", "blue", "boulder-bay", 
+									   "bromene-bay", "cloudtop", "cottoncandy", "coward-cove", "craterflake", "criminal-element", 
+									   "cupertin-lake", "darkgloom", "day-at-the-beach", "desertsky", "emeraldfog", "fadeaway", 
+									   "fat-chance-in-hell", "frozen", "frozendusk", "glacier", "greenhaze", "greywash", "habitual-pain", 
+									   "hills", "hills2", "iceflats", "iceflow", "interstellar", "lagoon", "leatherduster", "lilacisles", 
+									   "limon", "lmcity", "majesty", "midnight-silence", "miramar", "mountain", "mudskipper", "nevada", 
+									   "nightsky", "oasisnight", "peaks", "plains-of-abraham", "powderpeak", "purplenebula", "redplanet", 
+									   "rockyvalley", "seeingred", "sep", "shadowpeak", "siege", "snow", "snowy", "sorbin", "ss", "starfield", 
+									   "stormydays", "stratosphere", "sunset", "violentdays" };
+			ImGui::Combo("Skybox", &currSkybox, skyboxes, IM_ARRAYSIZE(skyboxes));
+
+			ImGui::Text("Loaded assets: %zu models, %zu textures", AssetRegistry::GetModelCount(), AssetRegistry::GetTextureCount());
+
+			ImGui::Checkbox("Frustum culling", &frustumCulling);
+			ImGui::SameLine();
+			ImGui::Checkbox("Instancing", &instancedRendering);
+			if (GpuScene::IsSupported()) {
+				ImGui::SameLine();
+				ImGui::Checkbox("Multi-draw indirect", &indirectRendering);
+			}
+			if (IndirectRenderingActive()) {
+				ImGui::Text("Indirect: %zu commands in %zu texture groups, culled on the GPU", GpuScene::GetCommandCount(), GpuScene::GetGroupCount());
+			}
+			ImGui::Text("Draw calls: %u, triangles submitted: %llu", Mesh::GetDrawCallCount(), Mesh::GetTriangleCount());
+			const RenderQueueStats& queueStats = renderQueue.GetStats();
+			ImGui::Text("Binds: %u program, %u texture, %u vertex array, %u skipped", queueStats.programBinds, queueStats.textureBinds,
+				queueStats.vertexArrayBinds, queueStats.skippedBinds);
+			ImGui::Text("Objects drawn: %u, culled: %u", mainCullStats.objectsDrawn, mainCullStats.objectsCulled);
+			ImGui::Text("Shadow casters drawn: %u, culled: %u", shadowCullStats.objectsDrawn, shadowCullStats.objectsCulled);
+			ImGui::Text("Meshes culled: %u", mainCullStats.meshesCulled + shadowCullStats.meshesCulled);
+			ImGui::Checkbox("Deferred shading", &deferredShading);
+			if (!deferredShading) {
+				ImGui::SameLine();
+				ImGui::Checkbox("Depth pre-pass", &depthPrePass);
+			}
+			ImGui::Checkbox("Shadow caching", &shadowCaching);
+			ImGui::SameLine();
+			const char* omniShadowModes[] = { "Geometry shader", "Per-face passes", "Layered per-face" };
+			int omniShadowModeCount = OmniShadowModeSupported(OMNI_SHADOW_LAYERED) ? 3 : 2;
+			if (ImGui::Combo("Omni shadows", &omniShadowMode, omniShadowModes, omniShadowModeCount) && !OmniShadowModeSupported(omniShadowMode)) {
+				omniShadowMode = OMNI_SHADOW_FACES;
+			}
+			const char* shadowFilters[] = { "1 tap", "4 taps", "8 taps", "20 taps" };
+			int shadowFilter = (int)(std::find(std::begin(shadowTapTiers), std::end(shadowTapTiers), shadowTaps) - std::begin(shadowTapTiers));
+			if (ImGui::Combo("Shadow filter", &shadowFilter, shadowFilters, IM_ARRAYSIZE(shadowFilters))) {
+				shadowTaps = shadowTapTiers[shadowFilter];
+			}
+			ImGui::DragFloat("Fewer taps past", &shadowTapDistance, 0.5f, 0.0f, 1000.0f);
+			bool useMoments = shadowMoments;
+			if (ImGui::Checkbox("Moment shadow maps", &useMoments)) {
+				if (!useMoments) {
+					shadowMoments = false;
+				}
+				else if (!EnableShadowMoments()) {
+					printf("Moment shadow maps unavailable\n");
+				}
+			}
+			ImGui::Text("Main shader variant: %u, shader programs: %zu", MainShaderVariant(), Shader::GetProgramCacheSize());
+			int cascadeCount = mainLight.GetCascadeCount();
+			if (ImGui::SliderInt("Shadow cascades", &cascadeCount, 1, MAX_SHADOW_CASCADES)) {
+				mainLight.SetCascadeCount(cascadeCount);
+			}
+			ImGui::Text("Shadow maps redrawn: %u, moving only: %u, cached: %u, moving objects: %zu", shadowCacheStats.fullUpdates,
+				shadowCacheStats.dynamicUpdates, shadowCacheStats.skippedUpdates, Object::GetMovingObjects().size());
+			ImGui::Text("Shadow atlas: %ux%u, %u tiles, %.0f%% used", shadowAtlas.GetShadowWidth(), shadowAtlas.GetShadowHeight(),
+				shadowAtlas.GetTileCount(), shadowAtlas.GetUsage() * 100.0f);
+			const LightClusterStats& clusterStats = lightClusters.GetStats();
+			ImGui::Text("Light clusters: %u lights, %u references, %u in the busiest cluster", clusterStats.lights,
+				clusterStats.references, clusterStats.maxClusterLights);
+			ImGui::Text("Scene tree: %d objects, %d nodes, height %d", sceneTree.GetProxyCount(), sceneTree.GetNodeCount(), sceneTree.GetHeight());
+
+			ImGui::Checkbox("Frame profiler", &showProfiler);
+			ImGui::SameLine();
+			if (ImGui::Button("Save CPU trace")) {
+				CpuProfiler::WriteTrace("cpu_trace.json");
+			}
+
+			bool wasRecording = recordPath;
+			ImGui::Checkbox("Record camera path", &recordPath);
+			if (recordPath && !wasRecording) {
+				recordedPath.ClearPath();
+				recordStart = now;
+				lastKeyframe = -1.0f;
+			}
+			if (recordPath && now - recordStart - lastKeyframe >= 0.1f) {
+				lastKeyframe = now - recordStart;
+				recordedPath.AddKeyframe(lastKeyframe, camera.getCameraPosition(), camera.getYaw(), camera.getPitch());
+			}
+			if (!recordPath && wasRecording) {
+				recordedPath.SavePath();
+			}
+
+			if (prevSkybox != currSkybox) {
+				std::vector<std::string> skyboxFaces;
+				std::string skyboxName = skyboxes[currSkybox];
+				skyboxFaces.push_back("Textures/Skybox/" + skyboxName + "/" + skyboxName + "_rt.tga");
+				skyboxFaces.push_back("Textures/Skybox/" + skyboxName + "/" + skyboxName + "_lf.tga");
+				skyboxFaces.push_back("Textures/Skybox/" + skyboxName + "/" + skyboxName + "_up.tga");
+				skyboxFaces.push_back("Textures/Skybox/" + skyboxName + "/" + skyboxName + "_dn.tga");
+				skyboxFaces.push_back("Textures/Skybox/" + skyboxName + "/" + skyboxName + "_bk.tga");
+				skyboxFaces.push_back("Textures/Skybox/" + skyboxName + "/" + skyboxName + "_ft.tga");
+
+				skybox = Skybox(skyboxFaces);
+				prevSkybox = currSkybox;
+			}
+			
+
+		ImGui::End();
+		PROFILE_ZONE_END();
+
+		PROFILE_ZONE_BEGIN("Object hierarchy panel");
+		ImGui::Begin("Object hierarchy", NULL, window_flags);
+
+			ImGui::PushItemWidth(ImGui::GetFontSize() * -12);
+
+			if (ImGui::BeginMenuBar())
+			{
+				if (ImGui::BeginMenu("File"))
+				{
+					/*if (ImGui::BeginMenu("New")) {
+						if (ImGui::BeginMenu("Object")) {
+							ImGui::MenuItem("Cube", NULL, &createCube);
+							ImGui::MenuItem("Sphere", NULL, &createSphere);
+							ImGui::EndMenu();
+						}
+						ImGui::EndMenu();
+					}*/
+					ImGui::MenuItem("Import", NULL, &importObject);
+					ImGui::EndMenu();
+				}
+
+				ImGui::EndMenuBar();
+			}
+
+			if (ImGui::CollapsingHeader("Objects")) {
+				if (objects.size() == 0) {
+					ImGui::Text("No objects on display!");
+				}
+				else {
+					int ID = 0;
+					Object* removedObject = nullptr;
+					for (Object* object : objects) {
+						ImGui::PushID(ID);
+						if (ImGui::Button("X")) {
+							removedObject = object;
+						}
+						ImGui::PopID();
+						ImGui::SameLine();
+						if (ImGui::Selectable(object->getName(), false, ImGuiSelectableFlags_AllowDoubleClick))
+							if (ImGui::IsMouseDoubleClicked(0))
+								object->setIsSelected(true);
+						ID++;
+					}
+
+					// Erase after the loop, and delete so the model is freed once no object uses it
+					if (removedObject) {
+						objects.erase(std::find(objects.begin(), objects.end(), removedObject));
+						delete removedObject;
+					}
+				}
+			}
+
+			if (ImGui::CollapsingHeader("Lights")) {
+				if (ImGui::TreeNode("Spotlights")) {
+					int ID = 0;
+					for (SpotLight light : spotLights) {
+						ID++;
+						std::string lightNameStr = "Spotlight " + std::to_string(ID);
+						const char* lightName = lightNameStr.c_str();
+						if (ImGui::Selectable(lightName, false, ImGuiSelectableFlags_AllowDoubleClick)) {
+							if (ImGui::IsMouseDoubleClicked(0)) {
+								spotLight = ID;
+								openSpotLight = true;
+							}
+						}
+					}
+					ImGui::TreePop();
+				}
+
+				if (ImGui::TreeNode("Pointlights")) {
+					int ID = 0;
+					for (PointLight light : pointLights) {
+						ID++;
+						std::string lightNameStr = "Pointlight " + std::to_string(ID);
+						const char* lightName = lightNameStr.c_str();
+						if (ImGui::Selectable(lightName, false, ImGuiSelectableFlags_AllowDoubleClick)) {
+							if (ImGui::IsMouseDoubleClicked(0)) {
+								pointLight = ID;
+								openPointLight = true;
+							}
+						}
+					}
+					ImGui::TreePop();
+				}
+			}
+		ImGui::End();
+		PROFILE_ZONE_END();
+
+		PROFILE_ZONE_BEGIN("Light panels");
+		if (spotLight > 0) {
+			std::string lightNameStr = "Spotlight " + std::to_string(spotLight);
+			const char* lightName = lightNameStr.c_str();
+			if(ImGui::Begin(lightName, &openSpotLight)) {
+
+				if (ImGui::Button("Toggle light")) {
+					spotLights[spotLight - 1].Toggle();
+				}
+
+				float ambientIntensity = spotLights[spotLight - 1].getAmbientIntensity();
+				ImGui::DragFloat("Ambient intensity", &ambientIntensity, 0.1f, 0.0f, 300.0f);
+				spotLights[spotLight - 1].setAmbientIntensity(ambientIntensity);
+
+				float diffuseIntensity = spotLights[spotLight - 1].getDiffuseIntensity();
+				ImGui::DragFloat("Diffuse intensity", &diffuseIntensity, 0.1f, 0.0f, 300.0f);
+				spotLights[spotLight - 1].setDiffuseIntensity(diffuseIntensity);
+
+				float colours[3] = { spotLights[spotLight-1].getColour().x,
+									spotLights[spotLight-1].getColour().y,
+									spotLights[spotLight-1].getColour().z };
+				ImGui::ColorPicker3("Light colour", colours);
+				spotLights[spotLight-1].setColour(colours);
+
+				if (!openSpotLight) {
+					spotLight = -1;
+				}
+				ImGui::End();
+			}
+		}
+
+		if (pointLight > 0) {
+			std::string lightNameStr = "Pointlight " + std::to_string(pointLight);
+			const char* lightName = lightNameStr.c_str();
+			if (ImGui::Begin(lightName, &openPointLight)) {
+
+				float ambientIntensity = pointLights[pointLight - 1].getAmbientIntensity();
+				ImGui::DragFloat("Ambient intensity", &ambientIntensity, 0.1f, 0.0f, 300.0f);
+				pointLights[pointLight - 1].setAmbientIntensity(ambientIntensity);
+
+				float diffuseIntensity = pointLights[pointLight - 1].getDiffuseIntensity();
+				ImGui::DragFloat("Diffuse intensity", &diffuseIntensity, 0.1f, 0.0f, 300.0f);
+				pointLights[pointLight - 1].setDiffuseIntensity(diffuseIntensity);
+
+				float colours[3] = { pointLights[pointLight-1].getColour().x,
+					pointLights[pointLight-1].getColour().y,
+					pointLights[pointLight-1].getColour().z };
+				ImGui::ColorPicker3("Light colour", colours);
+				printf("Colour: %f\n", colours[1]);
+				pointLights[pointLight-1].setColour(colours);
+
+				if (!openPointLight) {
+					pointLight = -1;
+				}
+				ImGui::End();
+			}
+		}
+
+		PROFILE_ZONE_END();
+
+		PROFILE_ZONE_BEGIN("Import panel");
+		if (importObject) {
+			ImGui::Begin("Import object", &importObject);
+				std::string path = "Models";
+				for (const auto& entry : std::filesystem::directory_iterator(path)) {
+					std::string fileName = entry.path().string();
+					if (fileName.find(".obj") != std::string::npos) {
+						fileName = fileName.substr(7);
+						if (ImGui::Selectable(fileName.c_str(), false, ImGuiSelectableFlags_AllowDoubleClick)) {
+							if (ImGui::IsMouseDoubleClicked(0)) {
+								std::shared_ptr<Model> model = AssetRegistry::GetModel(entry.path().string());
+
+								if (model) {
+									std::string* name = new std::string(fileName.substr(0, fileName.find(".obj")));
+									Object* object = new Object(model, *name);
+									object->AddToTree(&sceneTree);
+
+									objects.push_back(object);
+								}
+
+								importObject = false;
+							}
+						}
+					}
+				}
+			ImGui::End();
+		}
+		PROFILE_ZONE_END();
+
+		PROFILE_ZONE_BEGIN("Object panels");
+		for (Object* object : objects) {
+			if (object->getIsSelected()) {
+				bool isSelected = object->getIsSelected();
+				ImGui::Begin(object->getName(), &isSelected);
+
+					
+
+					float position[4] = { object->getPos().x, object->getPos().y, object->getPos().z, 0.0f };
+					float rotation[4] = { object->getRot().x, object->getRot().y, object->getRot().z, 0.0f };
+					float scale[4] = { object->getScale().x, object->getScale().y, object->getScale().z, 0.0f };
+
+					ImGui::DragFloat3("Position", position, 0.1f);
+					ImGui::DragFloat3("Rotation", rotation, 0.1f);
+					ImGui::DragFloat3("Scale", scale, 0.1f);
+
+					object->setPos(position[0], position[1], position[2]);
+					object->setRot(rotation[0], rotation[1], rotation[2]);
+					object->setScale(scale[0], scale[1], scale[2]);
+
+				ImGui::End();
+
+				object->setIsSelected(isSelected);
+			}
+		}
+		PROFILE_ZONE_END();
+
+		ImGui::ShowDemoWindow();
+
+		if (showProfiler)
+		{
+			gpuProfiler.DrawOverlay(&showProfiler);
+		}
+
+		// Render dear imgui into screen
+		PROFILE_ZONE_BEGIN("ImGui render");
+		ImGui::Render();
+		gpuProfiler.BeginZone("ImGui");
+		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+		gpuProfiler.EndZone();
+		PROFILE_ZONE_END();
+
+		mainWindow.swapBuffers();
+	}
+
+	if (traceFile)
+	{
+		CpuProfiler::WriteTrace(traceFile);
+	}
+
+	return 0;
 }
\ No newline at end of file